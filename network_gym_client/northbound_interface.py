@@ -82,8 +82,12 @@ class NorthBoundClient():
                 raise IOError("Cannot connect to the server! Check the configure parameters in common_config.json. Make sure the server_ip and server_port is correct and you can ping server_ip.")
             else:
                 raise IOError("Cannot connect to the server! Check the configure parameters in common_config.json. Make sure the port forwarding to external server is up.")
-        reply = self.socket.recv()
+        frames = self.socket.recv_multipart()
+        reply = frames[0]
         relay_json = json.loads(reply)
+        if "encoding" in relay_json and len(frames) > 1:
+            # binary measurement report, the first frame is a json header and the second frame is the encoded report.
+            relay_json = self.decode_measurement(relay_json["encoding"], frames[1])
 
         #print(relay_json)        
 
@@ -119,6 +123,25 @@ class NorthBoundClient():
             self.context.term()
             sys.exit(self.identity +" Simulation Stopped with ***[Error]***! MSG:"+ reply.decode())
      
+    def decode_measurement (self, encoding, payload):
+        """Decode a binary measurement report.
+
+        Args:
+            encoding (str): the encoding of the report, "msgpack" or "cbor"
+            payload (bytes): the encoded measurement report
+
+        Returns:
+            json: the measurement report
+        """
+        if encoding == "msgpack":
+            import msgpack
+            return msgpack.unpackb(payload, raw=False)
+        elif encoding == "cbor":
+            import cbor2
+            return cbor2.loads(payload)
+        else:
+            raise IOError("Unknown measurement encoding: " + str(encoding))
+
     def process_measurement (self, reply_json):
         """Process the measurement.
 
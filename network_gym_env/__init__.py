@@ -3,4 +3,5 @@
 #File : __init__.py
 
 from .configure import Configure
-from .dummy_sim import DummySim
\ No newline at end of file
+from .dummy_sim import DummySim
+from .multiplexer import Multiplexer
\ No newline at end of file
@@ -46,19 +46,23 @@ class Configure(threading.Thread):
     From the server's point, the "env_config" and "env_sim" are perceived as identical entities.
     The division between the "env_config" and "env_sim" components provides the advantage of facilitating straightforward expansion of the "env_sim" to other simulators (e.g., ns-3) or test environments, all the while utilizing the same underlying "env_config" code.
     """
-    def __init__(self, id, NetworkGymSim, env_list=['custom']):
+    def __init__(self, id, NetworkGymSim, env_list=['custom'], env_endpoint=None):
         """Initialize custom environment.
 
         Args:
             id (int): environment identity
             NetworkGymSim (simulator): network simulator
             env_list (list[str]): a list of supported environments, non-offical account can only use 'custom' as env name
+            env_endpoint (str): endpoint of a southbound Multiplexer, None connects to the server directly
         """
         threading.Thread.__init__ (self)
 
         #common_config.json is shared by all environments
         f = open(FILE_PATH / 'common_config.json')
         self.config_json = json.load(f)
+        if env_endpoint:
+            # the env_config and the simulator connect via the multiplexer
+            self.config_json["env_endpoint"] = env_endpoint
         self.identity = u'%s-%d-%s' % (self.config_json["session_name"], id, socket.gethostname())
         self.env_list = env_list
         self.NetworkGymSim = NetworkGymSim
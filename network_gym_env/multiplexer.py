@@ -0,0 +1,89 @@
+#Copyright(C) 2024 Intel Corporation
+#SPDX-License-Identifier: Apache-2.0
+#File : multiplexer.py
+
+import zmq
+import threading
+import socket
+import json
+import pathlib
+import traceback
+FILE_PATH = pathlib.Path(__file__).parent
+
+# must match the MUX_FRAME in network_gym_server.py
+MUX_FRAME = b'env-mux'
+
+class Multiplexer(threading.Thread):
+    """Southbound Multiplexer Component.
+
+    The multiplexer shares one server connection among many envs running on the same host.
+    Each env connects to the multiplexer (env_endpoint) with its own env identity, and the multiplexer relays:
+    env -> server: [env identity, client identity, msg...] is sent as [MUX_FRAME, env identity, client identity, msg...]
+    server -> env: [MUX_FRAME, env identity, client identity, msg...] is sent as [env identity, client identity, msg...]
+    The server routes the msgs by the env identity, the same as envs connected directly.
+    """
+    def __init__(self, env_endpoint):
+        """Initialize the multiplexer.
+
+        Args:
+            env_endpoint (str): local endpoint for the envs, e.g., "ipc:///tmp/networkgym-mux"
+        """
+        threading.Thread.__init__ (self)
+        self.daemon = True
+
+        #common_config.json is shared by all environments
+        f = open(FILE_PATH / 'common_config.json')
+        config_json = json.load(f)
+        self.env_endpoint = env_endpoint
+        self.identity = u'%s-mux-%s' % (config_json["session_name"], socket.gethostname())
+        self.context = zmq.Context()
+        self.context.setsockopt(zmq.LINGER, 10000)
+
+        # bind before the thread starts, such that envs can connect right away.
+        self.env_socket = self.context.socket(zmq.ROUTER)
+        self.env_socket.setsockopt(zmq.ROUTER_HANDOVER, 1) # the env_config and env_sim of the same env reuse the env identity.
+        self.env_socket.bind(self.env_endpoint)
+
+        self.server_socket = self.context.socket(zmq.DEALER)
+        self.server_socket.plain_username = bytes(config_json["session_name"], 'utf-8')
+        self.server_socket.plain_password = bytes(config_json["session_key"], 'utf-8')
+        self.server_socket.identity = self.identity.encode('utf-8')
+        self.server_socket.connect('tcp://localhost:'+str(config_json["env_port"]))
+
+    def run(self):
+        """Run the multiplexer.
+        """
+        poller = zmq.Poller()
+        poller.register(self.env_socket, flags=zmq.POLLIN)
+        poller.register(self.server_socket, flags=zmq.POLLIN)
+        print(self.identity + ': multiplexer connected, env_endpoint = ' + self.env_endpoint)
+
+        try:
+            while True:
+                socks = dict(poller.poll())
+
+                if socks.get(self.env_socket) == zmq.POLLIN:
+                    # [env identity, client identity, msg...]
+                    msg = self.env_socket.recv_multipart()
+                    self.server_socket.send_multipart([MUX_FRAME] + msg)
+
+                if socks.get(self.server_socket) == zmq.POLLIN:
+                    # [MUX_FRAME, env identity, client identity, msg...]
+                    msg = self.server_socket.recv_multipart()
+                    if len(msg) < 3 or msg[0] != MUX_FRAME:
+                        print ("[Error] Ignore msg without multiplexer frame:" + str(msg))
+                        continue
+                    self.env_socket.send_multipart(msg[1:])
+        except (zmq.ContextTerminated, KeyboardInterrupt):
+            print(self.identity + ': multiplexer stopped.')
+        except Exception:
+            print(self.identity + ': [Error] multiplexer stopped by an unexpected error:')
+            traceback.print_exc()
+            raise
+        finally:
+            poller.unregister(self.env_socket)
+            poller.unregister(self.server_socket)
+            self.env_socket.close()
+            self.server_socket.close()
+            if not self.context.closed:
+                self.context.term()
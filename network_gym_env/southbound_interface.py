@@ -16,9 +16,13 @@ def southbound_connect(identity, config_json, context):
         socket: zmq socket for southbound
     """
     sb_socket = context.socket(zmq.DEALER)
+    sb_socket.identity = identity.encode('utf-8')
+    if "env_endpoint" in config_json:
+        # connect to a local southbound multiplexer, it shares one server connection for many envs.
+        sb_socket.connect(config_json["env_endpoint"])
+        return sb_socket
+
     sb_socket.plain_username = bytes(config_json["session_name"], 'utf-8')
     sb_socket.plain_password = bytes(config_json["session_key"], 'utf-8')
-    
-    sb_socket.identity = identity.encode('utf-8')
     sb_socket.connect('tcp://localhost:'+str(config_json["env_port"]))
     return sb_socket
\ No newline at end of file
@@ -65,4 +65,23 @@ PoissonUdpClientHelper::Install (NodeContainer c)
   return apps;
 }
 
+int64_t
+PoissonUdpClientHelper::AssignStreams (NodeContainer c, int64_t stream)
+{
+  int64_t currentStream = stream;
+  for (NodeContainer::Iterator i = c.Begin (); i != c.End (); ++i)
+    {
+      Ptr<Node> node = *i;
+      for (uint32_t j = 0; j < node->GetNApplications (); j++)
+        {
+          Ptr<PoissonUdpClient> client = DynamicCast<PoissonUdpClient> (node->GetApplication (j));
+          if (client)
+            {
+              currentStream += client->AssignStreams (currentStream);
+            }
+        }
+    }
+  return currentStream - stream;
+}
+
 } // namespace ns3
\ No newline at end of file
@@ -87,6 +87,16 @@ public:
      */
   ApplicationContainer Install (NodeContainer c);
 
+  /**
+   * Assign a fixed random variable stream number to the random variables
+   * used by the PoissonUdpClient applications installed on the input nodes.
+   *
+   * \param c the nodes
+   * \param stream first stream index to use
+   * \return the number of stream indices assigned by this helper
+   */
+  int64_t AssignStreams (NodeContainer c, int64_t stream);
+
 private:
   ObjectFactory m_factory; //!< Object factory.
 };
@@ -0,0 +1,129 @@
+/* Copyright(C) 2024 Intel Corporation
+*  SPDX-License-Identifier: GPL-2.0
+*  https://spdx.org/licenses/GPL-2.0.html
+*/
+
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+
+#include "gma-bw-estimator.h"
+#include "ns3/assert.h"
+
+namespace ns3 {
+
+GmaBwEstimator::GmaBwEstimator ()
+{
+}
+
+void
+GmaBwEstimator::SetMode (Mode mode)
+{
+  m_mode = mode;
+  Clear ();
+}
+
+GmaBwEstimator::Mode
+GmaBwEstimator::GetMode () const
+{
+  return m_mode;
+}
+
+void
+GmaBwEstimator::SetHistSize (uint32_t histSize)
+{
+  NS_ASSERT_MSG (histSize > 0 && histSize <= MAX_HIST_SIZE, "the history size must be within [1, " << MAX_HIST_SIZE << "]");
+  m_histSize = histSize;
+  Clear ();
+}
+
+void
+GmaBwEstimator::SetEwmaAlpha (double alpha)
+{
+  NS_ASSERT_MSG (alpha > 0 && alpha <= 1, "the ewma alpha must be within (0, 1]");
+  m_ewmaAlpha = alpha;
+}
+
+void
+GmaBwEstimator::Update (double bw, uint32_t splitIndex)
+{
+  if (m_size == m_histSize)
+  {
+    m_bwSum -= m_bwHist[m_head];
+    m_splitIndexSum -= m_splitIndexHist[m_head];
+    m_head = (m_head + 1) % m_histSize;
+    m_size--;
+  }
+  uint32_t tail = (m_head + m_size) % m_histSize;
+  m_bwHist[tail] = bw;
+  m_splitIndexHist[tail] = splitIndex;
+  m_bwSum += bw;
+  m_splitIndexSum += splitIndex;
+  m_size++;
+  if (tail == m_histSize - 1)
+  {
+    //sum the window again once per round, so the rounding errors of the running sum do not accumulate.
+    m_bwSum = 0;
+    for (uint32_t i = 0; i < m_size; i++)
+    {
+      m_bwSum += m_bwHist[i];
+    }
+  }
+
+  if (m_estimate < 0)
+  {
+    //the first sample initializes the estimate.
+    m_estimate = bw;
+    m_variance = (KALMAN_MEASUREMENT_NOISE * bw) * (KALMAN_MEASUREMENT_NOISE * bw);
+  }
+  else if (m_mode == EWMA)
+  {
+    m_estimate += m_ewmaAlpha * (bw - m_estimate);
+  }
+  else if (m_mode == KALMAN)
+  {
+    double processNoise = KALMAN_PROCESS_NOISE * m_estimate;
+    double measurementNoise = KALMAN_MEASUREMENT_NOISE * m_estimate;
+    double variance = m_variance + processNoise * processNoise;
+    double gain = variance > 0 ? variance / (variance + measurementNoise * measurementNoise) : 1;
+    m_estimate += gain * (bw - m_estimate);
+    m_variance = (1 - gain) * variance;
+  }
+}
+
+double
+GmaBwEstimator::GetBw () const
+{
+  if (m_size == 0)
+  {
+    return -1;
+  }
+  return m_mode == WINDOW ? m_bwSum / m_size : m_estimate;
+}
+
+double
+GmaBwEstimator::GetSplitIndexMean () const
+{
+  if (m_size == 0)
+  {
+    return -1;
+  }
+  return (double) m_splitIndexSum / m_size;
+}
+
+uint32_t
+GmaBwEstimator::GetSize () const
+{
+  return m_size;
+}
+
+void
+GmaBwEstimator::Clear ()
+{
+  m_head = 0;
+  m_size = 0;
+  m_bwSum = 0;
+  m_splitIndexSum = 0;
+  m_estimate = -1;
+  m_variance = 0;
+}
+
+}
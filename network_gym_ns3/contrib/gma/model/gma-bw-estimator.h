@@ -0,0 +1,63 @@
+/* Copyright(C) 2024 Intel Corporation
+*  SPDX-License-Identifier: GPL-2.0
+*  https://spdx.org/licenses/GPL-2.0.html
+*/
+
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+#ifndef GMA_BW_ESTIMATOR_H
+#define GMA_BW_ESTIMATOR_H
+
+#include <stdint.h>
+#include <array>
+
+namespace ns3 {
+
+//per link bandwidth estimation of the rx control. Each measurement interval adds the bandwidth n(i)/interval_duration
+//(packets/s) and the split index k(i) of the interval. The history of the last histSize intervals is kept in a ring
+//buffer with running sums, so the window mean costs O(1) per interval. The estimate is the window mean (WINDOW), an
+//exponentially weighted moving average (EWMA) or a scalar kalman filter with a random walk model (KALMAN).
+class GmaBwEstimator
+{
+public:
+  enum Mode
+  {
+    WINDOW = 0,
+    EWMA = 1,
+    KALMAN = 2
+  };
+
+  GmaBwEstimator ();
+  void SetMode (Mode mode);
+  Mode GetMode () const;
+  void SetHistSize (uint32_t histSize); //also clears the history, at most MAX_HIST_SIZE.
+  void SetEwmaAlpha (double alpha); //weight of the new sample.
+  void Update (double bw, uint32_t splitIndex);
+  double GetBw () const; //return -1 if no sample is added.
+  double GetSplitIndexMean () const; //mean k(i) of the history, return -1 if no sample is added.
+  uint32_t GetSize () const; //number of samples in the history.
+  void Clear ();
+
+  static const uint32_t MAX_HIST_SIZE = 64;
+private:
+  Mode m_mode = WINDOW;
+  uint32_t m_histSize = 10;
+  double m_ewmaAlpha = 0.25;
+
+  std::array<double, MAX_HIST_SIZE> m_bwHist;
+  std::array<uint32_t, MAX_HIST_SIZE> m_splitIndexHist;
+  uint32_t m_head = 0; //oldest sample.
+  uint32_t m_size = 0;
+  double m_bwSum = 0;
+  uint64_t m_splitIndexSum = 0;
+
+  double m_estimate = -1; //EWMA and KALMAN state.
+  double m_variance = 0; //KALMAN error variance of the estimate.
+  //the noise of the random walk model, relative to the estimate. A sample may be far from the bandwidth if the link is
+  //not saturated, so the measurement noise is larger than the process noise.
+  const double KALMAN_PROCESS_NOISE = 0.1;
+  const double KALMAN_MEASUREMENT_NOISE = 0.3;
+};
+
+}
+
+#endif /* GMA_BW_ESTIMATOR_H */
@@ -440,8 +440,7 @@ GmaDataProcessor::AppendSliceMeasurement(Ptr<NetworkStats> measurement, int cid,
   json measurementJson = measurement->GetJson();
   for(auto it = measurementJson.begin(); it != measurementJson.end(); ++it)
   {
-    auto sourceAndName = (*it)["source"].get<std::string>() + "::"+ (*it)["name"].get<std::string>();
-    if (std::find(m_subscribedMeasurement.begin(), m_subscribedMeasurement.end(),sourceAndName)==m_subscribedMeasurement.end())
+    if (!m_subscription->IsSubscribed((*it)["source"].get_ref<const std::string&>(), (*it)["name"].get_ref<const std::string&>()))
     {
       //not in suscribe list; continue to the next measurement
       continue;
@@ -0,0 +1,279 @@
+/* Copyright(C) 2024 Intel Corporation
+*  SPDX-License-Identifier: GPL-2.0
+*  https://spdx.org/licenses/GPL-2.0.html
+*/
+
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+
+#include "gma-decision-trace.h"
+#include "ns3/simulator.h"
+#include "ns3/log.h"
+#include <chrono>
+#include <cstring>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("GmaDecisionTrace");
+
+static const char TRACE_MAGIC[8] = {'G', 'M', 'A', 'D', 'E', 'C', 'S', 'N'};
+
+static_assert (sizeof (GmaDecisionTrace::RecordHeader) == 32, "the record header must be 32 bytes");
+static_assert (sizeof (GmaDecisionTrace::LinkRecord) == 48, "the link record must be 48 bytes");
+
+GmaDecisionTrace::GmaDecisionTrace ()
+{
+  GetTraceList ().insert (this);
+}
+
+GmaDecisionTrace::~GmaDecisionTrace ()
+{
+  Close ();
+  GetTraceList ().erase (this);
+}
+
+std::set<GmaDecisionTrace*>&
+GmaDecisionTrace::GetTraceList ()
+{
+  static std::set<GmaDecisionTrace*> traceList;
+  return traceList;
+}
+
+void
+GmaDecisionTrace::CloseAll ()
+{
+  for (GmaDecisionTrace* trace : GetTraceList ())
+  {
+    if (trace->m_file.is_open ())
+    {
+      trace->Close ();
+      trace->m_reopen = true;
+    }
+  }
+}
+
+void
+GmaDecisionTrace::Open (const std::string& fileName)
+{
+  Close ();
+  m_fileName = fileName;
+  m_file.open (fileName, std::ios::out | std::ios::binary | std::ios::trunc);
+  if (!m_file.is_open ())
+  {
+    NS_FATAL_ERROR ("cannot open the decision trace file " << fileName);
+  }
+  uint32_t header[2] = {VERSION, sizeof (RecordHeader)};
+  m_file.write (TRACE_MAGIC, sizeof (TRACE_MAGIC));
+  m_file.write (reinterpret_cast<const char*> (header), sizeof (header));
+}
+
+void
+GmaDecisionTrace::Close ()
+{
+  m_reopen = false;
+  if (m_file.is_open ())
+  {
+    m_file.close ();
+  }
+}
+
+void
+GmaDecisionTrace::Prepare (Ptr<GmaRxControl> rxControl)
+{
+  if (m_reopen)
+  {
+    //closed by CloseAll, e.g., before a fork.
+    Open (m_fileName);
+  }
+  if (!m_file.is_open ())
+  {
+    return;
+  }
+  m_linkState = rxControl->GetLinkState ();
+  m_splittingBurst = rxControl->GetSplittingBurst ();
+  m_lastSplitIndexList = rxControl->GetLastSplittingIndexList ();
+}
+
+void
+GmaDecisionTrace::Add (Ptr<RxMeasurement> measurement, Ptr<SplittingDecision> decision)
+{
+  if (!m_file.is_open ())
+  {
+    return;
+  }
+  NS_ASSERT_MSG (m_linkState, "call Prepare before the decision");
+  uint8_t links = measurement->m_links;
+  bool split = decision->m_splitIndexList.size () == links;
+  bool highDelayRatio = measurement->m_highDelayRatioList.size () == links;
+  //the split of the rx control is indexed by link index (LinkState::GetLinkIndex).
+  bool lastSplit = !m_lastSplitIndexList.empty ();
+
+  RecordHeader header;
+  header.m_timeNs = Simulator::Now ().GetNanoSeconds ();
+  header.m_measureIntervalThreshS = measurement->m_measureIntervalThreshS;
+  header.m_measureIntervalDurationS = measurement->m_measureIntervalDurationS;
+  header.m_splittingBurstRequirementEst = measurement->m_splittingBurstRequirementEst;
+  header.m_links = links;
+  header.m_flags = (decision->m_update ? UPDATE : 0) | (split ? SPLIT : 0) | (highDelayRatio ? HIGH_DELAY_RATIO : 0)
+                   | (lastSplit ? LAST_SPLIT : 0);
+  header.m_splittingBurst = m_splittingBurst;
+  header.m_reserved = 0;
+
+  m_linkRecordList.resize (links);
+  for (uint8_t ind = 0; ind < links; ind++)
+  {
+    LinkRecord& record = m_linkRecordList[ind];
+    record.m_delay = measurement->m_delayList[ind];
+    record.m_minOwdLongTerm = measurement->m_minOwdLongTerm[ind];
+    record.m_lossRate = measurement->m_lossRateList[ind];
+    record.m_highDelayRatio = highDelayRatio ? measurement->m_highDelayRatioList[ind] : 0;
+    record.m_delayViolationPktNum = measurement->m_delayViolationPktNumList[ind];
+    record.m_totalPktNum = measurement->m_totalPktNumList[ind];
+    record.m_cid = measurement->m_cidList[ind];
+    record.m_delayThisInterval = measurement->m_delayThisInterval[ind];
+    record.m_linkUp = m_linkState->IsLinkUp (record.m_cid);
+    record.m_splitIndex = split ? decision->m_splitIndexList[ind] : 0;
+    record.m_lastSplitIndex = lastSplit ? m_lastSplitIndexList.at (m_linkState->GetLinkIndex (record.m_cid)) : 0;
+    std::memset (record.m_reserved, 0, sizeof (record.m_reserved));
+  }
+  m_linkState = nullptr;
+  m_file.write (reinterpret_cast<const char*> (&header), sizeof (header));
+  m_file.write (reinterpret_cast<const char*> (m_linkRecordList.data ()), links * sizeof (LinkRecord));
+}
+
+std::vector<GmaDecisionTrace::Entry>
+GmaDecisionTrace::Read (const std::string& fileName)
+{
+  std::ifstream file (fileName, std::ios::in | std::ios::binary);
+  char magic[sizeof (TRACE_MAGIC)];
+  uint32_t header[2];
+  if (!file.read (magic, sizeof (magic)) || !file.read (reinterpret_cast<char*> (header), sizeof (header))
+      || std::memcmp (magic, TRACE_MAGIC, sizeof (magic)) != 0)
+  {
+    NS_FATAL_ERROR ("not a gma decision trace file " << fileName);
+  }
+  if (header[0] != VERSION || header[1] != sizeof (RecordHeader))
+  {
+    NS_FATAL_ERROR ("unsupported gma decision trace version " << header[0]);
+  }
+
+  std::vector<Entry> entryList;
+  RecordHeader recordHeader;
+  std::vector<LinkRecord> linkRecordList;
+  while (file.read (reinterpret_cast<char*> (&recordHeader), sizeof (RecordHeader)))
+  {
+    linkRecordList.resize (recordHeader.m_links);
+    if (!file.read (reinterpret_cast<char*> (linkRecordList.data ()), recordHeader.m_links * sizeof (LinkRecord)))
+    {
+      NS_LOG_WARN ("the last record of " << fileName << " is truncated");
+      break;
+    }
+    Entry entry;
+    entry.m_time = NanoSeconds (recordHeader.m_timeNs);
+    entry.m_splittingBurst = recordHeader.m_splittingBurst;
+    entry.m_measurement = Create<RxMeasurement> ();
+    entry.m_decision = Create<SplittingDecision> ();
+    Ptr<RxMeasurement> measurement = entry.m_measurement;
+    measurement->m_links = recordHeader.m_links;
+    measurement->m_measureIntervalThreshS = recordHeader.m_measureIntervalThreshS;
+    measurement->m_measureIntervalDurationS = recordHeader.m_measureIntervalDurationS;
+    measurement->m_splittingBurstRequirementEst = recordHeader.m_splittingBurstRequirementEst;
+    entry.m_decision->m_update = recordHeader.m_flags & UPDATE;
+    for (uint8_t ind = 0; ind < recordHeader.m_links; ind++)
+    {
+      const LinkRecord& record = linkRecordList[ind];
+      measurement->m_cidList.push_back (record.m_cid);
+      measurement->m_delayThisInterval.push_back (record.m_delayThisInterval);
+      measurement->m_delayList.push_back (record.m_delay);
+      measurement->m_minOwdLongTerm.push_back (record.m_minOwdLongTerm);
+      measurement->m_lossRateList.push_back (record.m_lossRate);
+      if (recordHeader.m_flags & HIGH_DELAY_RATIO)
+      {
+        measurement->m_highDelayRatioList.push_back (record.m_highDelayRatio);
+      }
+      measurement->m_delayViolationPktNumList.push_back (record.m_delayViolationPktNum);
+      measurement->m_totalPktNumList.push_back (record.m_totalPktNum);
+      entry.m_linkUpList.push_back (record.m_linkUp);
+      if (recordHeader.m_flags & LAST_SPLIT)
+      {
+        entry.m_lastSplitIndexList.push_back (record.m_lastSplitIndex);
+      }
+      if (recordHeader.m_flags & SPLIT)
+      {
+        entry.m_decision->m_splitIndexList.push_back (record.m_splitIndex);
+      }
+    }
+    entryList.push_back (entry);
+  }
+  return entryList;
+}
+
+Ptr<LinkState>
+GmaDecisionTrace::CreateLinkState (const std::vector<Entry>& entryList)
+{
+  Ptr<LinkState> linkState = CreateObject<LinkState> ();
+  if (!entryList.empty ())
+  {
+    const std::vector<uint8_t>& cidList = entryList.front ().m_measurement->m_cidList;
+    for (uint32_t ind = 0; ind < cidList.size (); ind++)
+    {
+      linkState->AddLinkCid (cidList[ind]);
+    }
+  }
+  return linkState;
+}
+
+GmaDecisionTrace::ReplayResult
+GmaDecisionTrace::Replay (const std::vector<Entry>& entryList, Ptr<GmaRxControl> rxControl, bool restoreSplit)
+{
+  ReplayResult result;
+  Ptr<LinkState> linkState = rxControl->GetLinkState ();
+  NS_ASSERT_MSG (linkState, "the rx control has no link state");
+  std::vector<uint8_t> splitIndexList;
+  auto start = std::chrono::steady_clock::now ();
+  for (uint32_t i = 0; i < entryList.size (); i++)
+  {
+    const Entry& entry = entryList[i];
+    const std::vector<uint8_t>& cidList = entry.m_measurement->m_cidList;
+    for (uint32_t ind = 0; ind < cidList.size (); ind++)
+    {
+      if (linkState->IsLinkUp (cidList[ind]) != entry.m_linkUpList[ind])
+      {
+        if (entry.m_linkUpList[ind])
+        {
+          linkState->CtrlMsgUp (cidList[ind]);
+        }
+        else
+        {
+          linkState->CtrlMsgDown (cidList[ind]);
+        }
+      }
+    }
+    if (restoreSplit)
+    {
+      //the split may have been changed between the decisions, e.g., by a link down tsu.
+      splitIndexList.assign (entry.m_lastSplitIndexList.empty () ? 0 : linkState->GetCidList ().size (), 0);
+      for (uint32_t ind = 0; ind < entry.m_lastSplitIndexList.size (); ind++)
+      {
+        splitIndexList.at (linkState->GetLinkIndex (cidList[ind])) = entry.m_lastSplitIndexList[ind];
+      }
+      rxControl->RestoreSplit (splitIndexList, entry.m_splittingBurst);
+    }
+
+    Ptr<SplittingDecision> decision = rxControl->GetTrafficSplittingDecision (entry.m_measurement);
+    result.m_decisions++;
+    if (decision->m_update)
+    {
+      result.m_updates++;
+    }
+    //the split index list is only compared if the decision updates the split.
+    if (decision->m_update != entry.m_decision->m_update
+        || (decision->m_update && decision->m_splitIndexList != entry.m_decision->m_splitIndexList))
+    {
+      result.m_mismatches++;
+    }
+  }
+  result.m_seconds = std::chrono::duration<double> (std::chrono::steady_clock::now () - start).count ();
+  return result;
+}
+
+}
@@ -0,0 +1,122 @@
+/* Copyright(C) 2024 Intel Corporation
+*  SPDX-License-Identifier: GPL-2.0
+*  https://spdx.org/licenses/GPL-2.0.html
+*/
+
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+#ifndef GMA_DECISION_TRACE_H
+#define GMA_DECISION_TRACE_H
+
+#include "ns3/simple-ref-count.h"
+#include "ns3/nstime.h"
+#include "gma-rx-control.h"
+#include <stdint.h>
+#include <fstream>
+#include <set>
+#include <string>
+#include <vector>
+
+namespace ns3 {
+
+//binary trace of the rx measurements of a gma interface and the splitting decisions made for them, recorded at the end of
+//each measurement interval (MeasurementManager::MeasureIntervalEnd). The trace is replayed against any GmaRxControl
+//configuration without running the simulation, e.g., to tune or benchmark the splitting policies.
+//The file starts with a 16 bytes header ("GMADECSN", version, record header size), each record is a RecordHeader
+//followed by one LinkRecord per link. The split of the rx control before each decision is recorded too, since it is also
+//changed outside of the measurement intervals (link down tsu, rl actions).
+//Call CloseAll before fork(), the closed traces are opened again at their next record, see GmaPacketTrace::CloseAll.
+class GmaDecisionTrace : public SimpleRefCount<GmaDecisionTrace>
+{
+public:
+  enum Flag
+  {
+    UPDATE = 1, //the decision updates the split.
+    SPLIT = 2, //the decision has a split index list.
+    HIGH_DELAY_RATIO = 4, //the measurement has a high delay ratio list.
+    LAST_SPLIT = 8, //the rx control had a split before the decision.
+  };
+
+  struct RecordHeader
+  {
+    int64_t m_timeNs; //simulation time.
+    double m_measureIntervalThreshS;
+    double m_measureIntervalDurationS;
+    uint32_t m_splittingBurstRequirementEst;
+    uint8_t m_links;
+    uint8_t m_flags;
+    uint8_t m_splittingBurst; //splitting burst of the rx control before the decision.
+    uint8_t m_reserved;
+  };
+
+  struct LinkRecord
+  {
+    double m_delay;
+    double m_minOwdLongTerm;
+    double m_lossRate;
+    double m_highDelayRatio;
+    uint32_t m_delayViolationPktNum;
+    uint32_t m_totalPktNum;
+    uint8_t m_cid;
+    uint8_t m_delayThisInterval;
+    uint8_t m_linkUp; //link state of the rx control before the decision.
+    uint8_t m_splitIndex; //0 if the decision has no split index list.
+    uint8_t m_lastSplitIndex; //split index of the rx control before the decision, 0 if it had no split.
+    uint8_t m_reserved[3];
+  };
+
+  //a record read from the trace.
+  struct Entry
+  {
+    Time m_time;
+    uint8_t m_splittingBurst;
+    std::vector<bool> m_linkUpList;
+    std::vector<uint8_t> m_lastSplitIndexList; //split before the decision in the order of the cid list, empty if none.
+    Ptr<RxMeasurement> m_measurement;
+    Ptr<SplittingDecision> m_decision; //only m_update and m_splitIndexList are recorded.
+  };
+
+  struct ReplayResult
+  {
+    uint32_t m_decisions = 0;
+    uint32_t m_updates = 0;
+    uint32_t m_mismatches = 0; //decisions that differ from the recorded ones.
+    double m_seconds = 0; //wall clock time spent in the replay.
+  };
+
+  GmaDecisionTrace ();
+  ~GmaDecisionTrace ();
+
+  void Open (const std::string& fileName);
+  void Close ();
+  static void CloseAll (); //close the open traces, they are opened again (truncated) at their next record.
+  //save the split, splitting burst and link state of the rx control, call it right before the decision.
+  void Prepare (Ptr<GmaRxControl> rxControl);
+  //add the decision for the measurement with the state saved by Prepare, call it before the decision is changed by the caller.
+  void Add (Ptr<RxMeasurement> measurement, Ptr<SplittingDecision> decision);
+
+  static std::vector<Entry> Read (const std::string& fileName); //read all records of a trace file.
+  //link state with the cids of the first record, in the order of its cid list.
+  static Ptr<LinkState> CreateLinkState (const std::vector<Entry>& entryList);
+  //run the rx control against the recorded measurements. Before each decision, the links of the rx control are set up or
+  //down (ctrl msg) as recorded, and if restoreSplit is true, its split and splitting burst are restored as recorded. Set
+  //restoreSplit to false to replay with another splitting burst. The rx control must have a link state with the recorded
+  //cids, see CreateLinkState.
+  static ReplayResult Replay (const std::vector<Entry>& entryList, Ptr<GmaRxControl> rxControl, bool restoreSplit = true);
+
+  static const uint32_t VERSION = 2;
+private:
+  static std::set<GmaDecisionTrace*>& GetTraceList (); //all traces of the process.
+
+  std::string m_fileName;
+  bool m_reopen = false; //closed by CloseAll, open the file again at the next record.
+  std::ofstream m_file;
+  std::vector<LinkRecord> m_linkRecordList;
+  //state of the rx control saved by Prepare.
+  Ptr<LinkState> m_linkState;
+  uint8_t m_splittingBurst = 0;
+  std::vector<uint8_t> m_lastSplitIndexList;
+};
+
+}
+
+#endif /* GMA_DECISION_TRACE_H */
@@ -14,6 +14,8 @@ NS_LOG_COMPONENT_DEFINE ("GmaHeader");
 
 NS_OBJECT_ENSURE_REGISTERED (GmaHeader);
 
+const uint8_t GmaHeader::OPTION_SIZE_LIST [16] = {1, 0, 1, 1, 1, 1, 3, 4, 2, 0, 0, 0, 0, 0, 0, 0};
+
 GmaHeader::GmaHeader ()
 {
   m_timeStamp = 0;
@@ -49,10 +51,12 @@ GmaHeader::GetInstanceTypeId (void) const
 void
 GmaHeader::Print (std::ostream &os) const
 {
-  os<<"flags=["<<m_flagsBits[0]<<m_flagsBits[1]<<m_flagsBits[2]<<m_flagsBits[3]
-  <<m_flagsBits[4]<<m_flagsBits[5]<<m_flagsBits[6]<<m_flagsBits[7]
-  <<m_flagsBits[8]<<m_flagsBits[9]<<m_flagsBits[10]<<m_flagsBits[11]
-  <<m_flagsBits[12]<<m_flagsBits[13]<<m_flagsBits[14]<<m_flagsBits[15]<< "]";
+  os<<"flags=[";
+  for (uint8_t ind = 0; ind < 16; ind++)
+  {
+    os<<HasFlag (ind);
+  }
+  os<< "]";
 }
 
 uint32_t
@@ -64,57 +68,45 @@ GmaHeader::GetSerializedSize (void) const
 void
 GmaHeader::Serialize (Buffer::Iterator start) const
 {
-  // convert the flags from bits to integer.
-  uint16_t flags = 0;
-  for (uint8_t ind = 0; ind < 16; ind++)
+  if(m_flags & ~IMPLEMENTED_FLAGS)
   {
-    flags += (m_flagsBits[ind] << (ind));
+    NS_FATAL_ERROR("this feild in GMA header is not implemented yet!!!!!!");
   }
 
-  start.WriteU16 (flags);
+  start.WriteU16 (m_flags);
 
-  if(m_flagsBits[8] == 1)
+  if(HasFlag (8))
   {
     start.WriteU16(m_clientId);
   }
 
-  if(m_flagsBits[7] == 1)
+  if(HasFlag (7))
   {
     start.WriteU32(m_timeStamp);
   }
 
-  if(m_flagsBits[6] == 1)
+  if(HasFlag (6))
   {
     start.WriteU8 ((m_sequenceNumber & 0x00ff0000) >> 16);
     start.WriteU8 ((m_sequenceNumber & 0x0000ff00) >> 8);
     start.WriteU8 (m_sequenceNumber & 0x000000ff);
   }
 
-  if(m_flagsBits[5] == 1)
+  if(HasFlag (5))
   {
     start.WriteU8(m_localSequenceNumber);
   }
 
-  if(m_flagsBits[3] == 1)
+  if(HasFlag (3))
   {
     start.WriteU8(m_flowId);
   }
 
-  if(m_flagsBits[2] == 1)
+  if(HasFlag (2))
   {
     start.WriteU8(m_connectionId);
   }
 
-  if(m_flagsBits[0] == 1 || m_flagsBits[1] == 1 || m_flagsBits[4] == 1 || 
-     m_flagsBits[9] == 1 || m_flagsBits[10] == 1||
-     m_flagsBits[11] == 1 || m_flagsBits[12] == 1 || m_flagsBits[13] == 1||
-     m_flagsBits[14] == 1 || m_flagsBits[15] == 1)
-  {
-    NS_FATAL_ERROR("this feild in GMA header is not implemented yet!!!!!!");
-  }
-
-
-
 }
 
 uint32_t
@@ -122,42 +114,42 @@ GmaHeader::Deserialize (Buffer::Iterator start)
 {
   uint16_t flags = start.ReadU16 ();
 
+  m_flags = flags;
   uint32_t optionBytes = 0;
   for (uint8_t ind = 0; ind < 16; ind++)
   {
-    m_flagsBits [ind] = flags%2;
-    flags >>= 1;
-    optionBytes += OPTION_SIZE_LIST[ind]*m_flagsBits [ind];
+    optionBytes += OPTION_SIZE_LIST[ind]*HasFlag (ind);
   }
+  m_optionBytes = optionBytes;
 
   //start reading the info from the header.
 
-  if(m_flagsBits[8] == 1)
+  if(HasFlag (8))
   {
     m_clientId = start.ReadU16();
   }
 
-  if(m_flagsBits[7] == 1)
+  if(HasFlag (7))
   {
     m_timeStamp = start.ReadU32();
   }
 
-  if(m_flagsBits[6] == 1)
+  if(HasFlag (6))
   {
     m_sequenceNumber = start.ReadU8 () << 16 | start.ReadU8 () << 8 | start.ReadU8 ();
   }
 
-  if(m_flagsBits[5] == 1)
+  if(HasFlag (5))
   {
    m_localSequenceNumber = start.ReadU8();
   }
 
-  if(m_flagsBits[3] == 1)
+  if(HasFlag (3))
   {
     m_flowId = start.ReadU8();
   }
 
-  if(m_flagsBits[2] == 1)
+  if(HasFlag (2))
   {
     m_connectionId = start.ReadU8();
   }
@@ -168,13 +160,7 @@ GmaHeader::Deserialize (Buffer::Iterator start)
 uint16_t
 GmaHeader::GetFlags() const
 {
-  uint16_t flags = 0;
-  for (uint8_t ind = 0; ind < 16; ind++)
-  {
-    flags += (m_flagsBits[ind] << (ind));
-  }
-  return flags;
-
+  return m_flags;
 }
 
 void
@@ -186,10 +172,7 @@ GmaHeader::SetTimeStamp (uint32_t timeStamp)
         milliseconds.
   */
   m_timeStamp = timeStamp;
-  //set the sequence number bits flag to true.
-  m_flagsBits[7] = 1;
-  //Add the size of timestamp to the option bytes.
-  m_optionBytes += OPTION_SIZE_LIST[7];
+  SetFlag (7);
 }
 
 uint32_t
@@ -208,10 +191,7 @@ GmaHeader::SetSequenceNumber (uint32_t sequenceNumber)
         or fragmentation. Sequence Number SHALL be generated per flow.
   */
   m_sequenceNumber = sequenceNumber;
-  //set the sequence number bits flag to true.
-  m_flagsBits[6] = 1;
-  //Add the size of sequence number to the option bytes.
-  m_optionBytes += OPTION_SIZE_LIST[6];
+  SetFlag (6);
 }
 
 uint32_t
@@ -230,10 +210,7 @@ GmaHeader::SetLocalSequenceNumber (uint8_t localSequenceNumber)
         per flow per connection.
   */
   m_localSequenceNumber = localSequenceNumber;
-  //set the local sequence number bits flag to true.
-  m_flagsBits[5] = 1;
-  //Add the size of sequence number to the option bytes.
-  m_optionBytes += OPTION_SIZE_LIST[5];
+  SetFlag (5);
 }
 
 uint8_t
@@ -251,10 +228,7 @@ GmaHeader::SetFlowId (uint8_t flowId)
           [LWIPEP] for a cellular (e.g. LTE) connection.
   */
   m_flowId = flowId;
-  //set the flow ID bits flag to true.
-  m_flagsBits[3] = 1;
-  //Add the size of timestamp to the option bytes.
-  m_optionBytes += OPTION_SIZE_LIST[3];
+  SetFlag (3);
 }
 
 uint8_t
@@ -275,10 +249,7 @@ GmaHeader::SetConnectionId (uint8_t connectionId)
         identify the delivery connection
   */
   m_connectionId = connectionId;
-  //set the connection ID bits flag to true.
-  m_flagsBits[2] = 1;
-  //Add the size of timestamp to the option bytes.
-  m_optionBytes += OPTION_SIZE_LIST[2];
+  SetFlag (2);
 }
 
 uint8_t
@@ -294,10 +265,7 @@ GmaHeader::SetClientId (uint16_t clientId)
   Client ID (2 Byte): ID per client
   */
   m_clientId = clientId;
-  //set the connection ID bits flag to true.
-  m_flagsBits[8] = 1;
-  //Add the size of timestamp to the option bytes.
-  m_optionBytes += OPTION_SIZE_LIST[8];
+  SetFlag (8);
 }
 
 uint16_t
@@ -308,5 +276,22 @@ GmaHeader::GetClientId () const
 
 
 
+void
+GmaHeader::SetFlag (uint8_t bit)
+{
+  if (!HasFlag (bit))
+  {
+    m_flags |= (1 << bit);
+    //Add the size of this field to the option bytes.
+    m_optionBytes += OPTION_SIZE_LIST[bit];
+  }
+}
+
+bool
+GmaHeader::HasFlag (uint8_t bit) const
+{
+  return (m_flags >> bit) & 1;
+}
+
 } //namespace ns3
 
@@ -144,10 +144,16 @@ private:
         + Client Id (bit 8): 2Bytes, Server use client Id to find virtual interface.
         + Bit 8-15: reserved
   */
-  bool m_flagsBits [16] = {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,};
+  uint16_t m_flags = 0;
 
   //the size of each optional field in Bytes.
-  uint8_t OPTION_SIZE_LIST [16] = {1, 0, 1, 1, 1, 1, 3, 4, 2, 0, 0, 0, 0, 0, 0, 0};
+  static const uint8_t OPTION_SIZE_LIST [16];
+  //flags of the fields that are serialized: client id, timestamp, sn, lsn, flow id and connection id.
+  static const uint16_t IMPLEMENTED_FLAGS = (1 << 8) | (1 << 7) | (1 << 6) | (1 << 5) | (1 << 3) | (1 << 2);
+
+  //set the flag bit of a field, the option bytes are only added the first time, so a header can be reused.
+  void SetFlag (uint8_t bit);
+  bool HasFlag (uint8_t bit) const;
 
 };
 
@@ -0,0 +1,195 @@
+/* Copyright(C) 2024 Intel Corporation
+*  SPDX-License-Identifier: GPL-2.0
+*  https://spdx.org/licenses/GPL-2.0.html
+*/
+
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+
+#include "gma-packet-trace.h"
+#include "ns3/simulator.h"
+#include "ns3/log.h"
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#include <cstring>
+#include <fstream>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("GmaPacketTrace");
+
+static const char TRACE_MAGIC[8] = {'G', 'M', 'A', 'T', 'R', 'A', 'C', 'E'};
+static const uint64_t MAP_WINDOW_BYTES = 1 << 22; //the file is mapped in windows of 4 MB.
+
+static_assert (sizeof (GmaPacketTrace::Record) == 24, "the trace record must be 24 bytes");
+
+GmaPacketTrace::GmaPacketTrace (uint32_t capacity)
+{
+  m_ring.resize (capacity);
+  GetTraceList ().insert (this);
+}
+
+GmaPacketTrace::~GmaPacketTrace ()
+{
+  Close ();
+  GetTraceList ().erase (this);
+}
+
+std::set<GmaPacketTrace*>&
+GmaPacketTrace::GetTraceList ()
+{
+  static std::set<GmaPacketTrace*> traceList;
+  return traceList;
+}
+
+void
+GmaPacketTrace::CloseAll ()
+{
+  for (GmaPacketTrace* trace : GetTraceList ())
+  {
+    if (trace->m_fd >= 0)
+    {
+      trace->Close ();
+      trace->m_reopen = true;
+    }
+  }
+}
+
+void
+GmaPacketTrace::Open (const std::string& fileName)
+{
+  Close ();
+  m_fileName = fileName;
+  m_reopen = false;
+  m_fd = open (fileName.c_str (), O_RDWR | O_CREAT | O_TRUNC, 0644);
+  if (m_fd < 0)
+  {
+    NS_FATAL_ERROR ("cannot open the packet trace file " << fileName);
+  }
+  m_fileSize = 0;
+  m_mapOffset = 0;
+  m_mapLength = 0;
+  uint32_t header[2] = {VERSION, sizeof (Record)};
+  Write (TRACE_MAGIC, sizeof (TRACE_MAGIC));
+  Write (header, sizeof (header));
+}
+
+void
+GmaPacketTrace::Close ()
+{
+  Flush ();
+  m_reopen = false;
+  if (m_fd < 0)
+  {
+    return;
+  }
+  if (m_map)
+  {
+    munmap (m_map, m_mapLength);
+    m_map = nullptr;
+  }
+  //the last window is larger than the written bytes.
+  if (ftruncate (m_fd, m_fileSize) != 0)
+  {
+    NS_LOG_WARN ("cannot truncate the packet trace file");
+  }
+  close (m_fd);
+  m_fd = -1;
+}
+
+void
+GmaPacketTrace::Add (EventType event, const GmaHeader& gmaHeader, uint32_t size)
+{
+  int64_t timeNs = Simulator::Now ().GetNanoSeconds ();
+  Record& record = m_ring[m_count];
+  record.m_timeNs = timeNs;
+  record.m_sn = gmaHeader.GetSequenceNumber ();
+  //the gma timestamp is the lower 32 bits of the sender time in ms.
+  record.m_owdMs = event == TX ? 0 : (uint32_t)(timeNs / 1000000) - gmaHeader.GetTimeStamp ();
+  record.m_size = size;
+  record.m_cid = gmaHeader.GetConnectionId ();
+  record.m_lsn = gmaHeader.GetLocalSequenceNumber ();
+  record.m_event = event;
+  record.m_flowId = gmaHeader.GetFlowId ();
+  record.m_reserved = 0;
+  if (++m_count == m_ring.size ())
+  {
+    Flush ();
+  }
+}
+
+void
+GmaPacketTrace::Flush ()
+{
+  if (m_count > 0 && m_reopen)
+  {
+    //closed by CloseAll, e.g., before a fork.
+    m_reopen = false;
+    Open (m_fileName);
+  }
+  if (m_count == 0 || m_fd < 0)
+  {
+    return;
+  }
+  Write (m_ring.data (), (uint64_t)m_count * sizeof (Record));
+  m_count = 0;
+}
+
+void
+GmaPacketTrace::Write (const void* data, uint64_t bytes)
+{
+  if (m_fileSize + bytes > m_mapOffset + m_mapLength)
+  {
+    //map the next window, starting from the page of the current file end.
+    if (m_map)
+    {
+      munmap (m_map, m_mapLength);
+      m_map = nullptr;
+    }
+    uint64_t pageSize = sysconf (_SC_PAGESIZE);
+    m_mapOffset = m_fileSize / pageSize * pageSize;
+    m_mapLength = MAP_WINDOW_BYTES;
+    while (m_mapOffset + m_mapLength < m_fileSize + bytes)
+    {
+      m_mapLength <<= 1;
+    }
+    if (ftruncate (m_fd, m_mapOffset + m_mapLength) != 0)
+    {
+      NS_FATAL_ERROR ("cannot extend the packet trace file");
+    }
+    void* map = mmap (nullptr, m_mapLength, PROT_READ | PROT_WRITE, MAP_SHARED, m_fd, m_mapOffset);
+    if (map == MAP_FAILED)
+    {
+      NS_FATAL_ERROR ("cannot map the packet trace file");
+    }
+    m_map = static_cast<uint8_t*> (map);
+  }
+  std::memcpy (m_map + (m_fileSize - m_mapOffset), data, bytes);
+  m_fileSize += bytes;
+}
+
+std::vector<GmaPacketTrace::Record>
+GmaPacketTrace::Read (const std::string& fileName)
+{
+  std::ifstream file (fileName, std::ios::in | std::ios::binary);
+  char magic[sizeof (TRACE_MAGIC)];
+  uint32_t header[2];
+  if (!file.read (magic, sizeof (magic)) || !file.read (reinterpret_cast<char*> (header), sizeof (header))
+      || std::memcmp (magic, TRACE_MAGIC, sizeof (magic)) != 0)
+  {
+    NS_FATAL_ERROR ("not a gma packet trace file " << fileName);
+  }
+  if (header[0] != VERSION || header[1] != sizeof (Record))
+  {
+    NS_FATAL_ERROR ("unsupported gma packet trace version " << header[0]);
+  }
+  std::vector<Record> recordList;
+  Record record;
+  while (file.read (reinterpret_cast<char*> (&record), sizeof (Record)))
+  {
+    recordList.push_back (record);
+  }
+  return recordList;
+}
+
+}
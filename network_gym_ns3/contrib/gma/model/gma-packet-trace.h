@@ -0,0 +1,77 @@
+/* Copyright(C) 2024 Intel Corporation
+*  SPDX-License-Identifier: GPL-2.0
+*  https://spdx.org/licenses/GPL-2.0.html
+*/
+
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+#ifndef GMA_PACKET_TRACE_H
+#define GMA_PACKET_TRACE_H
+
+#include "ns3/simple-ref-count.h"
+#include "gma-header.h"
+#include <stdint.h>
+#include <set>
+#include <string>
+#include <vector>
+
+namespace ns3 {
+
+//per packet binary trace of a gma interface. Fixed size records are added to a preallocated ring, a full
+//ring is copied into a memory mapped file and written back by the kernel, so tracing a packet costs a
+//store of 24 bytes. The file starts with a 16 bytes header ("GMATRACE", version, record size),
+//contrib/gma/utils/gma-trace-decode.py converts it to csv.
+//A forked process must not write into the mapped file of its parent, call CloseAll before fork(). The traces closed by
+//CloseAll are opened again at their next write, i.e., a relative file name is opened in the folder of the child.
+class GmaPacketTrace : public SimpleRefCount<GmaPacketTrace>
+{
+public:
+  enum EventType
+  {
+    TX = 0, //data packet sent over a link.
+    RX = 1, //data packet received from a link.
+    DELIVER = 2, //data packet forwarded to the upper layer, after reordering.
+  };
+
+  struct Record
+  {
+    int64_t m_timeNs; //simulation time.
+    uint32_t m_sn;
+    uint32_t m_owdMs; //0 for TX.
+    uint16_t m_size; //packet size in bytes, without the gma header.
+    uint8_t m_cid;
+    uint8_t m_lsn;
+    uint8_t m_event;
+    uint8_t m_flowId;
+    uint16_t m_reserved;
+  };
+
+  GmaPacketTrace (uint32_t capacity = 4096); //number of records buffered before they are written to the file.
+  ~GmaPacketTrace ();
+
+  void Open (const std::string& fileName);
+  void Close (); //write the buffered records and close the file.
+  void Add (EventType event, const GmaHeader& gmaHeader, uint32_t size);
+  void Flush (); //copy the buffered records into the file.
+  static void CloseAll (); //close the open traces, they are opened again (truncated) at their next write.
+
+  static std::vector<Record> Read (const std::string& fileName); //read all records of a trace file.
+
+  static const uint32_t VERSION = 1;
+private:
+  void Write (const void* data, uint64_t bytes);
+  static std::set<GmaPacketTrace*>& GetTraceList (); //all traces of the process.
+
+  std::string m_fileName;
+  bool m_reopen = false; //closed by CloseAll, open the file again at the next flush.
+  std::vector<Record> m_ring;
+  uint32_t m_count = 0; //number of buffered records.
+  int m_fd = -1;
+  uint8_t* m_map = nullptr; //mapped window of the file.
+  uint64_t m_mapOffset = 0; //file offset of the mapped window, page aligned.
+  uint64_t m_mapLength = 0;
+  uint64_t m_fileSize = 0; //bytes written.
+};
+
+}
+
+#endif /* GMA_PACKET_TRACE_H */
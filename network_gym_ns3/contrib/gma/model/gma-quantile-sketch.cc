@@ -0,0 +1,95 @@
+/* Copyright(C) 2024 Intel Corporation
+*  SPDX-License-Identifier: GPL-2.0
+*  https://spdx.org/licenses/GPL-2.0.html
+*/
+
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+
+#include "gma-quantile-sketch.h"
+#include <algorithm>
+#include <cmath>
+
+namespace ns3 {
+
+GmaQuantileSketch::GmaQuantileSketch ()
+{
+  m_bucketList.fill (0);
+}
+
+uint32_t
+GmaQuantileSketch::GetBucketIndex (uint32_t value)
+{
+  if (value < LINEAR_BUCKETS)
+  {
+    return value;
+  }
+  //the exponent is at least 5, the next SUB_BUCKET_BITS bits after the leading one select the sub bucket.
+  uint32_t exponent = 31 - __builtin_clz (value);
+  uint32_t subBucket = (value >> (exponent - SUB_BUCKET_BITS)) & ((1 << SUB_BUCKET_BITS) - 1);
+  return LINEAR_BUCKETS + ((exponent - 5) << SUB_BUCKET_BITS) + subBucket;
+}
+
+uint32_t
+GmaQuantileSketch::GetBucketLowerBound (uint32_t index)
+{
+  if (index < LINEAR_BUCKETS)
+  {
+    return index;
+  }
+  uint32_t exponent = ((index - LINEAR_BUCKETS) >> SUB_BUCKET_BITS) + 5;
+  uint32_t subBucket = (index - LINEAR_BUCKETS) & ((1 << SUB_BUCKET_BITS) - 1);
+  return (1u << exponent) + (subBucket << (exponent - SUB_BUCKET_BITS));
+}
+
+void
+GmaQuantileSketch::Add (uint32_t value)
+{
+  value = std::min (value, MAX_VALUE);
+  m_bucketList[GetBucketIndex (value)]++;
+  m_count++;
+  m_min = std::min (m_min, value);
+  m_max = std::max (m_max, value);
+}
+
+void
+GmaQuantileSketch::Clear ()
+{
+  m_bucketList.fill (0);
+  m_count = 0;
+  m_min = UINT32_MAX;
+  m_max = 0;
+}
+
+uint64_t
+GmaQuantileSketch::GetCount () const
+{
+  return m_count;
+}
+
+double
+GmaQuantileSketch::GetQuantile (double q) const
+{
+  if (m_count == 0)
+  {
+    return -1.0;
+  }
+  //the rank of the quantile sample, 1 to m_count.
+  uint64_t rank = std::max ((uint64_t)1, (uint64_t)std::ceil (q * m_count));
+  rank = std::min (rank, m_count);
+  uint64_t cumulative = 0;
+  for (uint32_t index = 0; index < NUM_BUCKETS; index++)
+  {
+    cumulative += m_bucketList[index];
+    if (cumulative >= rank)
+    {
+      //report the middle of the bucket, bounded by the min and max samples.
+      uint32_t lower = GetBucketLowerBound (index);
+      uint32_t upper = index + 1 < NUM_BUCKETS ? GetBucketLowerBound (index + 1) - 1 : MAX_VALUE;
+      double value = lower + (upper - lower) / 2.0;
+      return std::max ((double)m_min, std::min ((double)m_max, value));
+    }
+  }
+  return m_max;
+}
+
+}
@@ -0,0 +1,43 @@
+/* Copyright(C) 2024 Intel Corporation
+*  SPDX-License-Identifier: GPL-2.0
+*  https://spdx.org/licenses/GPL-2.0.html
+*/
+
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+#ifndef GMA_QUANTILE_SKETCH_H
+#define GMA_QUANTILE_SKETCH_H
+
+#include <stdint.h>
+#include <array>
+
+namespace ns3 {
+
+//fixed memory quantile sketch of delay samples (ms). Values below 32 are counted exactly, larger values
+//are counted in log buckets with 16 sub buckets per power of 2, the middle of a bucket is within 1/32
+//(about 3%) of any value in it. Add is O(1), a quantile query scans the buckets once.
+class GmaQuantileSketch
+{
+public:
+  GmaQuantileSketch ();
+  void Add (uint32_t value); //values larger than MAX_VALUE are counted as MAX_VALUE.
+  void Clear ();
+  uint64_t GetCount () const;
+  double GetQuantile (double q) const; //q in [0, 1], return -1 if no sample is added.
+
+  static constexpr uint32_t MAX_VALUE = 0x00FFFFFF; //about 4.6 hours in ms.
+private:
+  static const uint32_t LINEAR_BUCKETS = 32;
+  static const uint32_t SUB_BUCKET_BITS = 4;
+  static const uint32_t NUM_BUCKETS = LINEAR_BUCKETS + (24 - 5) * (1 << SUB_BUCKET_BITS);
+  static uint32_t GetBucketIndex (uint32_t value);
+  static uint32_t GetBucketLowerBound (uint32_t index);
+
+  std::array<uint32_t, NUM_BUCKETS> m_bucketList;
+  uint64_t m_count = 0;
+  uint32_t m_min = UINT32_MAX;
+  uint32_t m_max = 0;
+};
+
+}
+
+#endif /* GMA_QUANTILE_SKETCH_H */
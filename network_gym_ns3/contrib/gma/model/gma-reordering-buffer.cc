@@ -0,0 +1,277 @@
+/* Copyright(C) 2024 Intel Corporation
+*  SPDX-License-Identifier: GPL-2.0
+*  https://spdx.org/licenses/GPL-2.0.html
+*/
+
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+
+#include "gma-reordering-buffer.h"
+#include "ns3/log.h"
+#include <algorithm>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("GmaReorderingBuffer");
+
+GmaReorderingBuffer::GmaReorderingBuffer (uint32_t capacity, uint32_t maxCapacity)
+{
+  uint32_t size = 64;
+  while (size < capacity && size < SN_SPACE)
+  {
+    size <<= 1;
+  }
+  m_maxCapacity = size;
+  while (m_maxCapacity < maxCapacity && m_maxCapacity < SN_SPACE)
+  {
+    m_maxCapacity <<= 1;
+  }
+  m_slotList.resize (size);
+  m_occupiedBitmap.assign (size / 64, 0);
+  m_arrivalRing.resize (size);
+  m_mask = size - 1;
+}
+
+bool
+GmaReorderingBuffer::Insert (Ptr<Packet> packet, const GmaHeader& gmaHeader, bool inOrder, Time receivedTime)
+{
+  uint32_t sn = gmaHeader.GetSequenceNumber ();
+  if (m_size == 0)
+  {
+    m_minSn = sn;
+    m_maxSn = sn;
+  }
+  else
+  {
+    if (IsBuffered (sn))
+    {
+      //duplicated packet.
+      return false;
+    }
+    uint32_t span = GetSpan (sn);
+    if (span > m_maxCapacity)
+    {
+      NS_LOG_DEBUG ("sn " << sn << " is out of the reordering window [" << m_minSn << ", " << m_maxSn << "]");
+      return false;
+    }
+    if (span > m_slotList.size ())
+    {
+      Grow (span);
+    }
+    m_minSn = SnDiff (sn, m_minSn) < 0 ? sn : m_minSn;
+    m_maxSn = SnDiff (sn, m_maxSn) > 0 ? sn : m_maxSn;
+  }
+
+  uint32_t index = sn & m_mask;
+  Slot& slot = m_slotList[index];
+  slot.m_packet = packet;
+  slot.m_gmaHeader = gmaHeader;
+  slot.m_inOrder = inOrder;
+  slot.m_receivedTime = receivedTime;
+  m_occupiedBitmap[index >> 6] |= (uint64_t)1 << (index & 63);
+  m_size++;
+
+  if (m_arrivalCount == m_arrivalRing.size ())
+  {
+    PruneArrival ();
+  }
+  m_arrivalRing[(m_arrivalHead + m_arrivalCount) % m_arrivalRing.size ()] = sn;
+  m_arrivalCount++;
+  return true;
+}
+
+bool
+GmaReorderingBuffer::IsInWindow (uint32_t sn) const
+{
+  return m_size == 0 || GetSpan (sn) <= m_maxCapacity;
+}
+
+const GmaReorderingBuffer::Slot&
+GmaReorderingBuffer::GetMin () const
+{
+  NS_ASSERT_MSG (m_size > 0, "the reordering buffer is empty");
+  return m_slotList[m_minSn & m_mask];
+}
+
+void
+GmaReorderingBuffer::PopMin (Slot& slot)
+{
+  NS_ASSERT_MSG (m_size > 0, "the reordering buffer is empty");
+  uint32_t index = m_minSn & m_mask;
+  slot = m_slotList[index];
+  m_slotList[index].m_packet = 0;
+  m_occupiedBitmap[index >> 6] &= ~((uint64_t)1 << (index & 63));
+  m_size--;
+  if (m_size == 0)
+  {
+    m_arrivalHead = 0;
+    m_arrivalCount = 0;
+    return;
+  }
+
+  //find the next occupied slot, a word of the bitmap is checked at a time.
+  uint32_t next = (index + 1) & m_mask;
+  uint32_t distance = 1;
+  while (true)
+  {
+    uint64_t word = m_occupiedBitmap[next >> 6] >> (next & 63);
+    if (word != 0)
+    {
+      distance += __builtin_ctzll (word);
+      break;
+    }
+    uint32_t skip = 64 - (next & 63);
+    distance += skip;
+    next = (next + skip) & m_mask;
+  }
+  NS_ASSERT_MSG (distance <= ((m_maxSn - m_minSn) & (SN_SPACE - 1)), "the next buffered sn is out of the window");
+  m_minSn = (m_minSn + distance) & (SN_SPACE - 1);
+}
+
+void
+GmaReorderingBuffer::Clear ()
+{
+  for (uint32_t i = 0; i < m_slotList.size (); i++)
+  {
+    m_slotList[i].m_packet = 0;
+  }
+  std::fill (m_occupiedBitmap.begin (), m_occupiedBitmap.end (), 0);
+  m_size = 0;
+  m_arrivalHead = 0;
+  m_arrivalCount = 0;
+}
+
+bool
+GmaReorderingBuffer::IsEmpty () const
+{
+  return m_size == 0;
+}
+
+uint32_t
+GmaReorderingBuffer::GetSize () const
+{
+  return m_size;
+}
+
+uint32_t
+GmaReorderingBuffer::GetCapacity () const
+{
+  return m_slotList.size ();
+}
+
+uint32_t
+GmaReorderingBuffer::GetMinSn () const
+{
+  return m_minSn;
+}
+
+Time
+GmaReorderingBuffer::GetOldestReceivedTime ()
+{
+  NS_ASSERT_MSG (m_size > 0, "the reordering buffer is empty");
+  while (!IsBuffered (m_arrivalRing[m_arrivalHead]))
+  {
+    m_arrivalHead = (m_arrivalHead + 1) % m_arrivalRing.size ();
+    m_arrivalCount--;
+  }
+  return m_slotList[m_arrivalRing[m_arrivalHead] & m_mask].m_receivedTime;
+}
+
+int
+GmaReorderingBuffer::SnDiff (int x1, int x2)
+{
+  int diff = x1 - x2;
+  if (diff > 8388608)
+  {
+    diff = diff - 16777216;
+  }
+  else if (diff < -8388608)
+  {
+    diff = diff + 16777216;
+  }
+  return diff;
+}
+
+uint32_t
+GmaReorderingBuffer::GetSpan (uint32_t sn) const
+{
+  uint32_t minSn = SnDiff (sn, m_minSn) < 0 ? sn : m_minSn;
+  uint32_t maxSn = SnDiff (sn, m_maxSn) > 0 ? sn : m_maxSn;
+  return ((maxSn - minSn) & (SN_SPACE - 1)) + 1;
+}
+
+bool
+GmaReorderingBuffer::IsOccupied (uint32_t sn) const
+{
+  uint32_t index = sn & m_mask;
+  return (m_occupiedBitmap[index >> 6] >> (index & 63)) & 1;
+}
+
+bool
+GmaReorderingBuffer::IsBuffered (uint32_t sn) const
+{
+  return IsOccupied (sn) && m_slotList[sn & m_mask].m_gmaHeader.GetSequenceNumber () == sn;
+}
+
+void
+GmaReorderingBuffer::Grow (uint32_t span)
+{
+  uint32_t size = m_slotList.size ();
+  while (size < span)
+  {
+    size <<= 1;
+  }
+  NS_LOG_DEBUG ("grow the reordering buffer from " << m_slotList.size () << " to " << size << " slots");
+
+  std::vector<Slot> slotList (size);
+  std::vector<uint64_t> occupiedBitmap (size / 64, 0);
+  uint32_t mask = size - 1;
+  uint32_t oldSpan = ((m_maxSn - m_minSn) & (SN_SPACE - 1)) + 1;
+  for (uint32_t i = 0; i < oldSpan; i++)
+  {
+    uint32_t sn = (m_minSn + i) & (SN_SPACE - 1);
+    if (IsOccupied (sn))
+    {
+      uint32_t index = sn & mask;
+      slotList[index] = m_slotList[sn & m_mask];
+      occupiedBitmap[index >> 6] |= (uint64_t)1 << (index & 63);
+    }
+  }
+
+  std::vector<uint32_t> arrivalRing (size);
+  for (uint32_t i = 0; i < m_arrivalCount; i++)
+  {
+    arrivalRing[i] = m_arrivalRing[(m_arrivalHead + i) % m_arrivalRing.size ()];
+  }
+
+  m_slotList.swap (slotList);
+  m_occupiedBitmap.swap (occupiedBitmap);
+  m_arrivalRing.swap (arrivalRing);
+  m_arrivalHead = 0;
+  m_mask = mask;
+}
+
+void
+GmaReorderingBuffer::PruneArrival ()
+{
+  //drop the released packets from the arrival order, the oldest buffered packet is at the head.
+  uint32_t count = 0;
+  uint32_t capacity = m_arrivalRing.size ();
+  for (uint32_t i = 0; i < m_arrivalCount; i++)
+  {
+    uint32_t sn = m_arrivalRing[(m_arrivalHead + i) % capacity];
+    if (IsBuffered (sn))
+    {
+      m_arrivalRing[(m_arrivalHead + count) % capacity] = sn;
+      count++;
+    }
+  }
+  m_arrivalCount = count;
+  if (m_arrivalCount == capacity)
+  {
+    //a sn buffered again after its release is listed twice, drop the oldest entry.
+    m_arrivalHead = (m_arrivalHead + 1) % capacity;
+    m_arrivalCount--;
+  }
+}
+
+}
@@ -0,0 +1,80 @@
+/* Copyright(C) 2024 Intel Corporation
+*  SPDX-License-Identifier: GPL-2.0
+*  https://spdx.org/licenses/GPL-2.0.html
+*/
+
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+#ifndef GMA_REORDERING_BUFFER_H
+#define GMA_REORDERING_BUFFER_H
+
+#include "ns3/packet.h"
+#include "ns3/nstime.h"
+#include "gma-header.h"
+#include <stdint.h>
+#include <vector>
+
+namespace ns3 {
+
+//reordering buffer of a flow. The out of order packets of all links are stored in a preallocated ring
+//addressed by sn & mask, the occupied slots are tracked in a bitmap. The ring covers a window of the
+//24 bits sn space and doubles if a packet falls outside of it, so a packet is buffered without allocation.
+//The ring does not grow beyond a max capacity, a packet out of that window is not buffered (see IsInWindow).
+class GmaReorderingBuffer
+{
+public:
+  struct Slot
+  {
+    Ptr<Packet> m_packet;
+    GmaHeader m_gmaHeader;
+    bool m_inOrder = false; //in order based on the LSN, delivered once the packets before it are released.
+    Time m_receivedTime;
+  };
+
+  //initial and max number of slots, rounded up to a power of 2.
+  GmaReorderingBuffer (uint32_t capacity = 1024, uint32_t maxCapacity = MAX_CAPACITY);
+
+  //return false if a packet with this sn is already buffered, or if the sn is out of the window.
+  bool Insert (Ptr<Packet> packet, const GmaHeader& gmaHeader, bool inOrder, Time receivedTime);
+  //the buffered packets and this sn fit in the max capacity. If not, release the min sn packets until it fits.
+  bool IsInWindow (uint32_t sn) const;
+  const Slot& GetMin () const; //the buffered packet with the min sn.
+  void PopMin (Slot& slot); //move the packet with the min sn out of the buffer.
+  void Clear ();
+
+  bool IsEmpty () const;
+  uint32_t GetSize () const; //number of buffered packets.
+  uint32_t GetCapacity () const;
+  uint32_t GetMinSn () const;
+  Time GetOldestReceivedTime (); //the earliest received time of the buffered packets.
+
+  //compare the difference of two sequence number considering overflow
+  static int SnDiff (int x1, int x2);
+
+  static const uint32_t MAX_CAPACITY = 1 << 18; //about 1 second of 1400 bytes packets at 3 Gbps.
+
+private:
+  static const uint32_t SN_SPACE = 0x01000000;
+  bool IsOccupied (uint32_t sn) const;
+  bool IsBuffered (uint32_t sn) const; //the slot of this sn is occupied by a packet with this sn.
+  void Grow (uint32_t span); //rehash into a ring that covers span sequence numbers.
+
+  uint32_t GetSpan (uint32_t sn) const; //number of sn covered by the buffered packets and this sn.
+
+  std::vector<Slot> m_slotList;
+  uint32_t m_maxCapacity;
+  std::vector<uint64_t> m_occupiedBitmap; //one bit per slot.
+  uint32_t m_mask;
+  uint32_t m_size = 0;
+  uint32_t m_minSn = 0; //valid if m_size > 0.
+  uint32_t m_maxSn = 0; //valid if m_size > 0.
+
+  //sn of the buffered packets in arrival order, released ones are skipped lazily.
+  std::vector<uint32_t> m_arrivalRing;
+  uint32_t m_arrivalHead = 0;
+  uint32_t m_arrivalCount = 0;
+  void PruneArrival (); //compact the arrival ring if it is full.
+};
+
+}
+
+#endif /* GMA_REORDERING_BUFFER_H */
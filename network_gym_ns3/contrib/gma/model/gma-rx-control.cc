@@ -6,6 +6,7 @@
 /* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
 
 #include "gma-rx-control.h"
+#include <limits>
 namespace ns3 {
 
 NS_LOG_COMPONENT_DEFINE ("GmaRxControl");
@@ -28,12 +29,13 @@ GmaRxControl::GetTypeId (void)
     .AddAttribute ("SplittingAlgorithm", 
     			"Receiver side traffic splitting algorithm.",
                EnumValue<GmaRxAlgorithm> (GmaRxControl::Delay),
-               MakeEnumAccessor<GmaRxAlgorithm>(&GmaRxControl::m_algorithm),
+               MakeEnumAccessor<GmaRxAlgorithm>(&GmaRxControl::SetAlgorithmType, &GmaRxControl::GetAlgorithmType),
                MakeEnumChecker (GmaRxControl::Delay, "optimize average delay",
 			   					GmaRxControl::gma, "same as Delay, optimize average delay",
               					GmaRxControl::CongDelay, "after primary link congests, optimize average delay",
 								GmaRxControl::QosSteer, "qos steer mode",
-              					GmaRxControl::FixedHighPriority, "default high priority link"))
+              					GmaRxControl::FixedHighPriority, "default high priority link",
+								GmaRxControl::Policy, "policy selected by name with SetAlgorithm"))
     .AddAttribute ("SplittingBurst",
                "The splitting burst size for traffic spliting algorithm, support 1(steer mode), 4, 8, 16, 32, 64, 128",
                UintegerValue (1),
@@ -74,6 +76,28 @@ GmaRxControl::GetTypeId (void)
 	           BooleanValue (false),
 	           MakeBooleanAccessor (&GmaRxControl::m_enableQosFlowPrioritization),
 	           MakeBooleanChecker ())
+    .AddAttribute ("EnableBwEstimate",
+	           "If true, estimate the bandwidth (packets/s) of each link from the rx measurements",
+	           BooleanValue (true),
+	           MakeBooleanAccessor (&GmaRxControl::m_enableBwEstimate),
+	           MakeBooleanChecker ())
+    .AddAttribute ("BwEstimator",
+               "The bandwidth estimator: mean of the last BwHistSize intervals (Window), moving average (Ewma) or kalman filter (Kalman). Applied when the first measurement of a link is added",
+               EnumValue<GmaBwEstimator::Mode> (GmaBwEstimator::WINDOW),
+               MakeEnumAccessor<GmaBwEstimator::Mode> (&GmaRxControl::m_bwEstimatorMode),
+               MakeEnumChecker (GmaBwEstimator::WINDOW, "Window",
+                                GmaBwEstimator::EWMA, "Ewma",
+                                GmaBwEstimator::KALMAN, "Kalman"))
+    .AddAttribute ("BwHistSize",
+               "The number of intervals in the bandwidth history",
+               UintegerValue (10),
+               MakeUintegerAccessor (&GmaRxControl::m_bwHistSize),
+               MakeUintegerChecker<uint32_t> (1, GmaBwEstimator::MAX_HIST_SIZE))
+    .AddAttribute ("BwEwmaAlpha",
+               "The weight of the new interval for the Ewma bandwidth estimator, within (0, 1]",
+               DoubleValue (0.25),
+               MakeDoubleAccessor (&GmaRxControl::m_bwEwmaAlpha),
+               MakeDoubleChecker<double> (std::numeric_limits<double>::min (), 1.0))
   ;
   return tid;
 }
@@ -124,35 +148,135 @@ GmaRxControl::SetDelayThresh(double delay)
 void
 GmaRxControl::SetAlgorithm (std::string algorithm)
 {
-	if (algorithm == "Delay")
+	if (!GmaRxPolicyRegistry::Contains(algorithm))
 	{
-		m_algorithm = GmaRxControl::Delay;
+		NS_FATAL_ERROR ("algorithm not supported");
 	}
-	else if (algorithm == "gma")
+	m_algorithm = GmaRxControl::Policy;
+	for (int type = GmaRxControl::Delay; type < GmaRxControl::Policy; type++)
 	{
-		m_algorithm = GmaRxControl::gma;
+		if (GetAlgorithmName((GmaRxAlgorithm) type) == algorithm)
+		{
+			m_algorithm = (GmaRxAlgorithm) type;
+		}
 	}
-	else if (algorithm == "CongDelay")
+	m_algorithmName = algorithm;
+	m_policy = GmaRxPolicyRegistry::CreatePolicy(algorithm);
+}
+
+std::string
+GmaRxControl::GetAlgorithm () const
+{
+	return m_algorithmName;
+}
+
+void
+GmaRxControl::SetAlgorithmType (enum GmaRxAlgorithm algorithm)
+{
+	if (algorithm == GmaRxControl::Policy)
 	{
-		m_algorithm = GmaRxControl::CongDelay;
-	} 
-	else if (algorithm == "FixedHighPriority")
+		NS_FATAL_ERROR ("select a registered policy by name with SetAlgorithm");
+	}
+	SetAlgorithm(GetAlgorithmName(algorithm));
+}
+
+enum GmaRxControl::GmaRxAlgorithm
+GmaRxControl::GetAlgorithmType () const
+{
+	return m_algorithm;
+}
+
+std::string
+GmaRxControl::GetAlgorithmName (enum GmaRxAlgorithm algorithm)
+{
+	switch (algorithm)
 	{
-		m_algorithm = GmaRxControl::FixedHighPriority;
+		case GmaRxControl::Delay:
+			return "Delay";
+		case GmaRxControl::CongDelay:
+			return "CongDelay";
+		case GmaRxControl::FixedHighPriority:
+			return "FixedHighPriority";
+		case GmaRxControl::RlSplit:
+			return "RlSplit";
+		case GmaRxControl::QosSteer:
+			return "QosSteer";
+		case GmaRxControl::gma:
+			return "gma";
+		default:
+			NS_FATAL_ERROR ("the algorithm has no built-in policy");
 	}
-	else if (algorithm == "RlSplit")
+	return "";
+}
+
+Ptr<LinkState>
+GmaRxControl::GetLinkState () const
+{
+	return m_linkState;
+}
+
+const std::vector<uint8_t>&
+GmaRxControl::GetLastSplittingIndexList () const
+{
+	return m_lastSplittingIndexList;
+}
+
+void
+GmaRxControl::RestoreSplit (const std::vector<uint8_t>& splitIndexList, uint8_t splittingBurst)
+{
+	NS_ASSERT_MSG(splitIndexList.empty() || splitIndexList.size() == m_linkState->GetCidList().size(), "the split must have one index per link");
+	m_lastSplittingIndexList = splitIndexList;
+	m_splittingBurst = splittingBurst;
+}
+
+//the built-in algorithms are registered as policies, so they are selected the same way as the new ones.
+class GmaRxControl::DelayPolicy : public GmaRxPolicy
+{
+public:
+	Ptr<SplittingDecision> GetDecision (GmaRxControl& rxControl, Ptr<RxMeasurement> measurement) override
 	{
-		m_algorithm = GmaRxControl::RlSplit;
-	} 
-	else if (algorithm == "QosSteer")
+		return rxControl.DelayAlgorithm(measurement);
+	}
+};
+
+class GmaRxControl::CongDelayPolicy : public GmaRxPolicy
+{
+public:
+	Ptr<SplittingDecision> GetDecision (GmaRxControl& rxControl, Ptr<RxMeasurement> measurement) override
 	{
-		m_algorithm = GmaRxControl::QosSteer;
-	} 
-	else
+		return rxControl.CongDelayAlgorithm(measurement);
+	}
+};
+
+//the split is fixed (FixedHighPriority) or comes from the RlAction (RlSplit), the measurement never updates the split.
+class GmaRxControl::NoUpdatePolicy : public GmaRxPolicy
+{
+public:
+	Ptr<SplittingDecision> GetDecision (GmaRxControl& rxControl, Ptr<RxMeasurement> measurement) override
 	{
-		NS_FATAL_ERROR ("algorithm not supported");
+		Ptr<SplittingDecision> decision = Create<SplittingDecision> ();
+		decision->m_update = false;
+		return decision;
 	}
-}
+};
+
+class GmaRxControl::QosSteerPolicy : public GmaRxPolicy
+{
+public:
+	Ptr<SplittingDecision> GetDecision (GmaRxControl& rxControl, Ptr<RxMeasurement> measurement) override
+	{
+		return rxControl.QosSteerAlgorithm(measurement);
+	}
+};
+
+GmaRxPolicyRegistry::Registrar GmaRxControl::m_builtinPolicyList[] = {
+	{"Delay", &GmaRxPolicyRegistry::MakePolicy<GmaRxControl::DelayPolicy>},
+	{"gma", &GmaRxPolicyRegistry::MakePolicy<GmaRxControl::DelayPolicy>},
+	{"CongDelay", &GmaRxPolicyRegistry::MakePolicy<GmaRxControl::CongDelayPolicy>},
+	{"FixedHighPriority", &GmaRxPolicyRegistry::MakePolicy<GmaRxControl::NoUpdatePolicy>},
+	{"RlSplit", &GmaRxPolicyRegistry::MakePolicy<GmaRxControl::NoUpdatePolicy>},
+	{"QosSteer", &GmaRxPolicyRegistry::MakePolicy<GmaRxControl::QosSteerPolicy>},
+};
 
 Ptr<SplittingDecision>
 GmaRxControl::GetTrafficSplittingDecision (Ptr<RxMeasurement> measurement)
@@ -169,41 +293,64 @@ GmaRxControl::GetTrafficSplittingDecision (Ptr<RxMeasurement> measurement)
 	NS_ASSERT_MSG(measurement->m_links == measurement->m_lossRateList.size(), "size does not match!");
 	//oscialltion happens because the optimal ratio may not be acheivable due to the finite number of splitting burst size.
 	//In this case, the split ratio may bounce between 2 or few values.
-	Ptr<SplittingDecision> params;
-
-    if(m_algorithm == GmaRxControl::Delay)
+	if (m_enableBwEstimate)
 	{
-		params = DelayAlgorithm (measurement);
+		UpdateBwEstimate(measurement);
 	}
-	else if(m_algorithm == GmaRxControl::gma)
+
+	NS_ASSERT_MSG(m_policy, "no splitting policy is selected!");
+	Ptr<SplittingDecision> decision = m_policy->GetDecision(*this, measurement);
+	if (m_algorithm == GmaRxControl::Policy && decision->m_update)
 	{
-		params = DelayAlgorithm (measurement);
+		//the built-in algorithms store the split themselves.
+		NS_ASSERT_MSG(decision->m_splitIndexList.size() == measurement->m_links, "size does not match!");
+		m_lastSplittingIndexList = decision->m_splitIndexList;
 	}
-	else if(m_algorithm == GmaRxControl::CongDelay)
+	return decision;
+}
+
+void
+GmaRxControl::UpdateBwEstimate (Ptr<RxMeasurement> measurement)
+{
+	if (measurement->m_totalPktNumList.size() != measurement->m_links || measurement->m_measureIntervalDurationS <= 0)
 	{
-		params = CongDelayAlgorithm (measurement);
+		return;
 	}
-	else if(m_algorithm == GmaRxControl::FixedHighPriority)
+	for (uint8_t ind = 0; ind < measurement->m_links; ind++)
 	{
-		//std::cout << "no update \n";
-		Ptr<SplittingDecision> decision = Create<SplittingDecision> ();
-		decision->m_update = false;
-		return decision;
+		uint8_t cid = measurement->m_cidList[ind];
+		if (!m_linkState->GetCidTable()->Contains(cid))
+		{
+			continue;
+		}
+		uint32_t linkIndex = m_linkState->GetLinkIndex(cid);
+		if (linkIndex >= m_bwEstimatorList.size())
+		{
+			GmaBwEstimator estimator;
+			estimator.SetMode(m_bwEstimatorMode);
+			estimator.SetHistSize(m_bwHistSize);
+			estimator.SetEwmaAlpha(m_bwEwmaAlpha);
+			m_bwEstimatorList.resize(linkIndex + 1, estimator);
+		}
+		//k(i) of this interval is the split before the decision.
+		uint32_t splitIndex = ind < m_lastSplittingIndexList.size() ? m_lastSplittingIndexList[ind] : 0;
+		m_bwEstimatorList[linkIndex].Update(measurement->m_totalPktNumList[ind] / measurement->m_measureIntervalDurationS, splitIndex);
 	}
-	else if(m_algorithm == GmaRxControl::RlSplit)
+}
+
+double
+GmaRxControl::GetBwEstimate (uint8_t cid)
+{
+	if (!m_linkState || !m_linkState->GetCidTable()->Contains(cid))
 	{
-		//std::cout << "no update \n";
-		Ptr<SplittingDecision> decision = Create<SplittingDecision> ();
-		decision->m_update = false;
-		return decision;
+		return -1;
 	}
-	else
+	uint32_t linkIndex = m_linkState->GetLinkIndex(cid);
+	if (linkIndex >= m_bwEstimatorList.size())
 	{
-		NS_FATAL_ERROR("Unknown link selection method");
+		return -1;
 	}
-
-
-	return params;
+	return m_bwEstimatorList[linkIndex].GetBw();
 }
 
 Ptr<SplittingDecision>
@@ -227,7 +374,7 @@ GmaRxControl::GetTrafficSplittingDecision (Ptr<RlAction> action)
 		if (m_lastSplittingIndexList.size() == 0)
 		{
 			update = true;
-			std::vector<uint8_t> cidList = m_linkState->GetCidList();
+			const std::vector<uint8_t>& cidList = m_linkState->GetCidList();
 
 			for (uint8_t i = 0; i < cidList.size(); i++)
 			{
@@ -238,10 +385,10 @@ GmaRxControl::GetTrafficSplittingDecision (Ptr<RlAction> action)
 			}
 
 		}
-		else if (m_lastSplittingIndexList.at(m_linkState->m_cidToIndexMap[cid]) != ratio)
+		else if (m_lastSplittingIndexList.at(m_linkState->GetLinkIndex(cid)) != ratio)
 		{
 			update = true;
-			m_lastSplittingIndexList.at(m_linkState->m_cidToIndexMap[cid]) =  ratio;
+			m_lastSplittingIndexList.at(m_linkState->GetLinkIndex(cid)) =  ratio;
 		}
 	}
 
@@ -297,7 +444,7 @@ GmaRxControl::CongDelayAlgorithm (Ptr<RxMeasurement> measurement)
 	}
 	
 	//std::cout << "RX APP ";
-	if(m_lastSplittingIndexList.at(m_linkState->m_cidToIndexMap[m_linkState->GetLowPriorityLinkCid()]) == m_splittingBurst)
+	if(m_lastSplittingIndexList.at(m_linkState->GetLinkIndex(m_linkState->GetLowPriorityLinkCid())) == m_splittingBurst)
 	{
 		//std::cout << " Wi-Fi only loss:" << measurement->m_lossRateList.at(0);
 		//all traffic goes to primary link, detect congestion
@@ -327,21 +474,23 @@ GmaRxControl::CongDelayAlgorithm (Ptr<RxMeasurement> measurement)
 
 }
 
+template <bool STABLE, bool LOSS, bool ADAPTIVE>
 Ptr<SplittingDecision>
-GmaRxControl::DelayAlgorithm (Ptr<RxMeasurement> measurement, bool useMinOwd)
+GmaRxControl::DelayKernel (Ptr<RxMeasurement> measurement, bool useMinOwd)
 {
-	if (useMinOwd)
-	{
-		//overwrite the delay measurement with owd.
-		measurement->m_delayList = measurement->m_minOwdLongTerm;
-		
-	}
+	const uint32_t links = measurement->m_links;
+	NS_ASSERT_MSG(links <= MAX_LINKS, "the number of links cannot be larger than " << +MAX_LINKS);
+	//if useMinOwd is true, the long term min owd is used as the delay measurement.
+	const double* delayList = useMinOwd ? measurement->m_minOwdLongTerm.data() : measurement->m_delayList.data();
+	const double* lossList = measurement->m_lossRateList.data();
+	const uint8_t* cidList = measurement->m_cidList.data();
+
 	//start from all traffic goes to the first link
 	if(m_lastSplittingIndexList.size() == 0)
 	{
-		for (uint8_t ind = 0; ind < measurement->m_links; ind++)
+		for (uint32_t ind = 0; ind < links; ind++)
 		{
-			if(measurement->m_cidList.at(ind) == m_linkState->GetLowPriorityLinkCid())
+			if(cidList[ind] == m_linkState->GetLowPriorityLinkCid())
 			{
 				m_lastSplittingIndexList.push_back(m_splittingBurst);
 			}
@@ -349,106 +498,133 @@ GmaRxControl::DelayAlgorithm (Ptr<RxMeasurement> measurement, bool useMinOwd)
 			{
 				m_lastSplittingIndexList.push_back(0);
 			}
-			m_decreaseCounter.push_back(1);//all link start counter from 1
-			if(m_enableStableAlgorithm)
-			{
-				m_lastOwd.push_back(measurement->m_delayList.at(ind));//initial last owd to the same as the first one
-			}
 		}
 	}
+	if(m_decreaseCounter.size() != links)
+	{
+		//first decision of the delay algorithm, the split may come from another policy.
+		m_decreaseCounter.assign(links, 1);//all link start counter from 1
+		m_lastOwd.assign(delayList, delayList + links);//initial last owd to the same as the first one
+	}
+	uint8_t* splitIndexList = m_lastSplittingIndexList.data();
 
 	//we have steps in the delay algorithm:
 	//(1) if max owd - min owd > Thresh, move traffic from max owd link to min owd link;
 	//(2) all links have same delay, if max loss - min loss > loss thresh, move traffic from max loss link to min loss link;
 	//(3) [For steer mode: all links have same delay and same loss, if Wi-Fi RSSI is high, move traffic to wifi].
 	//find the max and min delay and index of all links.
-	double minDelay = 0;
-	double maxDelay = 0;
-	uint8_t minIndex = 0; 
-	uint8_t maxIndex = 0;
-	bool initialDelay = false;
 	//initial min and max link cid to any link with traffic.
-
-	for (uint8_t ind = 0; ind < measurement->m_links; ind++)
+	uint32_t firstActiveIndex = 0;
+	while (firstActiveIndex < links && splitIndexList[firstActiveIndex] == 0)
 	{
-		if(m_lastSplittingIndexList.at(ind) != 0)
-		{
-			minDelay = measurement->m_delayList.at(ind);
-			minIndex = ind;
-			maxDelay = measurement->m_delayList.at(ind);
-			maxIndex = ind;
-			initialDelay = true;
-			break;
-		}
+		firstActiveIndex++;
 	}
-	NS_ASSERT_MSG(initialDelay == true, "cannot initialize the min and max delay index");
+	NS_ASSERT_MSG(firstActiveIndex < links, "cannot initialize the min and max delay index");
 
-	for (uint8_t ind = 0; ind < measurement->m_links; ind++)
+	double minDelay = delayList[firstActiveIndex];
+	double maxDelay = delayList[firstActiveIndex];
+	uint32_t minIndex = firstActiveIndex;
+	uint32_t maxIndex = firstActiveIndex;
+
+	//the min and max Loss are initialized to the first link that is up.
+	double minLoss = 0;
+	double maxLoss= 0;
+	uint32_t minLossInd = 0;
+	uint32_t maxLossInd = 0;
+	bool initialLoss = false;
+
+	//owd of the last decision, m_lastOwd is overwritten by this measurement in the same pass.
+	std::array<int, MAX_LINKS> lastOwd;
+
+	//one pass finds the min and max delay, the min and max loss, and stores the owd for the next decision.
+	for (uint32_t ind = 0; ind < links; ind++)
 	{
-		if(m_linkState->IsLinkUp(measurement->m_cidList.at(ind)))//link is okey
+		if(m_linkState->IsLinkUp(cidList[ind]))//link is okey
 		{
-			if(minDelay > measurement->m_delayList.at(ind))
+			double delay = delayList[ind];
+			double loss = lossList[ind];
+			bool active = splitIndexList[ind] != 0;
+			if(minDelay > delay)
 			{
 				//find a link with lower delay. this can be idle link (no traffic)
-				minDelay = measurement->m_delayList.at(ind);
+				minDelay = delay;
 				minIndex = ind;
 			}
 
-			if(maxDelay < measurement->m_delayList.at(ind) && m_lastSplittingIndexList.at(ind) != 0)
+			if(maxDelay < delay && active)
 			{
 				//find a link with active traffic and with higher delay,
-				maxDelay = measurement->m_delayList.at(ind);
+				maxDelay = delay;
 				maxIndex = ind;
 			}
 
+			if(initialLoss == false)//min max loss not initialized yet
+			{
+				minLoss = loss;
+				minLossInd = ind;
+				maxLoss = loss;
+				maxLossInd = ind;
+				initialLoss = true;
+			}
+			else
+			{
+				if(minLoss > loss)
+				{
+					minLoss = loss;
+					minLossInd = ind;
+				}
+
+				if(maxLoss < loss && active)
+				{
+					maxLoss = loss;
+					maxLossInd = ind;
+				}
+			}
+		}
+
+		if(STABLE)
+		{
+			lastOwd[ind] = m_lastOwd[ind];
+			m_lastOwd[ind] = delayList[ind];
 		}
 	}
 
 	//change ratio only if |max delay - min delay| > m_delayThresh, in order to make this algorithm converge
 
-	//std::cout << Now().GetSeconds() << " minDelay: " << minDelay << " last minDelay: " << m_lastOwd.at(minIndex) << " minIndex: " << +minIndex << " minCid: " << +measurement->m_cidList.at(minIndex) << std::endl;
-	//std::cout << Now().GetSeconds() << " maxDelay: " << maxDelay << " last maxDelay: " << m_lastOwd.at(maxIndex) << " maxIndex: " << +maxIndex << " maxCid: " << +measurement->m_cidList.at(maxIndex) << std::endl;
+	//std::cout << Now().GetSeconds() << " minDelay: " << minDelay << " last minDelay: " << lastOwd[minIndex] << " minIndex: " << +minIndex << " minCid: " << +cidList[minIndex] << std::endl;
+	//std::cout << Now().GetSeconds() << " maxDelay: " << maxDelay << " last maxDelay: " << lastOwd[maxIndex] << " maxIndex: " << +maxIndex << " maxCid: " << +cidList[maxIndex] << std::endl;
 
 	bool update = false;
 	if( maxDelay - minDelay > m_delayThresh)
 	{
-		if (m_enableStableAlgorithm == false || (m_enableStableAlgorithm == true && m_lastOwd.at(maxIndex) <= measurement->m_delayList.at(maxIndex) ))
+		if (STABLE == false || (STABLE == true && lastOwd[maxIndex] <= delayList[maxIndex] ))
 		{
 			//if statble algorithm not enabled, 
 			//or stable algorithm enabled and this measurement delay is not decreasing
-			if(m_lastSplittingIndexList.at(maxIndex) > 0)
+			if(splitIndexList[maxIndex] > 0)
 			{
-				if(m_enableAdaptiveStep)
+				if(ADAPTIVE)
 				{
-					for (uint8_t ind = 0; ind < m_decreaseCounter.size(); ind++)
-					{
-						if(ind == maxIndex)
-						{
-							//increase the number of decrease counter
-							m_decreaseCounter.at(maxIndex)++;
-						}
-						else
-						{
-							//for other links, reset to 1.
-							m_decreaseCounter.at(ind) = 1;
-						}
-					}
+					//increase the number of decrease counter of the max link, for other links, reset to 1.
+					uint8_t maxDecreaseCounter = m_decreaseCounter[maxIndex] + 1;
+					std::fill(m_decreaseCounter.begin(), m_decreaseCounter.end(), 1);
+					m_decreaseCounter[maxIndex] = maxDecreaseCounter;
 					//increase step if the maxIndex link continue decreases multiple times
-					int step = std::max((int)m_decreaseCounter.at(maxIndex) - STEP_THRESH, 1);
+					int step = std::max((int)maxDecreaseCounter - STEP_THRESH, 1);
 
-					if (step >= m_lastSplittingIndexList.at(maxIndex))
+					if (step >= splitIndexList[maxIndex])
 					{
 						//make sure the m_lastSplittingIndexList.at(maxIndex)-step not equal to zero!
-						step = m_lastSplittingIndexList.at(maxIndex);
+						step = splitIndexList[maxIndex];
 					}
 
-					m_lastSplittingIndexList.at(maxIndex) -= step;
-					m_lastSplittingIndexList.at(minIndex) += step;
+					splitIndexList[maxIndex] -= step;
+					splitIndexList[minIndex] += step;
 				}
 				else
 				{
-					m_lastSplittingIndexList.at(maxIndex)--;
-					m_lastSplittingIndexList.at(minIndex)++;
+					splitIndexList[maxIndex]--;
+					splitIndexList[minIndex]++;
 				}
 				update = true;
 			}
@@ -456,67 +632,18 @@ GmaRxControl::DelayAlgorithm (Ptr<RxMeasurement> measurement, bool useMinOwd)
 	}
 	else//all links have same delay, reset all decrease counter to 1.
 	{
-		for (uint8_t ind = 0; ind < m_decreaseCounter.size(); ind++)
-		{
-			m_decreaseCounter.at(ind) = 1; //reset to 1.
-		}
-	}
-
-	if(m_enableStableAlgorithm)
-	{
-		for (uint8_t ind = 0; ind < measurement->m_links; ind++)
-		{
-			m_lastOwd.at(ind) = measurement->m_delayList.at(ind);
-		}
-
+		std::fill(m_decreaseCounter.begin(), m_decreaseCounter.end(), 1);
 	}
 
-	if(update == false && (maxDelay - minDelay <= m_delayThresh) && m_enableLossAlgorithm)//the delay difference of all links are small.
+	if(update == false && (maxDelay - minDelay <= m_delayThresh) && LOSS)//the delay difference of all links are small.
 	{
-		//find the max and min Loss and index of all links.
-		double minLoss = 0;
-		double maxLoss= 0;
-		uint8_t minLossInd = 0;
-		uint8_t maxLossInd = 0;
-
-		bool initialLoss = false;
-
-		for (uint8_t ind = 0; ind < measurement->m_links; ind++)
-		{
-			if(m_linkState->IsLinkUp(measurement->m_cidList.at(ind)))//link is okey
-			{
-				if(initialLoss == false)//min max loss not initialized yet
-				{
-					minLoss = measurement->m_lossRateList.at(ind);
-					minLossInd = ind;
-					maxLoss = measurement->m_lossRateList.at(ind);
-					maxLossInd = ind;
-					initialLoss = true;
-				}
-				else
-				{
-					if(minLoss > measurement->m_lossRateList.at(ind))
-					{
-						minLoss = measurement->m_lossRateList.at(ind);
-						minLossInd = ind;
-					}
-
-					if(maxLoss < measurement->m_lossRateList.at(ind) && m_lastSplittingIndexList.at(ind) != 0)
-					{
-						maxLoss = measurement->m_lossRateList.at(ind);
-						maxLossInd = ind;
-					}
-				}
-			}
-		}
-
 		if(maxLoss > minLoss * LOSS_ALGORITHM_BOUND)
 		{
-			if(m_lastSplittingIndexList.at(maxLossInd) > 0)
+			if(splitIndexList[maxLossInd] > 0)
 			{
 				//no need to use adaptive algorithm here
-				m_lastSplittingIndexList.at(maxLossInd)--;
-				m_lastSplittingIndexList.at(minLossInd)++;
+				splitIndexList[maxLossInd]--;
+				splitIndexList[minLossInd]++;
 				update = true;
 			}
 		}
@@ -527,23 +654,23 @@ GmaRxControl::DelayAlgorithm (Ptr<RxMeasurement> measurement, bool useMinOwd)
 			if(m_splittingBurst == 1 && minIndex != maxIndex && m_linkState->IsLinkUp(m_linkState->GetLowPriorityLinkCid()))
 			{
 				//steer mode, we move all traffic over wifi...
-				NS_ASSERT_MSG(m_linkState->m_cidToIndexMap.find(m_linkState->GetLowPriorityLinkCid()) != m_linkState->m_cidToIndexMap.end(), "cannot find this cid in the map");
-				if(m_lastSplittingIndexList.at(m_linkState->m_cidToIndexMap[m_linkState->GetLowPriorityLinkCid()]) == m_splittingBurst)
+				NS_ASSERT_MSG(m_linkState->GetCidTable()->Contains(m_linkState->GetLowPriorityLinkCid()), "cannot find this cid in the map");
+				if(splitIndexList[m_linkState->GetLinkIndex(m_linkState->GetLowPriorityLinkCid())] == m_splittingBurst)
 				{
 					//do nothing...traffic is over Default link already
 				}
 				else
 				{
-					for (uint8_t ind = 0; ind < measurement->m_links; ind++)
+					for (uint32_t ind = 0; ind < links; ind++)
 					{
-						if(measurement->m_cidList.at(ind) == m_linkState->GetLowPriorityLinkCid())
+						if(cidList[ind] == m_linkState->GetLowPriorityLinkCid())
 						{
-							m_lastSplittingIndexList.at(ind) = m_splittingBurst;
+							splitIndexList[ind] = m_splittingBurst;
 							update = true;
 						}
 						else
 						{
-							m_lastSplittingIndexList.at(ind) = 0;
+							splitIndexList[ind] = 0;
 						}
 					}
 					NS_ASSERT_MSG(update, "Default CID should be in the cid list!!!");
@@ -554,30 +681,11 @@ GmaRxControl::DelayAlgorithm (Ptr<RxMeasurement> measurement, bool useMinOwd)
 		//std::cout << " >>> max loss:" << maxLoss << " index:" << +maxLossInd << " min loss:" <<minLoss << " index:" << +minLossInd << "\n";
 	}
 
-	if(update)
-	{
-		/*std::cout << "RX APP ======= ";
-		for (uint8_t ind = 0; ind < measurement->m_links; ind++)
-		{
-			std::cout << "[link:" << +ind << " delay:"<<measurement->m_delayList.at (ind)
-			<< " loss:" << measurement->m_lossRateList.at (ind)<<"] ";
-		}
-		std::cout << "\n";
-		std::cout << " >>>>>> max delay:" << maxDelay << " index:" << +maxIndex << " min delay:" <<minDelay << " index:" << +minIndex << "\n";
-		std::cout << " >>>>>> ";
-		for (uint8_t ind = 0; ind < measurement->m_links; ind++)
-		{
-			std::cout << "[link:" << +ind << " ratio:"<<+m_lastSplittingIndexList.at (ind)<< "] ";
-		}
-		std::cout << "\n";*/
-	}
-
-	
 	//check if the sum equals splitting burst size;
 	uint8_t sumRatio = 0;
-	for (uint8_t ind = 0; ind < measurement->m_links; ind++)
+	for (uint32_t ind = 0; ind < links; ind++)
 	{
-		sumRatio += m_lastSplittingIndexList.at (ind);
+		sumRatio += splitIndexList[ind];
 	}
 
 	NS_ASSERT_MSG(sumRatio == m_splittingBurst, "the summation must equals the splitting burst size");
@@ -589,6 +697,25 @@ GmaRxControl::DelayAlgorithm (Ptr<RxMeasurement> measurement, bool useMinOwd)
 
 }
 
+Ptr<SplittingDecision>
+GmaRxControl::DelayAlgorithm (Ptr<RxMeasurement> measurement, bool useMinOwd)
+{
+	//the flags are attributes and may change at any time, select the specialization per decision.
+	typedef Ptr<SplittingDecision> (GmaRxControl::*Kernel) (Ptr<RxMeasurement>, bool);
+	static const Kernel kernelList[8] = {
+		&GmaRxControl::DelayKernel<false, false, false>,
+		&GmaRxControl::DelayKernel<false, false, true>,
+		&GmaRxControl::DelayKernel<false, true, false>,
+		&GmaRxControl::DelayKernel<false, true, true>,
+		&GmaRxControl::DelayKernel<true, false, false>,
+		&GmaRxControl::DelayKernel<true, false, true>,
+		&GmaRxControl::DelayKernel<true, true, false>,
+		&GmaRxControl::DelayKernel<true, true, true>,
+	};
+	uint32_t index = (m_enableStableAlgorithm ? 4 : 0) + (m_enableLossAlgorithm ? 2 : 0) + (m_enableAdaptiveStep ? 1 : 0);
+	return (this->*kernelList[index]) (measurement, useMinOwd);
+}
+
 Ptr<SplittingDecision>
 GmaRxControl::LinkDownTsu (uint8_t cid)
 {
@@ -616,7 +743,7 @@ GmaRxControl::LinkDownTsu (uint8_t cid)
 				update = true;
 
 				std::vector<uint8_t> splittingIndexList;
-				std::vector<uint8_t> cidList = m_linkState->GetCidList();
+				const std::vector<uint8_t>& cidList = m_linkState->GetCidList();
 
 				for (uint8_t ind = 0; ind < cidList.size(); ind++)
 				{
@@ -650,9 +777,9 @@ GmaRxControl::LinkDownTsu (uint8_t cid)
 		}
 		else
 		{
-			NS_ASSERT_MSG(m_linkState->m_cidToIndexMap.find(cid) != m_linkState->m_cidToIndexMap.end(), "cannot find this cid in the map");
+			NS_ASSERT_MSG(m_linkState->GetCidTable()->Contains(cid), "cannot find this cid in the map");
 
-			uint8_t failedLink = m_linkState->m_cidToIndexMap[cid];//get the index of the failed link
+			uint8_t failedLink = m_linkState->GetLinkIndex(cid);//get the index of the failed link
 
 			if(m_lastSplittingIndexList.at(failedLink) == 0)
 			{
@@ -662,7 +789,7 @@ GmaRxControl::LinkDownTsu (uint8_t cid)
 			else
 			{
 				bool allLinkDown = true;
-				std::vector<uint8_t> cidList = m_linkState->GetCidList();
+				const std::vector<uint8_t>& cidList = m_linkState->GetCidList();
 
 				for (uint16_t ind = 0; ind < m_lastSplittingIndexList.size(); ind++ )
 				{
@@ -756,18 +883,33 @@ GmaRxControl::QosSteerAlgorithm (Ptr<RxMeasurement> measurement)
 	uint16_t trafficOverPrimaryLink = 0;
 	uint16_t trafficOverOtherLinks = 0; //traffic over the previous backuplink.
 
-	uint8_t primaryLinkIndex = m_linkState->m_cidToIndexMap[m_linkState->GetHighPriorityLinkCid()];
-	std::vector<uint8_t> otherCidList;
-	for (uint8_t ind = 0; ind < measurement->m_links; ind++)
+	const uint32_t links = measurement->m_links;
+	NS_ASSERT_MSG(links <= MAX_LINKS, "the number of links cannot be larger than " << +MAX_LINKS);
+	uint8_t primaryLinkIndex = m_linkState->GetLinkIndex(m_linkState->GetHighPriorityLinkCid());
+	std::array<uint8_t, MAX_LINKS> otherCidList;
+	uint32_t otherCidNum = 0;
+	std::array<uint8_t, MAX_LINKS> qosOkList; //index of the links (not the primary link) that meet the qos requirement.
+	uint32_t qosOkNum = 0;
+	//one pass sums the traffic of the primary and other links, and checks the qos requirement of the other links.
+	for (uint32_t ind = 0; ind < links; ind++)
 	{
 		if(ind == primaryLinkIndex)
 		{
-			trafficOverPrimaryLink += m_lastSplittingIndexList.at(ind);
+			trafficOverPrimaryLink += m_lastSplittingIndexList[ind];
 		}
 		else
 		{
-			trafficOverOtherLinks += m_lastSplittingIndexList.at(ind);
-			otherCidList.push_back(measurement->m_cidList.at(ind));
+			trafficOverOtherLinks += m_lastSplittingIndexList[ind];
+			otherCidList[otherCidNum++] = measurement->m_cidList[ind];
+			if(m_linkState->IsLinkUp(measurement->m_cidList[ind]))//not the primary link and this link is okey
+			{
+				if(measurement->m_highDelayRatioList[ind] >= 0 && measurement->m_highDelayRatioList[ind] < m_qosDelayViolationTarget 
+					&& measurement->m_lossRateList[ind] >= 0 && measurement->m_lossRateList[ind] < m_qosLossTarget)
+				{
+					//pass the check of qos requirement
+					qosOkList[qosOkNum++] = ind;//add this link into qos OK list
+				}
+			}
 		}
 	}
 	//std::cout<< " primary cid:" << +m_linkState->GetHighPriorityLinkCid() << " primary ind:" << +primaryLinkIndex
@@ -778,20 +920,6 @@ GmaRxControl::QosSteerAlgorithm (Ptr<RxMeasurement> measurement)
 
 	if(trafficOverOtherLinks == 0) //no traffic over backup or other link, received measurement for QoS testing...
 	{
-		std::vector<uint8_t> qosOkList;
-		for (uint8_t ind = 0; ind < measurement->m_links; ind++)
-		{
-			if(ind != primaryLinkIndex && m_linkState->IsLinkUp(measurement->m_cidList.at(ind)))//not the primary link and this link is okey
-			{
-				if(measurement->m_highDelayRatioList.at(ind) >= 0 && measurement->m_highDelayRatioList.at(ind) < m_qosDelayViolationTarget 
-					&& measurement->m_lossRateList.at(ind) >= 0 && measurement->m_lossRateList.at(ind) < m_qosLossTarget)
-				{
-					//pass the check of qos requirement
-					qosOkList.push_back(ind);//add this link into qos OK list
-				}
-			}
-		}
-
 		//std::cout  << "links:" << +measurement->m_links << " Traffic over primary link ("<<+m_linkState->GetHighPriorityLinkCid()<<"):" << trafficOverPrimaryLink
 		//<< " Traffic over Backup link("<<+backupCid<<"):" << trafficOverBackupLinks 
 		//<< " m_lastTestingTime:" << m_linkState->m_cidToLastTestFailTime[backupCid].GetSeconds()
@@ -799,35 +927,35 @@ GmaRxControl::QosSteerAlgorithm (Ptr<RxMeasurement> measurement)
 		//<< " now:" << Now().GetSeconds();
 
 		//std::cout << " qosOkList:";
-		//for (uint32_t i = 0; i < qosOkList.size(); i++)
+		//for (uint32_t i = 0; i < qosOkNum; i++)
 		//{
-		//	std::cout << +qosOkList.at(i) << "";
+		//	std::cout << +qosOkList[i] << "";
 		//}
 		//std::cout << std::endl;
 
-		if(qosOkList.empty())//qos fail or no traffic
+		if(qosOkNum == 0)//qos fail or no traffic
 		{
-			for (uint32_t i = 0; i < otherCidList.size(); i++)
+			for (uint32_t i = 0; i < otherCidNum; i++)
 			{
-				if(measurement->m_highDelayRatioList.at(m_linkState->m_cidToIndexMap[otherCidList.at(i)]) >= 0 && measurement->m_lossRateList.at(m_linkState->m_cidToIndexMap[otherCidList.at(i)]) >= 0)//measurement available, and qos fail...
+				if(measurement->m_highDelayRatioList.at(m_linkState->GetLinkIndex(otherCidList[i])) >= 0 && measurement->m_lossRateList.at(m_linkState->GetLinkIndex(otherCidList[i])) >= 0)//measurement available, and qos fail...
 				{
-					m_linkState->m_cidToLastTestFailTime[otherCidList.at(i)] = Now();//record the failed time
-					m_linkState->m_cidToValidTestExpireTime.erase(otherCidList.at(i));
+					m_linkState->m_cidToLastTestFailTime[otherCidList[i]] = Now();//record the failed time
+					m_linkState->m_cidToValidTestExpireTime.erase(otherCidList[i]);
 					
 				}
 				else//idle case
 				{
-					//m_linkState->m_cidToLastTestFailTime.erase(otherCidList.at(i));//remove this cid, client can re start testing right away (after receiving a packet)
+					//m_linkState->m_cidToLastTestFailTime.erase(otherCidList[i]);//remove this cid, client can re start testing right away (after receiving a packet)
 				}
 			}
 		}
-		else if(qosOkList.size() == 1)//qos pass for 1 link, switch to this link
+		else if(qosOkNum == 1)//qos pass for 1 link, switch to this link
 		{
 			
 			//traffic over both primary and backup links, in testing mode -> switch to backup link that meet qos requirement
 			for (uint8_t ind = 0; ind < measurement->m_links; ind++)
 			{
-				if(ind == qosOkList.at(0))
+				if(ind == qosOkList[0])
 				{
 					m_lastSplittingIndexList.at(ind) = m_splittingBurst;
 				}
@@ -837,8 +965,8 @@ GmaRxControl::QosSteerAlgorithm (Ptr<RxMeasurement> measurement)
 				}
 			}
 			update = true;
-			m_linkState->m_cidToLastTestFailTime.erase(measurement->m_cidList.at(qosOkList.at(0)));//remove this cid, client can re start testing right away (after receiving a packet) if it fails again
-			m_linkState->m_cidToValidTestExpireTime[measurement->m_cidList.at(qosOkList.at(0))] = Now() + m_linkState->MAX_QOS_VALID_INTERVAL; // we assume the qos of this cid link is valid for m_linkState->MAX_QOS_VALID_INTERVAL.
+			m_linkState->m_cidToLastTestFailTime.erase(measurement->m_cidList.at(qosOkList[0]));//remove this cid, client can re start testing right away (after receiving a packet) if it fails again
+			m_linkState->m_cidToValidTestExpireTime[measurement->m_cidList.at(qosOkList[0])] = Now() + m_linkState->MAX_QOS_VALID_INTERVAL; // we assume the qos of this cid link is valid for m_linkState->MAX_QOS_VALID_INTERVAL.
 
 		}
 		else //multiple links meet the requirement... did not implement this case yet
@@ -848,27 +976,14 @@ GmaRxControl::QosSteerAlgorithm (Ptr<RxMeasurement> measurement)
 	}
 	else //traffic over backup link, check qos requirement.
 	{
-		std::vector<uint8_t> qosOkList;
-		for (uint8_t ind = 0; ind < measurement->m_links; ind++)
-		{
-			if(ind != primaryLinkIndex && m_linkState->IsLinkUp(measurement->m_cidList.at(ind)))//not the primary link and this link is okey
-			{
-				if(measurement->m_highDelayRatioList.at(ind) >= 0 && measurement->m_highDelayRatioList.at(ind) < m_qosDelayViolationTarget 
-					&& measurement->m_lossRateList.at(ind) >= 0 && measurement->m_lossRateList.at(ind) < m_qosLossTarget)
-				{
-					//pass the check of qos requirement
-					qosOkList.push_back(ind);
-				}
-			}
-		}
 		/*std::cout << Now().GetSeconds() << " QOS Monitoring Measurement End. qosOkList:";
-		for (uint32_t i = 0; i < qosOkList.size(); i++)
+		for (uint32_t i = 0; i < qosOkNum; i++)
 		{
-			std::cout << +qosOkList.at(i) << "";
+			std::cout << +qosOkList[i] << "";
 		}
 		std::cout << std::endl;*/
 
-		if(qosOkList.empty())//may be qos fail or no traffic
+		if(qosOkNum == 0)//may be qos fail or no traffic
 		{
 			//qos check failed, fall back to LTE...
 			for (uint8_t ind = 0; ind < measurement->m_links; ind++)
@@ -884,30 +999,30 @@ GmaRxControl::QosSteerAlgorithm (Ptr<RxMeasurement> measurement)
 			}
 			update = true;
 
-			for (uint32_t i = 0; i < otherCidList.size(); i++)
+			for (uint32_t i = 0; i < otherCidNum; i++)
 			{
-				if(measurement->m_highDelayRatioList.at(m_linkState->m_cidToIndexMap[otherCidList.at(i)]) >= 0 && measurement->m_lossRateList.at(m_linkState->m_cidToIndexMap[otherCidList.at(i)]) >= 0)//measurement available, and qos fail...
+				if(measurement->m_highDelayRatioList.at(m_linkState->GetLinkIndex(otherCidList[i])) >= 0 && measurement->m_lossRateList.at(m_linkState->GetLinkIndex(otherCidList[i])) >= 0)//measurement available, and qos fail...
 				{
-					m_linkState->m_cidToLastTestFailTime[otherCidList.at(i)] = Now();//record the failed time
-					m_linkState->m_cidToValidTestExpireTime.erase(otherCidList.at(i));
+					m_linkState->m_cidToLastTestFailTime[otherCidList[i]] = Now();//record the failed time
+					m_linkState->m_cidToValidTestExpireTime.erase(otherCidList[i]);
 				}
 				else//idle case
 				{
-					//m_linkState->m_cidToLastTestFailTime.erase(otherCidList.at(i));//remove this cid, client can re start testing right away (after receiving a packet)
+					//m_linkState->m_cidToLastTestFailTime.erase(otherCidList[i]);//remove this cid, client can re start testing right away (after receiving a packet)
 				}
 			}
 		}
-		else if(qosOkList.size() == 1)//qos pass for 1 link, continue sending on this link...
+		else if(qosOkNum == 1)//qos pass for 1 link, continue sending on this link...
 		{
 			//check if the passed link is the current link...
 			for (uint8_t ind = 0; ind < measurement->m_links; ind++)
 			{
-				if(ind == qosOkList.at(0))
+				if(ind == qosOkList[0])
 				{
 					if (m_lastSplittingIndexList.at(ind) == m_splittingBurst)
 					{
 						//traffic is over this link, no action
-						m_linkState->m_cidToLastTestFailTime.erase(measurement->m_cidList.at(qosOkList.at(0)));//remove this cid, client can re start testing right away (after receiving a packet) if it fails again
+						m_linkState->m_cidToLastTestFailTime.erase(measurement->m_cidList.at(qosOkList[0]));//remove this cid, client can re start testing right away (after receiving a packet) if it fails again
 					}
 					else
 					{
@@ -924,12 +1039,12 @@ GmaRxControl::QosSteerAlgorithm (Ptr<RxMeasurement> measurement)
 								m_lastSplittingIndexList.at(itemp) = 0;
 							}
 						}
-						m_linkState->m_cidToLastTestFailTime.erase(measurement->m_cidList.at(qosOkList.at(0)));//remove this cid, client can re start testing right away (after receiving a packet) if it fails again
+						m_linkState->m_cidToLastTestFailTime.erase(measurement->m_cidList.at(qosOkList[0]));//remove this cid, client can re start testing right away (after receiving a packet) if it fails again
 						update = true;
 					}
 				}
 			}
-			m_linkState->m_cidToValidTestExpireTime[measurement->m_cidList.at(qosOkList.at(0))] = Now() + m_linkState->MAX_QOS_VALID_INTERVAL; // we assume the qos of this cid link is valid for m_linkState->MAX_QOS_VALID_INTERVAL.
+			m_linkState->m_cidToValidTestExpireTime[measurement->m_cidList.at(qosOkList[0])] = Now() + m_linkState->MAX_QOS_VALID_INTERVAL; // we assume the qos of this cid link is valid for m_linkState->MAX_QOS_VALID_INTERVAL.
 
 		}
 		else //multiple links meet the requirement... did not implement this case yet
@@ -995,11 +1110,11 @@ Ptr<SplittingDecision>
 GmaRxControl::GenerateTrafficSplittingDecision (uint8_t cid, bool reverse)
 {
 	bool update = true;
-	//NS_ASSERT_MSG(m_linkState->m_cidToIndexMap.find(cid) != m_linkState->m_cidToIndexMap.end(), "cannot be end of this map cid:" << +cid);
+	//NS_ASSERT_MSG(m_linkState->GetCidTable()->Contains(cid), "cannot be end of this map cid:" << +cid);
 
 	Ptr<SplittingDecision> decision = Create<SplittingDecision> ();
 
-	std::vector<uint8_t> cidList = m_linkState->GetCidList();
+	const std::vector<uint8_t>& cidList = m_linkState->GetCidList();
 
 	for (uint8_t i = 0; i < cidList.size(); i++)
 	{
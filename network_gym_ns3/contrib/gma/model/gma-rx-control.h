@@ -13,6 +13,9 @@
 #include "mx-control-header.h"
 #include <ns3/integer.h>
 #include "link-state.h"
+#include "gma-rx-policy.h"
+#include "gma-bw-estimator.h"
+#include <array>
 
 namespace ns3 {
 
@@ -60,9 +63,10 @@ public:
   void AddLinkCid (uint8_t cid);
 
   /*
-    configure the link selection method
+    configure the link selection method, the algorithm is the name of a policy in GmaRxPolicyRegistry.
   */
   void SetAlgorithm (std::string algorithm);
+  std::string GetAlgorithm () const;
 
   Ptr<SplittingDecision> GetTrafficSplittingDecision (Ptr<RxMeasurement> measurement);
   Ptr<SplittingDecision> GetTrafficSplittingDecision (Ptr<RlAction> action);
@@ -92,29 +96,53 @@ public:
     RlSplit = 3,      // use reinforcement learning for action.
     QosSteer = 4,  // use qos steering mode.
     gma = 5,          // select link with lower delay, same as Delay.
+    Policy = 6,       // a policy added to GmaRxPolicyRegistry, selected by name with SetAlgorithm.
   };
+  void SetAlgorithmType (enum GmaRxAlgorithm algorithm);
+  enum GmaRxAlgorithm GetAlgorithmType () const;
+  static std::string GetAlgorithmName (enum GmaRxAlgorithm algorithm);
+
+  //for the policies in GmaRxPolicyRegistry.
+  Ptr<LinkState> GetLinkState () const;
+  const std::vector<uint8_t>& GetLastSplittingIndexList () const; //the split of the last decision that updated the split.
+  //set the split and the splitting burst, e.g., to replay a recorded decision. The adaptive splitting burst is not changed.
+  void RestoreSplit (const std::vector<uint8_t>& splitIndexList, uint8_t splittingBurst);
   const double PKT_NUM_WEIGHT = 0.8; //the estimated pkt n = last interval pkt * PKT_NUM_WEIGHT. In the future, we need prediction.
   double m_qosDelayViolationTarget = 1.0;
   double m_qosLossTarget = 1.0;
+  static const uint8_t MAX_LINKS = 16; //max number of links of a decision, the per link arrays of a decision are allocated on the stack.
   int GetMinSplittingBurst ();//for adaptive splitting burst
   int GetMaxSplittingBurst ();//for adaptive splitting burst
   int GetMeasurementBurstRequirement ();
+  double GetBwEstimate (uint8_t cid); //estimated bandwidth of the link (packets/s), return -1 if no estimate.
   uint32_t GetQueueingDelayTargetMs();
   void SetQosTarget(double delayTarget, double lossTarge);
 
 private:
+  //policies of the built-in algorithms, they run the algorithm methods below.
+  class DelayPolicy;
+  class CongDelayPolicy;
+  class NoUpdatePolicy;
+  class QosSteerPolicy;
+  static GmaRxPolicyRegistry::Registrar m_builtinPolicyList[];
 
   Ptr<SplittingDecision> CongDelayAlgorithm (Ptr<RxMeasurement> measurement);
 
   Ptr<SplittingDecision> DelayAlgorithm (Ptr<RxMeasurement> measurement, bool useMinOwd = false);
+  //the delay algorithm specialized for the stable, loss and adaptive step flags, so the flags are not checked per link.
+  template <bool STABLE, bool LOSS, bool ADAPTIVE>
+  Ptr<SplittingDecision> DelayKernel (Ptr<RxMeasurement> measurement, bool useMinOwd);
   Ptr<SplittingDecision> DelayViolationAlgorithm (Ptr<RxMeasurement> measurement);
 
   Ptr<SplittingDecision> QosSteerAlgorithm (Ptr<RxMeasurement> measurement);
+  void UpdateBwEstimate (Ptr<RxMeasurement> measurement);
 
   //Ptr<RxCtrlParams> DelayAndCongestionAlgorithm (Ptr<RxMeasurement> measurement);
 
 
   enum GmaRxAlgorithm m_algorithm = GmaRxAlgorithm::Delay;
+  std::string m_algorithmName;
+  Ptr<GmaRxPolicy> m_policy;
   uint8_t m_splittingBurst = 32;
   std::vector<uint8_t> m_lastSplittingIndexList;
   std::vector<double> m_lastRatio;
@@ -152,8 +180,9 @@ private:
   int minSplitAdjustmentStep = 1; //we compute m_relocateScaler = minSplitAdjustmentStep/m_splittingBurst;
   bool m_enableBwEstimate = true;
   uint32_t m_bwHistSize = 10; //track the n(i) for the past 10 intervals.
-  std::map< uint8_t, std::vector<double> > m_cidToBwHistMap; // the key is the cid of the link and the value is the history of past bandwidth (packets/s) n(i)/interval_duration measurement.
-  std::map< uint8_t, std::vector<uint32_t> > m_cidToKiHistMap; // the key is the cid of the link and the value is the history of past k(i), make sure it is the same size as m_cidToBwHistMap.
+  enum GmaBwEstimator::Mode m_bwEstimatorMode = GmaBwEstimator::WINDOW;
+  double m_bwEwmaAlpha = 0.25;
+  std::vector<GmaBwEstimator> m_bwEstimatorList; //indexed by the link index of the cid, the history of past bandwidth (packets/s) n(i)/interval_duration and k(i).
 
   bool m_flowActive = false; //true if a flow is actively sending data
   double m_updateThreshold; //if the traffic splitting ratio update is smaller than this threshold, we do not send tsu.
@@ -0,0 +1,67 @@
+/* Copyright(C) 2024 Intel Corporation
+*  SPDX-License-Identifier: GPL-2.0
+*  https://spdx.org/licenses/GPL-2.0.html
+*/
+
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+
+#include "gma-rx-policy.h"
+#include "ns3/fatal-error.h"
+
+namespace ns3 {
+
+GmaRxPolicy::~GmaRxPolicy ()
+{
+}
+
+GmaRxPolicyRegistry::Registrar::Registrar (std::string name, Creator creator)
+{
+  GmaRxPolicyRegistry::Register (name, creator);
+}
+
+std::map<std::string, GmaRxPolicyRegistry::Creator>&
+GmaRxPolicyRegistry::GetCreatorMap ()
+{
+  //constructed on first use, the policies are registered during static initialization.
+  static std::map<std::string, Creator> creatorMap;
+  return creatorMap;
+}
+
+void
+GmaRxPolicyRegistry::Register (std::string name, Creator creator)
+{
+  if (!GetCreatorMap ().insert (std::make_pair (name, creator)).second)
+  {
+    NS_FATAL_ERROR ("rx splitting policy " << name << " is already registered");
+  }
+}
+
+bool
+GmaRxPolicyRegistry::Contains (std::string name)
+{
+  return GetCreatorMap ().find (name) != GetCreatorMap ().end ();
+}
+
+Ptr<GmaRxPolicy>
+GmaRxPolicyRegistry::CreatePolicy (std::string name)
+{
+  auto iter = GetCreatorMap ().find (name);
+  if (iter == GetCreatorMap ().end ())
+  {
+    NS_FATAL_ERROR ("rx splitting policy " << name << " is not registered");
+  }
+  return iter->second ();
+}
+
+std::vector<std::string>
+GmaRxPolicyRegistry::GetNameList ()
+{
+  std::vector<std::string> nameList;
+  for (auto iter = GetCreatorMap ().begin (); iter != GetCreatorMap ().end (); ++iter)
+  {
+    nameList.push_back (iter->first);
+  }
+  return nameList;
+}
+
+}
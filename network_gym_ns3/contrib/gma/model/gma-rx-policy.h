@@ -0,0 +1,68 @@
+/* Copyright(C) 2024 Intel Corporation
+*  SPDX-License-Identifier: GPL-2.0
+*  https://spdx.org/licenses/GPL-2.0.html
+*/
+
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+#ifndef GMA_RX_POLICY_H
+#define GMA_RX_POLICY_H
+
+#include "ns3/simple-ref-count.h"
+#include "ns3/ptr.h"
+#include <map>
+#include <string>
+#include <vector>
+
+namespace ns3 {
+
+class GmaRxControl;
+struct RxMeasurement;
+struct SplittingDecision;
+
+//receiver side traffic splitting policy. Each GmaRxControl creates its own policy object, so a policy may keep per flow
+//state. The split of the last decision that updates the split is stored by the GmaRxControl, e.g., for the link down tsu.
+class GmaRxPolicy : public SimpleRefCount<GmaRxPolicy>
+{
+public:
+  virtual ~GmaRxPolicy ();
+  virtual Ptr<SplittingDecision> GetDecision (GmaRxControl& rxControl, Ptr<RxMeasurement> measurement) = 0;
+};
+
+//registry of the splitting policies, the key is the algorithm name of GmaRxControl::SetAlgorithm. A new policy is added
+//with GMA_RX_POLICY_REGISTER in its own translation unit, without changing the GmaRxControl.
+class GmaRxPolicyRegistry
+{
+public:
+  typedef Ptr<GmaRxPolicy> (*Creator) (void);
+
+  //registers the policies of a translation unit during static initialization.
+  class Registrar
+  {
+  public:
+    Registrar (std::string name, Creator creator);
+  };
+
+  static void Register (std::string name, Creator creator);
+  static bool Contains (std::string name);
+  static Ptr<GmaRxPolicy> CreatePolicy (std::string name);
+  static std::vector<std::string> GetNameList ();
+
+  template <typename T>
+  static Ptr<GmaRxPolicy> MakePolicy ();
+private:
+  static std::map<std::string, Creator>& GetCreatorMap ();
+};
+
+template <typename T>
+Ptr<GmaRxPolicy>
+GmaRxPolicyRegistry::MakePolicy ()
+{
+  return Ptr<GmaRxPolicy> (new T (), false);
+}
+
+#define GMA_RX_POLICY_REGISTER(name, type) \
+  static ns3::GmaRxPolicyRegistry::Registrar g_gmaRxPolicyRegistrar##type (name, &ns3::GmaRxPolicyRegistry::MakePolicy<type>)
+
+}
+
+#endif /* GMA_RX_POLICY_H */
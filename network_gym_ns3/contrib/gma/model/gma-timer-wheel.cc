@@ -0,0 +1,285 @@
+/* Copyright(C) 2024 Intel Corporation
+*  SPDX-License-Identifier: GPL-2.0
+*  https://spdx.org/licenses/GPL-2.0.html
+*/
+
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+
+#include "gma-timer-wheel.h"
+#include "ns3/log.h"
+#include <algorithm>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("GmaTimerWheel");
+
+void
+GmaTimerWheel::TimerId::Cancel ()
+{
+  if (m_event)
+  {
+    m_event->Cancel ();
+  }
+}
+
+bool
+GmaTimerWheel::TimerId::IsRunning () const
+{
+  return m_event && !m_event->IsCancelled ();
+}
+
+bool
+GmaTimerWheel::TimerId::IsExpired () const
+{
+  return !IsRunning ();
+}
+
+Time
+GmaTimerWheel::TimerId::GetTs () const
+{
+  return m_ts;
+}
+
+GmaTimerWheel::GmaTimerWheel (Time tick)
+{
+  NS_ASSERT_MSG (tick.IsStrictlyPositive (), "the tick must be positive");
+  m_tickSteps = tick.GetTimeStep ();
+  m_occupied.fill (0);
+}
+
+GmaTimerWheel::~GmaTimerWheel ()
+{
+  m_wakeupEvent.Cancel ();
+}
+
+Ptr<GmaTimerWheel>&
+GmaTimerWheel::GetInstance ()
+{
+  static Ptr<GmaTimerWheel> instance;
+  return instance;
+}
+
+void
+GmaTimerWheel::DestroyInstance ()
+{
+  Ptr<GmaTimerWheel>& instance = GetInstance ();
+  if (instance)
+  {
+    instance->Clear ();
+    instance = nullptr;
+  }
+}
+
+Ptr<GmaTimerWheel>
+GmaTimerWheel::Get ()
+{
+  Ptr<GmaTimerWheel>& instance = GetInstance ();
+  if (!instance)
+  {
+    instance = Create<GmaTimerWheel> ();
+    Simulator::ScheduleDestroy (&GmaTimerWheel::DestroyInstance);
+  }
+  return instance;
+}
+
+GmaTimerWheel::TimerId
+GmaTimerWheel::Schedule (const Time& delay, EventImpl* event)
+{
+  NS_ASSERT_MSG (!delay.IsStrictlyNegative (), "the delay must not be negative");
+  Ptr<EventImpl> ev = Ptr<EventImpl> (event, false);
+  int64_t nowSteps = Simulator::Now ().GetTimeStep ();
+
+  //the ticks before now are already processed by the wakeup event, catch up with them (no timer fires here).
+  uint64_t nowTick = (nowSteps + m_tickSteps - 1) / m_tickSteps;
+  if (nowTick > 0)
+  {
+    Advance (nowTick - 1);
+  }
+
+  uint64_t tick = (nowSteps + delay.GetTimeStep () + m_tickSteps - 1) / m_tickSteps;
+  tick = std::max (tick, m_currentTick + 1);
+  Insert (tick, ev);
+  m_size++;
+  UpdateWakeup ();
+
+  TimerId id;
+  id.m_event = ev;
+  id.m_ts = TimeStep (tick * m_tickSteps);
+  return id;
+}
+
+Time
+GmaTimerWheel::GetTickTime (Time t) const
+{
+  return TimeStep ((t.GetTimeStep () + m_tickSteps - 1) / m_tickSteps * m_tickSteps);
+}
+
+uint32_t
+GmaTimerWheel::GetSize () const
+{
+  return m_size;
+}
+
+void
+GmaTimerWheel::Clear ()
+{
+  m_wakeupEvent.Cancel ();
+  m_wakeupTick = UINT64_MAX;
+  for (uint32_t level = 0; level < NUM_LEVELS; level++)
+  {
+    for (uint32_t slot = 0; slot < NUM_SLOTS; slot++)
+    {
+      m_slotList[level][slot].clear ();
+    }
+  }
+  m_occupied.fill (0);
+  m_size = 0;
+}
+
+void
+GmaTimerWheel::Insert (uint64_t tick, Ptr<EventImpl> event)
+{
+  //a timer that expires within NUM_SLOTS^(level+1) ticks is stored at that level, the slot is selected by
+  //the level's bits of the expire tick. Timers beyond the top level are stored in the farthest top level slot
+  //and inserted again when it is cascaded.
+  tick = std::max (tick, m_currentTick);
+  uint64_t delta = tick - m_currentTick;
+  uint32_t level = 0;
+  uint64_t slotTick = tick;
+  while (level < NUM_LEVELS - 1 && delta >= (1ULL << (SLOT_BITS * (level + 1))))
+  {
+    level++;
+  }
+  if (delta >= (1ULL << (SLOT_BITS * NUM_LEVELS)))
+  {
+    slotTick = m_currentTick + (1ULL << (SLOT_BITS * NUM_LEVELS)) - 1;
+  }
+  uint32_t slot = (slotTick >> (SLOT_BITS * level)) & (NUM_SLOTS - 1);
+  Entry entry;
+  entry.m_tick = tick;
+  entry.m_event = event;
+  m_slotList[level][slot].push_back (entry);
+  m_occupied[level] |= 1ULL << slot;
+}
+
+static uint64_t
+RotateRight (uint64_t x, uint32_t n)
+{
+  n &= 63;
+  return (x >> n) | (x << ((64 - n) & 63));
+}
+
+bool
+GmaTimerWheel::GetNextTick (uint64_t& tick) const
+{
+  bool found = false;
+  tick = UINT64_MAX;
+  for (uint32_t level = 0; level < NUM_LEVELS; level++)
+  {
+    if (m_occupied[level] == 0)
+    {
+      continue;
+    }
+    //slot i of this level is reached at the first tick after the current one whose level bits equal i.
+    uint32_t shift = SLOT_BITS * level;
+    uint64_t base = (m_currentTick >> shift) + 1;
+    uint64_t distance = __builtin_ctzll (RotateRight (m_occupied[level], base & (NUM_SLOTS - 1)));
+    uint64_t levelTick = (base + distance) << shift;
+    tick = std::min (tick, levelTick);
+    found = true;
+  }
+  return found;
+}
+
+void
+GmaTimerWheel::Cascade (uint32_t level, uint32_t slot)
+{
+  std::vector<Entry> entryList;
+  entryList.swap (m_slotList[level][slot]);
+  m_occupied[level] &= ~(1ULL << slot);
+  for (uint32_t i = 0; i < entryList.size (); i++)
+  {
+    if (entryList[i].m_event->IsCancelled ())
+    {
+      m_size--;
+      continue;
+    }
+    Insert (entryList[i].m_tick, entryList[i].m_event);
+  }
+}
+
+void
+GmaTimerWheel::Advance (uint64_t tick)
+{
+  while (m_currentTick < tick)
+  {
+    uint64_t nextTick;
+    if (!GetNextTick (nextTick) || nextTick > tick)
+    {
+      //nothing to do until tick.
+      m_currentTick = tick;
+      break;
+    }
+    m_currentTick = nextTick;
+
+    //cascade from the top level, a timer may move down more than one level.
+    for (uint32_t level = NUM_LEVELS - 1; level > 0; level--)
+    {
+      uint32_t shift = SLOT_BITS * level;
+      if ((nextTick & ((1ULL << shift) - 1)) == 0)
+      {
+        uint32_t slot = (nextTick >> shift) & (NUM_SLOTS - 1);
+        if (m_occupied[level] & (1ULL << slot))
+        {
+          Cascade (level, slot);
+        }
+      }
+    }
+
+    uint32_t slot = nextTick & (NUM_SLOTS - 1);
+    if ((m_occupied[0] & (1ULL << slot)) == 0)
+    {
+      continue;
+    }
+    //the timers may schedule new timers, they never expire in the current tick.
+    m_firingList.swap (m_slotList[0][slot]);
+    m_occupied[0] &= ~(1ULL << slot);
+    for (uint32_t i = 0; i < m_firingList.size (); i++)
+    {
+      m_size--;
+      m_firingList[i].m_event->Invoke (); //does nothing if the timer is canceled.
+      m_firingList[i].m_event->Cancel (); //mark the timer as expired.
+    }
+    m_firingList.clear ();
+  }
+}
+
+void
+GmaTimerWheel::Wakeup ()
+{
+  m_wakeupTick = UINT64_MAX;
+  Advance (Simulator::Now ().GetTimeStep () / m_tickSteps);
+  UpdateWakeup ();
+}
+
+void
+GmaTimerWheel::UpdateWakeup ()
+{
+  uint64_t nextTick;
+  if (!GetNextTick (nextTick))
+  {
+    m_wakeupEvent.Cancel ();
+    m_wakeupTick = UINT64_MAX;
+    return;
+  }
+  if (m_wakeupTick <= nextTick)
+  {
+    //the wakeup event is already scheduled early enough.
+    return;
+  }
+  m_wakeupEvent.Cancel ();
+  m_wakeupTick = nextTick;
+  m_wakeupEvent = Simulator::Schedule (TimeStep (nextTick * m_tickSteps) - Simulator::Now (), &GmaTimerWheel::Wakeup, this);
+}
+
+}
@@ -0,0 +1,91 @@
+/* Copyright(C) 2024 Intel Corporation
+*  SPDX-License-Identifier: GPL-2.0
+*  https://spdx.org/licenses/GPL-2.0.html
+*/
+
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+#ifndef GMA_TIMER_WHEEL_H
+#define GMA_TIMER_WHEEL_H
+
+#include "ns3/simple-ref-count.h"
+#include "ns3/simulator.h"
+#include "ns3/make-event.h"
+#include <stdint.h>
+#include <array>
+#include <vector>
+
+namespace ns3 {
+
+//hierarchical timer wheel shared by all gma interfaces, e.g., for the probe, control msg retx, reordering timeout and qos
+//testing timers. Timers are rounded up to the tick (1 ms) and stored in 3 levels of 64 slots (64 ms, 4 s and 262 s), a
+//level is cascaded into the lower level when the lower level wraps. Only one ns-3 event is scheduled, at the next tick
+//that has a timer, so schedule and cancel are O(1) and do not touch the global event queue. A canceled timer stays in its
+//slot until the slot is reached.
+class GmaTimerWheel : public SimpleRefCount<GmaTimerWheel>
+{
+public:
+  //handle of a scheduled timer, the same usage as the EventId of the ns-3 scheduler.
+  class TimerId
+  {
+  public:
+    void Cancel ();
+    bool IsRunning () const; //the timer is scheduled, not canceled and not expired.
+    bool IsExpired () const;
+    Time GetTs () const; //the expire time, rounded up to the tick.
+  private:
+    friend class GmaTimerWheel;
+    Ptr<EventImpl> m_event;
+    Time m_ts;
+  };
+
+  GmaTimerWheel (Time tick = MilliSeconds (1));
+  ~GmaTimerWheel ();
+
+  static Ptr<GmaTimerWheel> Get (); //the wheel shared by all gma interfaces, cleared when the simulator is destroyed.
+
+  template <typename MEM, typename OBJ, typename... Ts>
+  TimerId Schedule (const Time& delay, MEM memPtr, OBJ obj, Ts... args);
+  TimerId Schedule (const Time& delay, EventImpl* event); //takes the ownership of the event.
+
+  Time GetTickTime (Time t) const; //round t up to the tick.
+  uint32_t GetSize () const; //number of stored timers, including the canceled ones that are not removed yet.
+  void Clear ();
+
+  static const uint32_t NUM_LEVELS = 3;
+  static const uint32_t SLOT_BITS = 6;
+  static const uint32_t NUM_SLOTS = 1 << SLOT_BITS;
+private:
+  struct Entry
+  {
+    uint64_t m_tick; //expire tick.
+    Ptr<EventImpl> m_event;
+  };
+  void Insert (uint64_t tick, Ptr<EventImpl> event);
+  void Advance (uint64_t tick); //process all ticks up to tick (included).
+  bool GetNextTick (uint64_t& tick) const; //the next tick that fires or cascades timers, return false if the wheel is empty.
+  void Cascade (uint32_t level, uint32_t slot);
+  void Wakeup ();
+  void UpdateWakeup ();
+  static Ptr<GmaTimerWheel>& GetInstance ();
+  static void DestroyInstance ();
+
+  int64_t m_tickSteps; //tick length in time steps.
+  uint64_t m_currentTick = 0; //all ticks up to this one are processed.
+  std::array<std::array<std::vector<Entry>, NUM_SLOTS>, NUM_LEVELS> m_slotList;
+  std::array<uint64_t, NUM_LEVELS> m_occupied; //bit i is set if slot i of the level is not empty.
+  std::vector<Entry> m_firingList; //entries of the tick being processed.
+  uint32_t m_size = 0;
+  EventId m_wakeupEvent;
+  uint64_t m_wakeupTick = UINT64_MAX;
+};
+
+template <typename MEM, typename OBJ, typename... Ts>
+GmaTimerWheel::TimerId
+GmaTimerWheel::Schedule (const Time& delay, MEM memPtr, OBJ obj, Ts... args)
+{
+  return Schedule (delay, MakeEvent (memPtr, obj, args...));
+}
+
+}
+
+#endif /* GMA_TIMER_WHEEL_H */
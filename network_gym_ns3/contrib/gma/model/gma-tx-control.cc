@@ -6,25 +6,9 @@
 /* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
 
 #include "gma-tx-control.h"
-#include <random>       // std::default_random_engine
 
 namespace ns3 {
 
-static const int REVERSE_BITS_INDEX4[4] = {0, 2, 1, 3}; //reversed index for 4 bits
-static const int REVERSE_BITS_INDEX8[8] = {0, 4, 2, 6, 1, 5, 3, 7}; //reversed index for 8 bits
-static const int REVERSE_BITS_INDEX16[16] = {0,  8,  4, 12,  2, 10,  6, 14,  1,  9,  5, 13,  3, 11,  7, 15}; //reversed index for 16 bits
-static const int REVERSE_BITS_INDEX32[32] = {0, 16,  8, 24,  4, 20, 12, 28,  2, 18, 10, 26,  6, 22, 14, 30,
-  1, 17, 9, 25,  5, 21, 13, 29,  3, 19, 11, 27,  7, 23, 15, 31}; //reversed index for 32 bits
-static const int REVERSE_BITS_INDEX64[64] = {0, 32, 16, 48, 8, 40, 24, 56, 4, 36, 20, 52, 12, 44, 28, 60,
- 2, 34, 18, 50, 10, 42, 26, 58, 6, 38, 22, 54, 14, 46, 30, 62,
-  1, 33, 17, 49, 9, 41, 25, 57, 5, 37, 21, 53, 13, 45, 29, 61,
-   3, 35, 19, 51, 11, 43, 27, 59, 7, 39, 23, 55, 15, 47, 31, 63};
-static const int REVERSE_BITS_INDEX128[128] = {0, 64, 32, 96, 16, 80, 48, 112, 8, 72, 40, 104, 24, 88, 56, 120, 4, 68, 36, 100, 20, 84, 52, 116, 12, 76, 44, 108, 28, 92, 60, 124,
- 2, 66, 34, 98, 18, 82, 50, 114, 10, 74, 42, 106, 26, 90, 58, 122, 6, 70, 38, 102, 22, 86, 54, 118, 14, 78, 46, 110, 30, 94, 62, 126,
-  1, 65, 33, 97, 17, 81, 49, 113, 9, 73, 41, 105, 25, 89, 57, 121, 5, 69, 37, 101, 21, 85, 53, 117, 13, 77, 45, 109, 29, 93, 61, 125,
-   3, 67, 35, 99, 19, 83, 51, 115, 11, 75, 43, 107, 27, 91, 59, 123, 7, 71, 39, 103, 23, 87, 55, 119, 15, 79, 47, 111, 31, 95, 63, 127}; //reversed index for 128 bits
-
-
 NS_LOG_COMPONENT_DEFINE ("GmaTxControl");
 
 NS_OBJECT_ENSURE_REGISTERED (GmaTxControl);
@@ -119,17 +103,53 @@ GmaTxControl::GetNextCidFromTsu ()
 	}
 	else
 	{
-		//use reverse bit index to randomize the splitting process.
-		uint8_t connectionId = m_cidVector.at(m_splittingIndex);
+		return NextScheduledCid();
+	}
+	
+}
 
-		m_splittingIndex++;
-		if(m_splittingIndex >= m_paramL)
+uint8_t
+GmaTxControl::NextScheduledCid ()
+{
+	//the schedule is compiled when the tsu is received, one index increment per packet.
+	uint8_t connectionId = m_cidVector[m_splittingIndex];
+	m_splittingIndex++;
+	if(m_splittingIndex >= m_cidVector.size())
+	{
+		m_splittingIndex = 0;
+	}
+	return connectionId;
+}
+
+std::vector<uint8_t>
+GmaTxControl::CompileSplitSchedule (const std::vector<uint8_t>& splitIndexList, const std::vector<uint8_t>& cidList)
+{
+	//smooth weighted round robin: in each round every link gains its weight (k) as credit, the link with the
+	//highest credit is scheduled and pays the total weight (L). The slots of each link are spread evenly over
+	//the L rounds instead of being sent as a burst, which reduces the reordering at the receiver.
+	std::vector<uint8_t> schedule;
+	int totalWeight = 0;
+	for (uint8_t link = 0; link < splitIndexList.size(); link++)
+	{
+		totalWeight += splitIndexList[link];
+	}
+	schedule.reserve(totalWeight);
+	std::vector<int> credit(splitIndexList.size(), 0);
+	for (int slot = 0; slot < totalWeight; slot++)
+	{
+		uint8_t best = 0;
+		for (uint8_t link = 0; link < splitIndexList.size(); link++)
 		{
-			m_splittingIndex = 0;
+			credit[link] += splitIndexList[link];
+			if(credit[link] > credit[best])
+			{
+				best = link;
+			}
 		}
-		return connectionId;
+		credit[best] -= totalWeight;
+		schedule.push_back(cidList.at(best));
 	}
-	
+	return schedule;
 }
 
 uint8_t
@@ -156,14 +176,7 @@ GmaTxControl::RxSideAlgorithm ()
 		//todo if a link is down, we need allocate the traffic to other links.
 		//if the traffic is already splitting, we skip the link that is down!!
 
-		//use reverse bit index to randomize the splitting process.
-		uint8_t connectionId = m_cidVector.at(m_splittingIndex);
-
-		m_splittingIndex++;
-		if(m_splittingIndex >= m_paramL)
-		{
-			m_splittingIndex = 0;
-		}
+		uint8_t connectionId = NextScheduledCid();
 
 		if(m_linkState->IsLinkUp(connectionId))
 		{
@@ -188,7 +201,7 @@ GmaTxControl::RcvCtrlMsg (const MxControlHeader& mxHeader)
 		m_paramL = mxHeader.GetL();
 
 		std::vector<uint8_t> inorderCidVector;
-		std::vector<uint8_t> cidList = m_linkState->GetCidList();
+		const std::vector<uint8_t>& cidList = m_linkState->GetCidList();
 		for (uint8_t link = 0; link < splitIndexList.size(); link++)
 		{
 			for(uint8_t ind = 0; ind < splitIndexList.at(link); ind++)
@@ -243,34 +256,13 @@ GmaTxControl::RcvCtrlMsg (const MxControlHeader& mxHeader)
 			m_cidDupVector.clear();
 		}
 
-		//apply reverse index;
-		for (uint8_t index = 0; index<inorderCidVector.size(); index++)
+		if (m_paramL != 1)//split mode
 		{
-			if(m_paramL == 4)
-			{
-				m_cidVector.push_back(inorderCidVector.at(REVERSE_BITS_INDEX4[index]));
-			}
-			else if(m_paramL == 8)
-			{
-				m_cidVector.push_back(inorderCidVector.at(REVERSE_BITS_INDEX8[index]));
-			}
-			else if(m_paramL == 16)
-			{
-				m_cidVector.push_back(inorderCidVector.at(REVERSE_BITS_INDEX16[index]));
-			}
-			else if(m_paramL == 32)
-			{
-				m_cidVector.push_back(inorderCidVector.at(REVERSE_BITS_INDEX32[index]));
-			}
-			else if(m_paramL == 64)
-			{
-				m_cidVector.push_back(inorderCidVector.at(REVERSE_BITS_INDEX64[index]));
-			}
-			else if(m_paramL == 128)
-			{
-				m_cidVector.push_back(inorderCidVector.at(REVERSE_BITS_INDEX128[index]));
-			}
-			else if(m_paramL == 1)//steer mode
+			m_cidVector = CompileSplitSchedule(splitIndexList, cidList);
+		}
+		else//steer mode
+		{
+			for (uint8_t index = 0; index<inorderCidVector.size(); index++)
 			{
 				if(m_cidVector.size() == 0)
 				{
@@ -285,11 +277,6 @@ GmaTxControl::RcvCtrlMsg (const MxControlHeader& mxHeader)
 						m_cidDupVector.push_back(inorderCidVector.at(index));
 					}
 				}
-				
-			}
-			else
-			{
-				NS_FATAL_ERROR("other size not implemented");
 			}
 		}
 		/*std::cout << "transmit order:";
@@ -43,6 +43,8 @@ public:
   void RcvCtrlMsg (const MxControlHeader& header);
   void SetQosSteerEnabled (bool flag);
   bool QosSteerEnabled ();
+  //compile the k vector of a tsu into the cid of each of the L packets of a splitting burst (smooth weighted round robin).
+  static std::vector<uint8_t> CompileSplitSchedule (const std::vector<uint8_t>& splitIndexList, const std::vector<uint8_t>& cidList);
   enum GmaTxAlgorithm
   {
     TxSide = 0,     //traffic splitting control based on infomation only from TX side, not implemented yet
@@ -53,10 +55,11 @@ public:
 private:
 
   uint8_t RxSideAlgorithm ();
+  uint8_t NextScheduledCid (); //read the next cid from m_cidVector, m_cidVector must not be empty.
 
   enum GmaTxAlgorithm m_algorithm = GmaTxAlgorithm::RxSide;
 
-  std::vector<uint8_t> m_cidVector;
+  std::vector<uint8_t> m_cidVector; //the cid of each packet in a splitting burst, compiled when a tsu is received.
   std::vector<uint8_t> m_cidDupVector; //the cid list for duplicated packets, only used in steer mode.
 
   uint8_t m_paramL = 0;
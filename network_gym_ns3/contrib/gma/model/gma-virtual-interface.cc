@@ -7,6 +7,7 @@
 
 #include "gma-virtual-interface.h"
 #include "ns3/mobility-module.h"
+#include "ns3/report-writer.h"
 #include <iomanip>
 namespace ns3 {
 
@@ -19,18 +20,17 @@ GmaVirtualInterface::GmaVirtualInterface (Time startTime)
 {
 	NS_LOG_FUNCTION (this);
 	m_linkState = CreateObject<LinkState>();
+	m_cidTable = m_linkState->GetCidTable();
 	m_gmaRxControl = CreateObject<GmaRxControl> ();
 	m_gmaRxControl->SetLinkState(m_linkState);
 	m_forwardPacketCallback = MakeNullCallback<void, Ptr<Packet> > ();
-	m_reorderingTimeoutEvent.Cancel();
-	m_stopReorderEvent.Cancel();
-	m_periodicProbeEvent.Cancel();
+	m_timerWheel = GmaTimerWheel::Get();
 	m_ctrRto = INITIAL_CONTROL_RTO;
 
 	m_gmaTxControl = CreateObject<GmaTxControl> ();
 	m_gmaTxControl->SetLinkState(m_linkState);
 
-    m_periodicProbeEvent = Simulator::Schedule(startTime, &GmaVirtualInterface::PeriodicProbeMsg, this);//start probe at different time for each instance, otherwise may cause problem for wifi...
+    m_periodicProbeEvent = m_timerWheel->Schedule(startTime, &GmaVirtualInterface::PeriodicProbeMsg, this);//start probe at different time for each instance, otherwise may cause problem for wifi...
 
     m_txMode = true;
     m_rxMode = true;
@@ -64,6 +64,17 @@ GmaVirtualInterface::SetGmaDataProcessor(Ptr<GmaDataProcessor> database)
 	}
 }
 
+Ptr<NetworkStats>
+GmaVirtualInterface::CreateNetworkStats (std::string source, uint64_t ts)
+{
+	if (m_gmaDataProcessor)
+	{
+		//the data processor drops unsubscribed measurements before building the json.
+		return m_gmaDataProcessor->CreateNetworkStats(source, m_clientId, ts);
+	}
+	return CreateObject<NetworkStats>(source, m_clientId, ts);
+}
+
 void
 GmaVirtualInterface::ReceiveWifiDlDfpAction (const json& action)
 {
@@ -74,9 +85,9 @@ GmaVirtualInterface::ReceiveWifiDlDfpAction (const json& action)
 	}
 	if (m_gmaRxControl->QosFlowPrioritizationEnabled())
 	{
-		if(m_linkParamsMap.find(WIFI_CID) != m_linkParamsMap.end())
+		if(m_cidTable->Contains(WIFI_CID))
 		{
-			m_linkParamsMap[WIFI_CID]->m_qosMarking = action.get<int>();
+			GetLinkParams(WIFI_CID)->m_qosMarking = action.get<int>();
 		}
 	}
 }
@@ -91,9 +102,9 @@ GmaVirtualInterface::ReceiveLteDlDfpAction (const json& action)
 	}
 	if (m_gmaRxControl->QosFlowPrioritizationEnabled())
 	{
-		if(m_linkParamsMap.find(CELLULAR_LTE_CID) != m_linkParamsMap.end())
+		if(m_cidTable->Contains(CELLULAR_LTE_CID))
 		{
-			m_linkParamsMap[CELLULAR_LTE_CID]->m_qosMarking = action.get<int>();
+			GetLinkParams(CELLULAR_LTE_CID)->m_qosMarking = action.get<int>();
 		}
 	}
 }
@@ -108,9 +119,9 @@ GmaVirtualInterface::ReceiveNrDlDfpAction (const json& action)
 	}
 	if (m_gmaRxControl->QosFlowPrioritizationEnabled())
 	{
-		if(m_linkParamsMap.find(CELLULAR_NR_CID) != m_linkParamsMap.end())
+		if(m_cidTable->Contains(CELLULAR_NR_CID))
 		{
-			m_linkParamsMap[CELLULAR_NR_CID]->m_qosMarking = action.get<int>();
+			GetLinkParams(CELLULAR_NR_CID)->m_qosMarking = action.get<int>();
 		}
 	}
 }
@@ -306,6 +317,14 @@ GmaVirtualInterface::SetId (Ptr<Node> node, uint32_t nodeId, uint16_t InterfaceI
 	m_node = node;
 	m_linkState->SetId(m_nodeId);
 	Simulator::Schedule(m_measurementGuardInterval, &GmaVirtualInterface::MeasurementGuardIntervalEnd, this);
+	if(!m_packetTraceFile.empty())
+	{
+		std::ostringstream fileName;
+		fileName << m_packetTraceFile << "-node-" << m_nodeId << "-interface-" << +m_gmaInterfaceId << ".bin";
+		m_packetTrace = Create<GmaPacketTrace>();
+		m_packetTrace->Open(fileName.str());
+		Simulator::ScheduleDestroy(&GmaPacketTrace::Close, m_packetTrace);
+	}
 }
 
 void
@@ -366,6 +385,16 @@ GmaVirtualInterface::GetTypeId (void)
                    TimeValue(Seconds(0.0)),
                    MakeTimeAccessor (&GmaVirtualInterface::m_measurementGuardInterval),
                    MakeTimeChecker ())
+	.AddAttribute ("PacketTraceFile",
+                   "If not empty, write the per packet trace of each interface to <PacketTraceFile>-node-<id>-interface-<id>.bin",
+                   StringValue (""),
+                   MakeStringAccessor (&GmaVirtualInterface::m_packetTraceFile),
+                   MakeStringChecker ())
+	.AddAttribute ("DecisionTraceFile",
+                   "If not empty, write the rx measurements and splitting decisions of each interface to <DecisionTraceFile>-node-<id>-interface-<id>.bin",
+                   StringValue (""),
+                   MakeStringAccessor (&GmaVirtualInterface::m_decisionTraceFile),
+                   MakeStringChecker ())
   ;
   return tid;
 }
@@ -374,7 +403,7 @@ void
 GmaVirtualInterface::AddPhyLink(Ptr<Socket> socket, const Ipv4Address& phyAddr, uint8_t cid, int apId)
 {
 	//std::cout << Now().GetSeconds() << " addr: " << phyAddr  << "  cid: " << +cid << " apid:" << apId<< "\n";
-	if(m_linkParamsMap.find(cid) == m_linkParamsMap.end())
+	if(!m_cidTable->Contains(cid))
 	{
 		Ptr<LinkParams> linkParams = Create<LinkParams>();
 		linkParams->m_phyAccessContrl = CreateObject<PhyAccessControl>();
@@ -382,8 +411,9 @@ GmaVirtualInterface::AddPhyLink(Ptr<Socket> socket, const Ipv4Address& phyAddr,
 		linkParams->m_phyAccessContrl->SetPortNum(START_PORT_NUM+cid);
 		linkParams->m_phyAccessContrl->SetIp(phyAddr);
 		linkParams->m_phyAccessContrl->SetApId(apId);
+		linkParams->m_txGmaHeader.SetConnectionId(cid); // later I might remove this since the CID may be referenced from port number
 
-		m_linkParamsMap[cid] = linkParams;
+		AddLinkParams(cid, linkParams);
 		m_linkState->AddLinkCid(cid);
 		if (m_linkState->GetHighPriorityLinkCid() != cid)//not high priority link
 		{
@@ -394,16 +424,16 @@ GmaVirtualInterface::AddPhyLink(Ptr<Socket> socket, const Ipv4Address& phyAddr,
 	else
 	{
 		//this link already exist
-		if(m_linkParamsMap[cid]->m_phyAccessContrl->GetIp() != phyAddr)
+		if(GetLinkParams(cid)->m_phyAccessContrl->GetIp() != phyAddr)
 		{
-			//std::cout << "AddPhyLink: update ip from " << m_linkParamsMap[cid]->m_phyAccessContrl->GetIp() <<" to "<< phyAddr << "\n";
-			m_linkParamsMap[cid]->m_phyAccessContrl->SetSocket(socket);
-			m_linkParamsMap[cid]->m_phyAccessContrl->SetIp(phyAddr, true);//change ip and set link down.
-			m_linkParamsMap[cid]->m_phyAccessContrl->SetApId(apId);
+			//std::cout << "AddPhyLink: update ip from " << GetLinkParams(cid)->m_phyAccessContrl->GetIp() <<" to "<< phyAddr << "\n";
+			GetLinkParams(cid)->m_phyAccessContrl->SetSocket(socket);
+			GetLinkParams(cid)->m_phyAccessContrl->SetIp(phyAddr, true);//change ip and set link down.
+			GetLinkParams(cid)->m_phyAccessContrl->SetApId(apId);
 			m_ctrRto = INITIAL_CONTROL_RTO; //reset rto timer;
 			//IP changed -> Wi-Fi to Wi-Fi handover, we set the control msg failed... Do not use this link until at least one control msg is received from this link.
 			uint8_t oldCid = m_gmaTxControl->GetDeliveryLinkCid();
-			if(m_linkParamsMap[cid]->m_phyAccessContrl->GetLinkDownTime() > Seconds(0))//simulate single radio...
+			if(GetLinkParams(cid)->m_phyAccessContrl->GetLinkDownTime() > Seconds(0))//simulate single radio...
 			{
 				if(m_linkState->CtrlMsgDown(cid))//cid updates
 				{
@@ -428,15 +458,47 @@ GmaVirtualInterface::AddPhyLink(Ptr<Socket> socket, const Ipv4Address& phyAddr,
 
 	if(m_gmaRxControl->QosFlowPrioritizationEnabled())
 	{
-		m_linkParamsMap[cid]->m_qosMarking = 1.0;//enable qos marking by default
+		GetLinkParams(cid)->m_qosMarking = 1.0;//enable qos marking by default
 	}
 
 }
 
+void
+GmaVirtualInterface::AddLinkParams(uint8_t cid, Ptr<LinkParams> linkParams)
+{
+	m_linkParamsMap[cid] = linkParams;
+	uint8_t slot = m_cidTable->Add(cid);
+	if(slot >= m_linkParamsList.size())
+	{
+		m_linkParamsList.resize(slot + 1);
+	}
+	m_linkParamsList[slot] = linkParams;
+}
+
+const Ptr<GmaVirtualInterface::LinkParams>&
+GmaVirtualInterface::GetLinkParams(uint8_t cid)
+{
+	NS_ASSERT_MSG(m_cidTable->Contains(cid), "this cid doesnot exit");
+	return m_linkParamsList[m_cidTable->GetSlot(cid)];
+}
+
+void
+GmaVirtualInterface::ResetMeasureParams()
+{
+	for(uint32_t slot = 0; slot < m_linkParamsList.size(); slot++)
+	{
+		if(m_linkParamsList[slot])
+		{
+			m_linkParamsList[slot]->m_measureParam = MeasureParam();
+		}
+	}
+	m_measuredLinkCount = 0;
+}
+
 void
 GmaVirtualInterface::AddPhyCandidate(Ptr<Socket> socket, const Ipv4Address& phyAddr,  const Mac48Address& macAddr, uint8_t cid, int apId)
 {
-	if(m_linkParamsMap.find(cid) == m_linkParamsMap.end())
+	if(!m_cidTable->Contains(cid))
 	{
 		Ptr<LinkParams> linkParams = Create<LinkParams>();
 		linkParams->m_phyAccessContrl = CreateObject<PhyAccessControl>();
@@ -444,8 +506,9 @@ GmaVirtualInterface::AddPhyCandidate(Ptr<Socket> socket, const Ipv4Address& phyA
 		linkParams->m_phyAccessContrl->SetPortNum(START_PORT_NUM+cid);
 		linkParams->m_phyAccessContrl->SetIp(phyAddr);
 		linkParams->m_phyAccessContrl->SetApId(apId);
+		linkParams->m_txGmaHeader.SetConnectionId(cid); // later I might remove this since the CID may be referenced from port number
 
-		m_linkParamsMap[cid] = linkParams;
+		AddLinkParams(cid, linkParams);
 		m_linkState->AddLinkCid(cid);
 		if (m_linkState->GetHighPriorityLinkCid() != cid)//not high priority link
 		{
@@ -454,7 +517,7 @@ GmaVirtualInterface::AddPhyCandidate(Ptr<Socket> socket, const Ipv4Address& phyA
 		m_measurementManager->AddDevice(cid, m_acceptableDelay);
 	}
 
-	m_linkParamsMap[cid]->m_phyAccessContrl->AddCandidate(socket, phyAddr, macAddr, apId);
+	GetLinkParams(cid)->m_phyAccessContrl->AddCandidate(socket, phyAddr, macAddr, apId);
 
 
 }
@@ -519,8 +582,18 @@ GmaVirtualInterface::ConfigureRxAlgorithm(std::string algorithm, uint8_t splitti
 		m_measurementFactory.SetTypeId("ns3::MeasurementManager");
 	}
 	m_measurementManager = m_measurementFactory.Create()->GetObject<MeasurementManager> ();
+	m_measurementManager->SetCidTable(m_cidTable);
 	m_measurementManager->SetRxControlApp(m_gmaRxControl);
 	m_measurementManager->SetSendTsuCallback (MakeCallback (&GmaVirtualInterface::SendTsu, this));
+	if(!m_decisionTraceFile.empty())
+	{
+		std::ostringstream fileName;
+		fileName << m_decisionTraceFile << "-node-" << m_nodeId << "-interface-" << +m_gmaInterfaceId << ".bin";
+		Ptr<GmaDecisionTrace> decisionTrace = Create<GmaDecisionTrace>();
+		decisionTrace->Open(fileName.str());
+		Simulator::ScheduleDestroy(&GmaDecisionTrace::Close, decisionTrace);
+		m_measurementManager->SetDecisionTrace(decisionTrace);
+	}
 	if(m_rxMode == false)
 	{
 		//disable Prob message and measurement
@@ -566,7 +639,9 @@ GmaVirtualInterface::MeasurementGuardIntervalEnd()
 	m_numOfAbnormalPacketsPerFlow = 0;
 	m_flowParam = Create<MeasureParam>();
 
-	m_measureParamPerCidMap.clear();
+	ResetMeasureParams();
+	m_intervalMinOwd = UINT32_MAX;
+	m_intervalMaxOwd = 0;
 	m_receivedBytes = 0;
 
 	m_reorderingTimeoutCounter = 0;
@@ -580,9 +655,9 @@ GmaVirtualInterface::CollectMeasureResults()
 
 	if (Now() > m_nextReorderingUpdateTime)
 	{
-		//here we compute the rerodering timeout from long measurement, e.g., > 10 seconds
-		uint32_t maxOwd = m_measurementManager->GetMaxOwdMs();
-		uint32_t minOwd = m_measurementManager->GetMinOwdMs();
+		//here we compute the rerodering timeout from long measurement, i.e., the sliding window (OwdWindow) of all links.
+		uint32_t maxOwd = m_measurementManager->GetWindowedMaxOwdMs();
+		uint32_t minOwd = m_measurementManager->GetWindowedMinOwdMs();
 		if(maxOwd!=0 && minOwd!=UINT32_MAX)
 		{
 			//reordering timeout equals 2* (max OWD - min OWD), it is also in the rage of [MIN..., MAX_REORDERING_TIMEOUT]
@@ -594,46 +669,13 @@ GmaVirtualInterface::CollectMeasureResults()
 	}
 
 	//here we compute a reordering timout from a short measurement, if the short measurement has higher rto, we use the short measurement rto.
-	Time newReorderingTimeout = m_reorderingTimeout;
-
-	uint32_t maxOwd = 0;
-	uint32_t minOwd = UINT32_MAX;
-
-	std::map < uint8_t, Ptr<MeasureParam> >::iterator iter = m_measureParamPerCidMap.begin();
-	while(iter!=m_measureParamPerCidMap.end())
-	{
-		if(maxOwd < iter->second->m_maxOwd)
-		{
-			maxOwd = iter->second->m_maxOwd;
-		}
-
-		if(minOwd > iter->second->m_minOwd)
-		{
-			minOwd = iter->second->m_minOwd;
-		}
-		iter++;
-	}
-	if(maxOwd!=0 && minOwd!=UINT32_MAX)
-	{
-		//reordering timeout equals 2* (max OWD - min OWD), it is also in the rage of [MIN..., MAX_REORDERING_TIMEOUT]
-		if(m_measureParamPerCidMap.size() > 1)
-		{
-			newReorderingTimeout = std::max(MIN_REORDERING_TIMEOUT, std::min(MAX_REORDERING_TIMEOUT, MilliSeconds(2*(maxOwd-minOwd))));
-			if(newReorderingTimeout > m_reorderingTimeout)
-			{
-				m_reorderingTimeout = newReorderingTimeout;
-				//update reordering timeout to the bigger one.
-				//std::cout << Now().GetSeconds() << " node: " << m_nodeId << " UPDATE reordering timeout maxOwd:" << maxOwd 
-				//<< "ms, min Owd:" << minOwd << "ms, timeout:" << m_reorderingTimeout.GetMilliSeconds() << "ms@@@@@@@@\n";
-			}
-		}
-
-	}
+	UpdateReorderTimeout();
 
 	if(m_enableMeasureReport)
 	{
 		//std::cout <<"node " << m_nodeId <<" write to measurement report now------------>\n";
-		std::ofstream myfile;
+		std::ostringstream myfile; //the rows of this interval, written to the report file at once.
+		std::string reportFileName;
 		Time timeNow = Simulator::Now ();
 		//uint64_t start_ts = (timeNow-m_measurementInterval).GetMilliSeconds();
 		uint64_t end_ts =  timeNow.GetMilliSeconds();
@@ -659,7 +701,7 @@ GmaVirtualInterface::CollectMeasureResults()
 			{
 				fileName <<"node-"<<m_nodeId<<"-interface-"<<+m_gmaInterfaceId<<".csv";
 			}
-			myfile.open (fileName.str ().c_str (), std::ios::out | std::ios::app);
+			reportFileName = fileName.str ();
 			if(m_fileTile == false)
 			{
 				myfile << "time,\tcid,\tAP,\tpowDbm,\tkbps,\tqosKbps,\trate%,\tminOwd,\taveOwd,\tmaxOwd,\tlossR,\tmissing,\toutOrdr,\tinOrder,\tLate,\ttimeout,\tisReord,\ttsu,\trevTx,\tx,\ty,\tz\n" ;
@@ -679,9 +721,9 @@ GmaVirtualInterface::CollectMeasureResults()
 			directionStr = "ul";
 			revDirectionStr = "dl";
 		}
-		ns3::Ptr<ns3::NetworkStats> element = ns3::CreateObject<ns3::NetworkStats>("gma", m_clientId, end_ts);
-		ns3::Ptr<ns3::NetworkStats> sliceElementSum = ns3::CreateObject<ns3::NetworkStats>("gma", m_clientId, end_ts);
-		ns3::Ptr<ns3::NetworkStats> sliceElementMean = ns3::CreateObject<ns3::NetworkStats>("gma", m_clientId, end_ts);
+		ns3::Ptr<ns3::NetworkStats> element = CreateNetworkStats("gma", end_ts);
+		ns3::Ptr<ns3::NetworkStats> sliceElementSum = CreateNetworkStats("gma", end_ts);
+		ns3::Ptr<ns3::NetworkStats> sliceElementMean = CreateNetworkStats("gma", end_ts);
 
 		uint64_t aveOwd = 0;
 		if(m_flowParam->m_count != 0)
@@ -851,7 +893,7 @@ GmaVirtualInterface::CollectMeasureResults()
 
 				if(cid == WIFI_CID)
 				{
-					uint16_t wifiCellId = m_linkParamsMap[cid]->m_phyAccessContrl->GetApId();
+					uint16_t wifiCellId = GetLinkParams(cid)->m_phyAccessContrl->GetApId();
 					if(wifiCellId == 255)
 					{
 						myfile << "null" << ",\t";
@@ -863,7 +905,7 @@ GmaVirtualInterface::CollectMeasureResults()
 
 					if(m_wifiPowerAvailable)
 					{
-						myfile << std::setprecision(4) << m_linkParamsMap[cid]->m_phyAccessContrl->GetCurrentApRssi() ;
+						myfile << std::setprecision(4) << GetLinkParams(cid)->m_phyAccessContrl->GetCurrentApRssi() ;
 					} 
 					else
 					{
@@ -879,28 +921,28 @@ GmaVirtualInterface::CollectMeasureResults()
 
 
 			std::string cidStr = LinkState::ConvertCidFormat(cid);
-			element->Append(cidStr+"::"+revDirectionStr+"::priority", m_linkParamsMap[cid]->m_qosMarking);
+			element->Append(cidStr+"::"+revDirectionStr+"::priority", GetLinkParams(cid)->m_qosMarking);
 
-			std::map < uint8_t, Ptr<MeasureParam> >::iterator iter = m_measureParamPerCidMap.find(cid);
-			if(iter!=m_measureParamPerCidMap.end())
+			const MeasureParam& measureParam = iterLink->second->m_measureParam;
+			if(measureParam.m_count > 0)
 			{
 				uint64_t linkrate = 0;
 
-				if(iter->second->m_rcvBytes != 0 )
+				if(measureParam.m_rcvBytes != 0 )
 				{
-					linkrate = iter->second->m_rcvBytes/(m_measurementInterval.GetMilliSeconds()) * 8; //kbps
+					linkrate = measureParam.m_rcvBytes/(m_measurementInterval.GetMilliSeconds()) * 8; //kbps
 				}
 
 				double percent = 0;
 				if(m_receivedBytes!=0)
 				{
-					percent = std::round(100.0*iter->second->m_rcvBytes/m_receivedBytes);
+					percent = std::round(100.0*measureParam.m_rcvBytes/m_receivedBytes);
 				}
 
-				uint64_t inOrder = iter->second->m_numOfInOrderPacketsForReport;
-				uint64_t missing = iter->second->m_numOfMissingPacketsForReport;
-				uint64_t abnormal = iter->second->m_numOfAbnormalPacketsForReport;
-				uint64_t highDelay = iter->second->m_numOfHighDelayPkt;
+				uint64_t inOrder = measureParam.m_numOfInOrderPacketsForReport;
+				uint64_t missing = measureParam.m_numOfMissingPacketsForReport;
+				uint64_t abnormal = measureParam.m_numOfAbnormalPacketsForReport;
+				uint64_t highDelay = measureParam.m_numOfHighDelayPkt;
 
 				//double linkDelayVilation = 0;
 
@@ -926,9 +968,9 @@ GmaVirtualInterface::CollectMeasureResults()
 				if(m_saveToFile)
 				{
 					myfile << ",\t" << linkrate << ",\t" << linkrate*flowQosMet << ",\t" << +percent << ",\t" 
-					<< iter->second->m_minOwd << ",\t" 
-					<< iter->second->m_owdSum/iter->second->m_count << ",\t"
-					<< iter->second->m_maxOwd << ",\t";
+					<< measureParam.m_minOwd << ",\t" 
+					<< measureParam.m_owdSum/measureParam.m_count << ",\t"
+					<< measureParam.m_maxOwd << ",\t";
 				}
 
 				std::string cidStr = LinkState::ConvertCidFormat(cid);
@@ -936,18 +978,22 @@ GmaVirtualInterface::CollectMeasureResults()
 				element->Append(cidStr+"::"+directionStr+"::rate", (double)linkrate/1e3);
 				element->Append(cidStr+"::"+directionStr+"::qos_rate", (double)linkrate*flowQosMet/1e3);
 				element->Append(cidStr+"::"+directionStr+"::traffic_ratio", (double)percent);
-				element->Append(cidStr+"::"+directionStr+"::owd", iter->second->m_owdSum/iter->second->m_count);
-				element->Append(cidStr+"::"+directionStr+"::max_owd", iter->second->m_maxOwd);
+				element->Append(cidStr+"::"+directionStr+"::owd", measureParam.m_owdSum/measureParam.m_count);
+				element->Append(cidStr+"::"+directionStr+"::max_owd", measureParam.m_maxOwd);
+				element->Append(cidStr+"::"+directionStr+"::owd_p50", measureParam.m_owdSketch.GetQuantile(0.5));
+				element->Append(cidStr+"::"+directionStr+"::owd_p90", measureParam.m_owdSketch.GetQuantile(0.9));
+				element->Append(cidStr+"::"+directionStr+"::owd_p99", measureParam.m_owdSketch.GetQuantile(0.99));
+				element->Append(cidStr+"::"+directionStr+"::bw_est", m_gmaRxControl->GetBwEstimate(cid));
 
 				if(m_gmaDataProcessor && m_gmaRxControl->QosFlowPrioritizationEnabled())
 				{
 					if(m_clientRoleEnabled)
 					{
-						m_gmaDataProcessor->SaveDlQosMeasurement(m_clientId, (double)linkrate/1e3, m_linkParamsMap[cid]->m_qosMarking, (int)cid);
+						m_gmaDataProcessor->SaveDlQosMeasurement(m_clientId, (double)linkrate/1e3, GetLinkParams(cid)->m_qosMarking, (int)cid);
 					}
 					else if(m_serverRoleEnabled)
 					{
-						m_gmaDataProcessor->SaveUlQosMeasurement(m_clientId, (double)linkrate/1e3, m_linkParamsMap[cid]->m_qosMarking, (int)cid);
+						m_gmaDataProcessor->SaveUlQosMeasurement(m_clientId, (double)linkrate/1e3, GetLinkParams(cid)->m_qosMarking, (int)cid);
 					}
 				}
 				if(m_saveToFile)
@@ -964,16 +1010,20 @@ GmaVirtualInterface::CollectMeasureResults()
 				element->Append(cidStr+"::"+directionStr+"::traffic_ratio", 0.0);
 				element->Append(cidStr+"::"+directionStr+"::owd", -1.0);
 				element->Append(cidStr+"::"+directionStr+"::max_owd", -1.0);
+				element->Append(cidStr+"::"+directionStr+"::owd_p50", -1.0);
+				element->Append(cidStr+"::"+directionStr+"::owd_p90", -1.0);
+				element->Append(cidStr+"::"+directionStr+"::owd_p99", -1.0);
+				element->Append(cidStr+"::"+directionStr+"::bw_est", m_gmaRxControl->GetBwEstimate(cid));
 
 				if(m_gmaDataProcessor && m_gmaRxControl->QosFlowPrioritizationEnabled())
 				{
 					if(m_clientRoleEnabled)
 					{
-						m_gmaDataProcessor->SaveDlQosMeasurement(m_clientId, 0.0, m_linkParamsMap[cid]->m_qosMarking, (int)cid);
+						m_gmaDataProcessor->SaveDlQosMeasurement(m_clientId, 0.0, GetLinkParams(cid)->m_qosMarking, (int)cid);
 					}
 					else if(m_serverRoleEnabled)
 					{
-						m_gmaDataProcessor->SaveUlQosMeasurement(m_clientId, 0.0, m_linkParamsMap[cid]->m_qosMarking, (int)cid);
+						m_gmaDataProcessor->SaveUlQosMeasurement(m_clientId, 0.0, GetLinkParams(cid)->m_qosMarking, (int)cid);
 					}
 				}
 				if(m_saveToFile)
@@ -984,8 +1034,13 @@ GmaVirtualInterface::CollectMeasureResults()
 			iterLink++;
 		}
 
-		m_measureParamPerCidMap.clear();
-		myfile.close();
+		ResetMeasureParams();
+		m_intervalMinOwd = UINT32_MAX;
+		m_intervalMaxOwd = 0;
+		if(m_saveToFile)
+		{
+			ReportWriter::GetStream(reportFileName) << myfile.str();
+		}
 		m_receivedBytes = 0;
 
 		m_reorderingTimeoutCounter = 0;
@@ -998,21 +1053,21 @@ GmaVirtualInterface::CollectMeasureResults()
 
 			if (m_clientRoleEnabled)
 			{
-				if(m_linkParamsMap.find(WIFI_CID) != m_linkParamsMap.end())
+				if(m_cidTable->Contains(WIFI_CID))
 				{
-					ns3::Ptr<ns3::NetworkStats> elementWifi = ns3::CreateObject<ns3::NetworkStats>(LinkState::ConvertCidFormat(WIFI_CID), m_clientId, end_ts);
-					elementWifi->Append("cell_id", (double)m_linkParamsMap[WIFI_CID]->m_phyAccessContrl->GetApId());
+					ns3::Ptr<ns3::NetworkStats> elementWifi = CreateNetworkStats(LinkState::ConvertCidFormat(WIFI_CID), end_ts);
+					elementWifi->Append("cell_id", (double)GetLinkParams(WIFI_CID)->m_phyAccessContrl->GetApId());
 					m_gmaDataProcessor->AppendMeasurement(elementWifi);
-					m_gmaDataProcessor->UpdateCellId(m_clientId, (double)m_linkParamsMap[WIFI_CID]->m_phyAccessContrl->GetApId(), LinkState::ConvertCidFormat(WIFI_CID));
+					m_gmaDataProcessor->UpdateCellId(m_clientId, (double)GetLinkParams(WIFI_CID)->m_phyAccessContrl->GetApId(), LinkState::ConvertCidFormat(WIFI_CID));
 				}
 
-				/*if(m_linkParamsMap.find(CELLULAR_NR_CID) != m_linkParamsMap.end())
+				/*if(m_cidTable->Contains(CELLULAR_NR_CID))
 				{
 					//TODO: NR use wifi cell id for now... Fix it later.
 					ns3::Ptr<ns3::NetworkStats> elementNr = ns3::CreateObject<ns3::NetworkStats>(LinkState::ConvertCidFormat(CELLULAR_NR_CID), m_clientId, end_ts);
-					elementNr->Append("cell_id", (double)m_linkParamsMap[WIFI_CID]->m_phyAccessContrl->GetApId());
+					elementNr->Append("cell_id", (double)GetLinkParams(WIFI_CID)->m_phyAccessContrl->GetApId());
 					m_gmaDataProcessor->AppendMeasurement(elementNr);
-					m_gmaDataProcessor->UpdateCellId(m_clientId, (double)m_linkParamsMap[WIFI_CID]->m_phyAccessContrl->GetApId(), LinkState::ConvertCidFormat(CELLULAR_NR_CID));
+					m_gmaDataProcessor->UpdateCellId(m_clientId, (double)GetLinkParams(WIFI_CID)->m_phyAccessContrl->GetApId(), LinkState::ConvertCidFormat(CELLULAR_NR_CID));
 				}*/
 			}
 		}
@@ -1099,22 +1154,12 @@ GmaVirtualInterface::Transmit (Ptr<Packet> packet)
 			//send packet to all links that are up
 			if(m_linkState->IsLinkUp(cid))
 			{
-				GmaHeader gmaHeader;
-
-				gmaHeader.SetTimeStamp(timeMs & 0xFFFFFFFF);
-				//set GMA sequence #
-				gmaHeader.SetSequenceNumber(m_gmaTxSn);
-
-				gmaHeader.SetLocalSequenceNumber(m_linkParamsMap[cid]->m_gmaTxLocalSn);
-				gmaHeader.SetConnectionId(cid); // later I might remove this since the CID may be referenced from port number
-				gmaHeader.SetFlowId (DUPLICATE_FLOW_ID);//duplicated packets
-
 				Ptr<Packet> dummyP = packet->Copy();
-				dummyP->AddHeader(gmaHeader);
+				AddGmaDataHeader(dummyP, cid, timeMs & 0xFFFFFFFF, DUPLICATE_FLOW_ID);//duplicated packets
 				//std::cout <<Now().GetSeconds() <<" TX IP: " <<ipv4Header.GetSource()<<  " -> " << ipv4Header.GetDestination() <<" link CID:" << +cid
 				//<< " SN:" << m_gmaTxSn << " LSN:"<< +iter->second->m_gmaTxLocalSn << "\n";
 
-				//m_linkParamsMap[cid]->m_socket->SendTo (dummyP, 0 ,InetSocketAddress (m_linkParamsMap[cid]->m_ipAddr, START_PORT_NUM+cid));
+				//GetLinkParams(cid)->m_socket->SendTo (dummyP, 0 ,InetSocketAddress (GetLinkParams(cid)->m_ipAddr, START_PORT_NUM+cid));
 				if (ipv4Header.GetProtocol() == 17)
 				{
 					SendByCid(cid, dummyP, (TOS_AC_VI & 0xE0) + (ip_tos & 0x1F)); //udp traffic use video. Overwrite the 3 MSB (priority) in tos.
@@ -1124,15 +1169,7 @@ GmaVirtualInterface::Transmit (Ptr<Packet> packet)
 					SendByCid(cid, dummyP, (TOS_AC_BE & 0xE0) + (ip_tos & 0x1F)); //tcp and other traffic use Best effort. Overwrite the 3 MSB (priority) in tos.
 				}
 
-				//log file
-				/*std::ostringstream fileName;
-				fileName <<"tx-"<<ipv4Header.GetSource()<<"-"<<ipv4Header.GetDestination()<<".csv";
-				std::ofstream myfile;
-				myfile.open (fileName.str ().c_str (), std::ios::out | std::ios::app);
-				myfile << Simulator::Now ().GetSeconds () << ",\t" << +cid<< ",\t" << m_gmaTxSn<< ",\t" << +m_linkParamsMap[cid]->m_gmaTxLocalSn <<"\n";
-				myfile.close();*/
-
-				m_linkParamsMap[cid]->m_gmaTxLocalSn = (m_linkParamsMap[cid]->m_gmaTxLocalSn + 1) & MAX_GMA_LSN;
+				GetLinkParams(cid)->m_gmaTxLocalSn = (GetLinkParams(cid)->m_gmaTxLocalSn + 1) & MAX_GMA_LSN;
 			}
 			iter++;
 
@@ -1142,12 +1179,6 @@ GmaVirtualInterface::Transmit (Ptr<Packet> packet)
 	}
 	else
 	{
-		GmaHeader gmaHeader;
-
-		gmaHeader.SetTimeStamp(timeMs & 0xFFFFFFFF);
-		//set GMA sequence #
-		gmaHeader.SetSequenceNumber(m_gmaTxSn);
-
 		//cid is selected by control algorithm. We havenot implement duplicate mode yet.
 		//Maybe we can reserve a ID for dupilcate packets, e.g., 255.
 
@@ -1242,34 +1273,23 @@ GmaVirtualInterface::Transmit (Ptr<Packet> packet)
 		//else no tsu, use default link.
 
 		//uint8_t cid = m_gmaTxControl->GetDeliveryLinkCid();
-		if (m_linkParamsMap.find(cid) == m_linkParamsMap.end())
+		if (!m_cidTable->Contains(cid))
 		{
 			//std::cout << " DROP PKT, link not configured yet!! need probe!\n";
 			return;
 		}
 
-		gmaHeader.SetLocalSequenceNumber(m_linkParamsMap[cid]->m_gmaTxLocalSn);
-		gmaHeader.SetConnectionId(cid); // later I might remove this since the CID may be referenced from port number
-		if (m_gmaTxControl->QosSteerEnabled())
-		{
-			gmaHeader.SetFlowId (QOS_FLOW_ID);
-		}
-		else
-		{
-			gmaHeader.SetFlowId (BEST_EFFORT_FLOW_ID);
-		}
+		uint8_t flowId = m_gmaTxControl->QosSteerEnabled() ? QOS_FLOW_ID : BEST_EFFORT_FLOW_ID;
 
 		Ptr<Packet> dummyP = packet->Copy();
-		dummyP->AddHeader(gmaHeader);
+		AddGmaDataHeader(dummyP, cid, timeMs & 0xFFFFFFFF, flowId);
 		//std::cout <<Now().GetSeconds() <<" TX IP: " <<ipv4Header.GetSource()<<  " -> " << ipv4Header.GetDestination() <<" link CID:" << +cid
-		//<< " SN:" << m_gmaTxSn << " LSN:"<< +m_linkParamsMap[cid]->m_gmaTxLocalSn << "\n";
-
-		//m_linkParamsMap[cid]->m_socket->SendTo (dummyP, 0 ,InetSocketAddress (m_linkParamsMap[cid]->m_ipAddr, START_PORT_NUM+cid));
-		auto markIter = m_linkParamsMap.find(cid);
+		//<< " SN:" << m_gmaTxSn << " LSN:"<< +GetLinkParams(cid)->m_gmaTxLocalSn << "\n";
 
-		if(markIter != m_linkParamsMap.end() && m_gmaRxControl->QosFlowPrioritizationEnabled())// find action for this user
+		//GetLinkParams(cid)->m_socket->SendTo (dummyP, 0 ,InetSocketAddress (GetLinkParams(cid)->m_ipAddr, START_PORT_NUM+cid));
+		if(m_gmaRxControl->QosFlowPrioritizationEnabled())// find action for this user
 		{
-			if(m_linkParamsMap[cid]->m_qosMarking > 0)//enable qos
+			if(GetLinkParams(cid)->m_qosMarking > 0)//enable qos
 			{
 				SendByCid(cid, dummyP, (TOS_AC_VI & 0xE0) + (ip_tos & 0x1F)); //qos, mark as video. Overwrite the 3 MSB (priority) in tos.
 			}
@@ -1291,17 +1311,9 @@ GmaVirtualInterface::Transmit (Ptr<Packet> packet)
 		}
 
 
-		//log file
-		/*std::ostringstream fileName;
-		fileName <<"tx-"<<ipv4Header.GetSource()<<"-"<<ipv4Header.GetDestination()<<".csv";
-		std::ofstream myfile;
-		myfile.open (fileName.str ().c_str (), std::ios::out | std::ios::app);
-		myfile << Simulator::Now ().GetSeconds () << ",\t" << +cid<< ",\t" << m_gmaTxSn<< ",\t" << +m_linkParamsMap[cid]->m_gmaTxLocalSn <<"\n";
-		myfile.close();*/
-
 		// the max size of GMA sequence number is 3 Bytes.
 		m_gmaTxSn = (m_gmaTxSn + 1) & MAX_GMA_SN;
-		m_linkParamsMap[cid]->m_gmaTxLocalSn = (m_linkParamsMap[cid]->m_gmaTxLocalSn + 1) & MAX_GMA_LSN;
+		GetLinkParams(cid)->m_gmaTxLocalSn = (GetLinkParams(cid)->m_gmaTxLocalSn + 1) & MAX_GMA_LSN;
 
 		//Send duplicated packet over backup links for testing QOS. we do not need reordering.
 
@@ -1310,7 +1322,7 @@ GmaVirtualInterface::Transmit (Ptr<Packet> packet)
 		{
 			uint8_t cid = dupCidList.at(ind);
 
-			if (m_linkParamsMap.find(cid) == m_linkParamsMap.end())
+			if (!m_cidTable->Contains(cid))
 			{
 				std::cout << " DROP PKT, link not configured yet!! need probe!\n";
 				continue;
@@ -1319,38 +1331,39 @@ GmaVirtualInterface::Transmit (Ptr<Packet> packet)
 			//send packet to all links that are up
 			if(m_linkState->IsLinkUp(cid))
 			{
-				GmaHeader gmaHeader;
-
-				gmaHeader.SetTimeStamp(timeMs & 0xFFFFFFFF);
-				//set GMA sequence #
-				gmaHeader.SetSequenceNumber(m_gmaTxSn);
-
-				gmaHeader.SetLocalSequenceNumber(m_linkParamsMap[cid]->m_gmaTxLocalSn);
-				gmaHeader.SetConnectionId(cid); // later I might remove this since the CID may be referenced from port number
-
-				if (m_gmaTxControl->QosSteerEnabled())
-				{
-					gmaHeader.SetFlowId (QOS_FLOW_ID);
-				}
-				else
-				{
-					gmaHeader.SetFlowId (BEST_EFFORT_FLOW_ID);
-				}
 				Ptr<Packet> dummyP = packet->Copy();
-				dummyP->AddHeader(gmaHeader);
+				AddGmaDataHeader(dummyP, cid, timeMs & 0xFFFFFFFF, flowId);
 				//std::cout <<Now().GetSeconds() <<" TX (DUP) IP: " <<ipv4Header.GetSource()<<  " -> " << ipv4Header.GetDestination() <<" link CID:" << +cid
-				//<< " SN:" << m_gmaTxSn << " LSN:"<< +m_linkParamsMap[cid]->m_gmaTxLocalSn << "\n";
+				//<< " SN:" << m_gmaTxSn << " LSN:"<< +GetLinkParams(cid)->m_gmaTxLocalSn << "\n";
 
-				//m_linkParamsMap[cid]->m_socket->SendTo (dummyP, 0 ,InetSocketAddress (m_linkParamsMap[cid]->m_ipAddr, START_PORT_NUM+cid));
+				//GetLinkParams(cid)->m_socket->SendTo (dummyP, 0 ,InetSocketAddress (GetLinkParams(cid)->m_ipAddr, START_PORT_NUM+cid));
 				SendByCid(cid, dummyP, (TOS_AC_BK & 0xE0) + (ip_tos & 0x1F));//testing packet, mark as background. Overwrite the 3 MSB (priority) in tos.
 
-				m_linkParamsMap[cid]->m_gmaTxLocalSn = (m_linkParamsMap[cid]->m_gmaTxLocalSn + 1) & MAX_GMA_LSN;
+				GetLinkParams(cid)->m_gmaTxLocalSn = (GetLinkParams(cid)->m_gmaTxLocalSn + 1) & MAX_GMA_LSN;
 			}
 		}
 
 	}
 }
 
+void
+GmaVirtualInterface::AddGmaDataHeader (Ptr<Packet> packet, uint8_t cid, uint32_t timeStamp, uint8_t flowId)
+{
+	//the gma header of this link is reused, only the per packet fields are updated before it is serialized.
+	Ptr<LinkParams> linkParams = GetLinkParams(cid);
+	GmaHeader& gmaHeader = linkParams->m_txGmaHeader;
+	gmaHeader.SetTimeStamp(timeStamp);
+	//set GMA sequence #
+	gmaHeader.SetSequenceNumber(m_gmaTxSn);
+	gmaHeader.SetLocalSequenceNumber(linkParams->m_gmaTxLocalSn);
+	gmaHeader.SetFlowId(flowId);
+	if(m_packetTrace)
+	{
+		m_packetTrace->Add(GmaPacketTrace::TX, gmaHeader, packet->GetSize());
+	}
+	packet->AddHeader(gmaHeader);
+}
+
 void
 GmaVirtualInterface::Receive (Ptr<Packet> packet, const Ipv4Address& phyAddr, uint16_t fromPort)
 {
@@ -1373,7 +1386,7 @@ GmaVirtualInterface::Receive (Ptr<Packet> packet, const Ipv4Address& phyAddr, ui
 		//std::cout <<Now().GetSeconds() <<" " << this << " Ctrl from port:" << +fromPort <<  "\n";
 		MxControlHeader mxHeaderPeek;
 		packet->PeekHeader(mxHeaderPeek);
-		if(m_linkParamsMap[mxHeaderPeek.GetConnectionId()]->m_phyAccessContrl->ReceiveOk(phyAddr) == false)
+		if(GetLinkParams(mxHeaderPeek.GetConnectionId())->m_phyAccessContrl->ReceiveOk(phyAddr) == false)
 		{
 			return;
 		}
@@ -1382,7 +1395,7 @@ GmaVirtualInterface::Receive (Ptr<Packet> packet, const Ipv4Address& phyAddr, ui
 	}
 	else if(packet->GetSize() == 0) //end markder
 	{
-		if(m_linkParamsMap[gmaHeader.GetConnectionId()]->m_phyAccessContrl->ReceiveOk(phyAddr) == false)
+		if(GetLinkParams(gmaHeader.GetConnectionId())->m_phyAccessContrl->ReceiveOk(phyAddr) == false)
 		{
 			return;
 		}
@@ -1407,7 +1420,7 @@ GmaVirtualInterface::Receive (Ptr<Packet> packet, const Ipv4Address& phyAddr, ui
 	else
 	{
 		//receive data begins.
-		if(m_linkParamsMap[gmaHeader.GetConnectionId()]->m_phyAccessContrl->ReceiveOk(phyAddr) == false)
+		if(GetLinkParams(gmaHeader.GetConnectionId())->m_phyAccessContrl->ReceiveOk(phyAddr) == false)
 		{
 			return;
 		}
@@ -1470,16 +1483,10 @@ GmaVirtualInterface::Receive (Ptr<Packet> packet, const Ipv4Address& phyAddr, ui
 		//<<+gmaHeader.GetConnectionId() << " SN:"<<gmaHeader.GetSequenceNumber() << " LSN:"<< +gmaHeader.GetLocalSequenceNumber() <<  "\n";
 
 
-		//log file
-		/*Ipv4Header ipv4Header;
-		packet->PeekHeader (ipv4Header);
-		std::ostringstream fileName;
-		fileName <<"rx-"<<ipv4Header.GetSource()<<"-"<<ipv4Header.GetDestination()<<".csv";
-		std::ofstream myfile;
-		myfile.open (fileName.str ().c_str (), std::ios::out | std::ios::app);
-		myfile << Simulator::Now ().GetSeconds () << ",\t" << +gmaHeader.GetConnectionId()
-		<< ",\t" << gmaHeader.GetSequenceNumber()<< ",\t" << +gmaHeader.GetLocalSequenceNumber() <<"\n";
-		myfile.close();*/
+		if(m_packetTrace)
+		{
+			m_packetTrace->Add(GmaPacketTrace::RX, gmaHeader, packet->GetSize());
+		}
 
 		NS_ASSERT_MSG(gmaHeader.GetConnectionId() == fromPort-START_PORT_NUM, "the port number should equals START_PORT_NUM + cid");
 
@@ -1490,12 +1497,13 @@ GmaVirtualInterface::Receive (Ptr<Packet> packet, const Ipv4Address& phyAddr, ui
 			if(m_measurementManager->IsMeasurementOn())//this check whether measure cycle is on 
 			{
 				//start measurement interval if condition meets
-				//m_measurementManager->MeasureIntervalStartCheck(Now(), m_gmaRxExpectedSn);
-				m_measurementManager->MeasureIntervalStartCheck(Now(), gmaHeader.GetSequenceNumber(), m_gmaRxExpectedSn);//use sn from the pkt.
+				Time now = Now();
+				//m_measurementManager->MeasureIntervalStartCheck(now, m_gmaRxExpectedSn);
+				m_measurementManager->MeasureIntervalStartCheck(now, gmaHeader.GetSequenceNumber(), m_gmaRxExpectedSn);//use sn from the pkt.
 				//measure owd and loss from lsn
-				m_measurementManager->DataMeasurementSample(Now().GetMilliSeconds() - gmaHeader.GetTimeStamp(), gmaHeader.GetLocalSequenceNumber(), cid);
+				m_measurementManager->DataMeasurementSample(now.GetMilliSeconds() - gmaHeader.GetTimeStamp(), gmaHeader.GetLocalSequenceNumber(), cid);
 				//check if the interval should end
-				m_measurementManager->MeasureIntervalEndCheck(Now());
+				m_measurementManager->MeasureIntervalEndCheck(now);
 			}
 
 			if(m_clientRoleEnabled && m_gmaRxControl->QosSteerEnabled() )//client side && QOS enabled
@@ -1556,77 +1564,76 @@ GmaVirtualInterface::Receive (Ptr<Packet> packet, const Ipv4Address& phyAddr, ui
 			uint32_t owd = Now().GetMilliSeconds() - gmaHeader.GetTimeStamp();
 			m_receivedBytes += packet->GetSize();
 
-			if(m_measureParamPerCidMap.find(cid) == m_measureParamPerCidMap.end())
-			{
-				Ptr<MeasureParam> measureParam = Create<MeasureParam>();
-				m_measureParamPerCidMap[cid] = measureParam;
-			}
-
-			if(m_measureSnPerCidMap.find(cid) == m_measureSnPerCidMap.end())
+			//the measurement of this cid is stored in its link params, indexed by the slot of the cid.
+			const Ptr<LinkParams>& linkParams = GetLinkParams(cid);
+			MeasureParam& measureParam = linkParams->m_measureParam;
+			MeasureSn& measureSn = linkParams->m_measureSn;
+			if(measureParam.m_count == 0)
 			{
-				Ptr<MeasureSn> measureSn = Create<MeasureSn>();
-				m_measureSnPerCidMap[cid] = measureSn;
+				m_measuredLinkCount++; //first packet of this link in the report interval.
 			}
 
+			measureParam.m_rcvBytes += packet->GetSize();
 
-			m_measureParamPerCidMap[cid]->m_rcvBytes += packet->GetSize();
-
-			if(m_measureParamPerCidMap[cid]->m_maxOwd < owd)
+			if(measureParam.m_maxOwd < owd)
 			{
-				m_measureParamPerCidMap[cid]->m_maxOwd = owd;
+				measureParam.m_maxOwd = owd;
+				m_intervalMaxOwd = std::max(m_intervalMaxOwd, owd);
 			}
 
-			if(m_measureParamPerCidMap[cid]->m_minOwd > owd)
+			if(measureParam.m_minOwd > owd)
 			{
-				m_measureParamPerCidMap[cid]->m_minOwd = owd;
+				measureParam.m_minOwd = owd;
+				m_intervalMinOwd = std::min(m_intervalMinOwd, owd);
 			}
 
 			if(owd > m_acceptableDelay)
 			{
-				m_measureParamPerCidMap[cid]->m_numOfHighDelayPkt += 1;
+				measureParam.m_numOfHighDelayPkt += 1;
 			}
 
-			m_measureParamPerCidMap[cid]->m_owdSum += owd;
-			m_measureParamPerCidMap[cid]->m_count++;
+			measureParam.m_owdSum += owd;
+			measureParam.m_count++;
+			measureParam.m_owdSketch.Add(owd);
 
 			uint8_t lastLsn = gmaHeader.GetLocalSequenceNumber();
 			//determing in order or not
-			if(LsnDiff(lastLsn, m_measureSnPerCidMap[cid]->m_lastLsn) == 1)
+			if(LsnDiff(lastLsn, measureSn.m_lastLsn) == 1)
 			{
 				// in order packets
-				m_measureParamPerCidMap[cid]->m_numOfInOrderPacketsForReport++;
-				m_measureSnPerCidMap[cid]->m_lastLsn = lastLsn;
-				m_measureSnPerCidMap[cid]->m_lastGsn = gmaHeader.GetSequenceNumber();
+				measureParam.m_numOfInOrderPacketsForReport++;
+				measureSn.m_lastLsn = lastLsn;
+				measureSn.m_lastGsn = gmaHeader.GetSequenceNumber();
 			}
-			else if(LsnDiff(lastLsn, m_measureSnPerCidMap[cid]->m_lastLsn) > 1)
+			else if(LsnDiff(lastLsn, measureSn.m_lastLsn) > 1)
 			{
 				// detect a gap: received Lsn larger than expected value.
 				//std::cout << "--------------------------------new:" <<+lastLsn
-				//<< " last:" << +m_measureSnPerCidMap[cid]->m_lastLsn 
-				//<< " missing:" << LsnDiff(lastLsn, m_measureSnPerCidMap[cid]->m_lastLsn)-1 << "\n";
-				m_measureParamPerCidMap[cid]->m_numOfMissingPacketsForReport = m_measureParamPerCidMap[cid]->m_numOfMissingPacketsForReport + LsnDiff(lastLsn, m_measureSnPerCidMap[cid]->m_lastLsn)-1;
-				m_measureParamPerCidMap[cid]->m_numOfInOrderPacketsForReport++;
-				m_measureSnPerCidMap[cid]->m_lastLsn = lastLsn;
-				m_measureSnPerCidMap[cid]->m_lastGsn = gmaHeader.GetSequenceNumber();
+				//<< " last:" << +measureSn.m_lastLsn 
+				//<< " missing:" << LsnDiff(lastLsn, measureSn.m_lastLsn)-1 << "\n";
+				measureParam.m_numOfMissingPacketsForReport = measureParam.m_numOfMissingPacketsForReport + LsnDiff(lastLsn, measureSn.m_lastLsn)-1;
+				measureParam.m_numOfInOrderPacketsForReport++;
+				measureSn.m_lastLsn = lastLsn;
+				measureSn.m_lastGsn = gmaHeader.GetSequenceNumber();
 			}
 			else 
 			{
 				//std::cout << "--------------------------------new:" <<+lastLsn
-				//<< " last:" << +m_measureSnPerCidMap[cid]->m_lastLsn 
+				//<< " last:" << +measureSn.m_lastLsn 
 				//<< " abormal: 1 \n";
 				//abnormal packets
 
-				if(SnDiff(gmaHeader.GetSequenceNumber(), m_measureSnPerCidMap[cid]->m_lastGsn) > 0)
+				if(SnDiff(gmaHeader.GetSequenceNumber(), measureSn.m_lastGsn) > 0)
 				{
 					//miss more than 128 packets!!!
-					m_measureParamPerCidMap[cid]->m_numOfMissingPacketsForReport = m_measureParamPerCidMap[cid]->m_numOfMissingPacketsForReport + 256 + LsnDiff(lastLsn, m_measureSnPerCidMap[cid]->m_lastLsn)-1;
-					m_measureParamPerCidMap[cid]->m_numOfInOrderPacketsForReport++;
-					m_measureSnPerCidMap[cid]->m_lastLsn = lastLsn;
-					m_measureSnPerCidMap[cid]->m_lastGsn = gmaHeader.GetSequenceNumber();
+					measureParam.m_numOfMissingPacketsForReport = measureParam.m_numOfMissingPacketsForReport + 256 + LsnDiff(lastLsn, measureSn.m_lastLsn)-1;
+					measureParam.m_numOfInOrderPacketsForReport++;
+					measureSn.m_lastLsn = lastLsn;
+					measureSn.m_lastGsn = gmaHeader.GetSequenceNumber();
 				}
 				else
 				{	
-					m_measureParamPerCidMap[cid]->m_numOfAbnormalPacketsForReport++;
+					measureParam.m_numOfAbnormalPacketsForReport++;
 				}
 			}
 
@@ -1653,6 +1660,10 @@ GmaVirtualInterface::Receive (Ptr<Packet> packet, const Ipv4Address& phyAddr, ui
 void
 GmaVirtualInterface::MeasureAndForward (Ptr<Packet> packet, const GmaHeader& gmaHeader)
 {
+	if(m_packetTrace)
+	{
+		m_packetTrace->Add(GmaPacketTrace::DELIVER, gmaHeader, packet->GetSize());
+	}
 	if(m_enableMeasureReport)
 	{
 		//determing in order or not
@@ -1723,7 +1734,7 @@ GmaVirtualInterface::MeasureAndForward (Ptr<Packet> packet, const GmaHeader& gma
 void
 GmaVirtualInterface::InOrderDelivery (Ptr<Packet> packet, const GmaHeader& gmaHeader, uint8_t cid)
 {
-	NS_ASSERT_MSG (m_linkParamsMap.find(cid) != m_linkParamsMap.end(), "this cid doesnot exit");
+	NS_ASSERT_MSG (m_cidTable->Contains(cid), "this cid doesnot exit");
 	NS_ASSERT_MSG(gmaHeader.GetConnectionId() == cid, "Now the cid from GMA header should be the same converted from port number");
 	if(gmaHeader.GetSequenceNumber() == m_gmaRxExpectedSn) // in order packets
 	{
@@ -1740,11 +1751,11 @@ GmaVirtualInterface::InOrderDelivery (Ptr<Packet> packet, const GmaHeader& gmaHe
 	{
 		//do not deliver out of order packet that sn is smaller than expected sn.
 		//MeasureAndForward (packet, gmaHeader);
-		std::cout << Now().GetSeconds() << "------[small]------ last SN:" << m_linkParamsMap[cid]->m_gmaRxLastSn << " "
+		std::cout << Now().GetSeconds() << "------[small]------ last SN:" << GetLinkParams(cid)->m_gmaRxLastSn << " "
 		<< " new SN:" << gmaHeader.GetSequenceNumber () << " "
-		<< "last LSN:" << +m_linkParamsMap[cid]->m_gmaRxLastLocalSn << " new LSN:" 
+		<< "last LSN:" << +GetLinkParams(cid)->m_gmaRxLastLocalSn << " new LSN:" 
 		<< +gmaHeader.GetLocalSequenceNumber() << " SN diff:" 
-		<< SnDiff(gmaHeader.GetSequenceNumber(), m_linkParamsMap[cid]->m_gmaRxLastSn) - 1
+		<< SnDiff(gmaHeader.GetSequenceNumber(), GetLinkParams(cid)->m_gmaRxLastSn) - 1
 		<<  "\n";
 	}
 	else
@@ -1752,20 +1763,20 @@ GmaVirtualInterface::InOrderDelivery (Ptr<Packet> packet, const GmaHeader& gmaHe
 		//out of order;
 		//if lost = gap, we still deliver 
 
-		int numOfLostPacket = LsnDiff(gmaHeader.GetLocalSequenceNumber(), m_linkParamsMap[cid]->m_gmaRxLastLocalSn) - 1;
+		int numOfLostPacket = LsnDiff(gmaHeader.GetLocalSequenceNumber(), GetLinkParams(cid)->m_gmaRxLastLocalSn) - 1;
 		//NS_ASSERT_MSG(numOfLostPacket >=0, "num of lost packets cannot be negative");
 
 		//lsn should be always in order!!!!
-		/*std::cout << Now().GetSeconds() << "------------ last SN:" << m_linkParamsMap[cid]->m_gmaRxLastSn << " "
+		/*std::cout << Now().GetSeconds() << "------------ last SN:" << GetLinkParams(cid)->m_gmaRxLastSn << " "
 		<< " new SN:" << gmaHeader.GetSequenceNumber () << " "
-		<< "last LSN:" << +m_linkParamsMap[cid]->m_gmaRxLastLocalSn << " new LSN:" 
+		<< "last LSN:" << +GetLinkParams(cid)->m_gmaRxLastLocalSn << " new LSN:" 
 		<< +gmaHeader.GetLocalSequenceNumber() << " SN diff:" 
-		<< SnDiff(gmaHeader.GetSequenceNumber(), m_linkParamsMap[cid]->m_gmaRxLastSn) - 1
+		<< SnDiff(gmaHeader.GetSequenceNumber(), GetLinkParams(cid)->m_gmaRxLastSn) - 1
 		<< " lost:" << +numOfLostPacket << "\n";*/
 
-		if(m_useLsnReordering && (numOfLostPacket == SnDiff(gmaHeader.GetSequenceNumber(), m_linkParamsMap[cid]->m_gmaRxLastSn) - 1))
+		if(m_useLsnReordering && (numOfLostPacket == SnDiff(gmaHeader.GetSequenceNumber(), GetLinkParams(cid)->m_gmaRxLastSn) - 1))
 		{
-			if (m_linkParamsMap[cid]->m_reorderingQueue.size() == 0)//no reordering over this link, release this packet
+			if (GetLinkParams(cid)->m_reorderingCount == 0)//no reordering over this link, release this packet
 			{
 				MeasureAndForward (packet, gmaHeader);
 				m_gmaRxExpectedSn =  (gmaHeader.GetSequenceNumber()+1) & MAX_GMA_SN;
@@ -1779,15 +1790,9 @@ GmaVirtualInterface::InOrderDelivery (Ptr<Packet> packet, const GmaHeader& gmaHe
 			else 
 			{
 				//put this packet into the reordering queue, but mark it as inorder such that it will be delivered if the packet before it is released.
-				NS_ASSERT_MSG(m_totalQueueSize!=0, "it cannnot be empty here");
+				NS_ASSERT_MSG(!m_reorderingBuffer.IsEmpty(), "it cannnot be empty here");
 				NS_ASSERT_MSG(m_reorderingTimeoutEvent.IsRunning(), "The reordering cannot be expired");
-				Ptr<RxQueueIterm> item = Create <RxQueueIterm> ();
-				item->m_packet = packet;
-				item->m_gmaHeader = gmaHeader;
-				item->m_inOrder = true;
-				item->m_receivedTime = Now();
-				m_linkParamsMap[cid]->m_reorderingQueue.push(item);
-				m_totalQueueSize++;
+				EnqueueReorderingPacket(cid, packet, gmaHeader, true);
 
 			}
 		}
@@ -1798,89 +1803,113 @@ GmaVirtualInterface::InOrderDelivery (Ptr<Packet> packet, const GmaHeader& gmaHe
 				//std::cout << "receive out of order pkt sn:" << +gmaHeader.GetSequenceNumber() << " from cid:" << +cid << "\n";
 				//in steer mode, receive out of order pkt, stop reordering after timeout
 				UpdateReorderTimeout();
-				m_stopReorderEvent = Simulator::Schedule(m_reorderingTimeout, &GmaVirtualInterface::StopReordering, this, 2); //m_reorderingTimeout = 2 x (MAX - MIN);
+				m_stopReorderEvent = m_timerWheel->Schedule(m_reorderingTimeout, &GmaVirtualInterface::StopReordering, this, 2); //m_reorderingTimeout = 2 x (MAX - MIN);
 			}
 			//out of order packet, put into the queue
-			Ptr<RxQueueIterm> item = Create <RxQueueIterm> ();
-			item->m_packet = packet;
-			item->m_gmaHeader = gmaHeader;
-			item->m_receivedTime = Now();
-			m_linkParamsMap[cid]->m_reorderingQueue.push(item);
-			m_totalQueueSize++;
+			EnqueueReorderingPacket(cid, packet, gmaHeader, false);
 		}
 		ReleaseMinSnPacket();//if all queues are not empty, compare the sn of first packet and release the one with min SN
 		//std::cout << "min SN:" << minSn << " min index:" << +minCid << "\n";
 		ReleaseInOrderPackets();//release inorder packets in the reordering queue (including timeout ones)
 	}
 		
-	m_linkParamsMap[cid]->m_gmaRxLastLocalSn = gmaHeader.GetLocalSequenceNumber();
-	m_linkParamsMap[cid]->m_gmaRxLastSn = gmaHeader.GetSequenceNumber();
+	GetLinkParams(cid)->m_gmaRxLastLocalSn = gmaHeader.GetLocalSequenceNumber();
+	GetLinkParams(cid)->m_gmaRxLastSn = gmaHeader.GetSequenceNumber();
 
 }
 
 void
-GmaVirtualInterface::ReleaseMinSnPacket()
+GmaVirtualInterface::EnqueueReorderingPacket(uint8_t cid, Ptr<Packet> packet, const GmaHeader& gmaHeader, bool inOrder)
 {
-	int minSn = MAX_GMA_SN;
-	uint8_t minCid = 255;
+	uint32_t sn = gmaHeader.GetSequenceNumber();
+	if(!m_reorderingBuffer.IsInWindow(sn))
+	{
+		//the sn is too far from the buffered packets, e.g., a large sn jump. The buffer does not grow beyond its max capacity.
+		if(SnDiff(sn, m_reorderingBuffer.GetMinSn()) < 0)
+		{
+			//smaller than all buffered packets, deliver it first.
+			MeasureAndForward (packet, gmaHeader);
+			if(SnDiff(sn, m_gmaRxExpectedSn) >= 0)
+			{
+				m_gmaRxExpectedSn = (sn + 1) & MAX_GMA_SN;
+			}
+			return;
+		}
+		//release the buffered packets in order until the sn fits in the window.
+		GmaReorderingBuffer::Slot slot;
+		while(!m_reorderingBuffer.IsInWindow(sn))
+		{
+			DequeueReorderingPacket(slot);
+			MeasureAndForward (slot.m_packet, slot.m_gmaHeader);
+			if(SnDiff(slot.m_gmaHeader.GetSequenceNumber(), m_gmaRxExpectedSn) >= 0)
+			{
+				m_gmaRxExpectedSn = (slot.m_gmaHeader.GetSequenceNumber() + 1) & MAX_GMA_SN;
+			}
+		}
+	}
+	if(!m_reorderingBuffer.Insert(packet, gmaHeader, inOrder, Now()))
+	{
+		//a packet with the same sn is already in the buffer, discard duplicated packets.
+		return;
+	}
+	if(GetLinkParams(cid)->m_reorderingCount++ == 0)
+	{
+		m_reorderingLinkCount++;
+	}
+}
 
-	while(minSn >= 0)//minSn < 0 means one or more queues are empty, break the look
+void
+GmaVirtualInterface::DequeueReorderingPacket(GmaReorderingBuffer::Slot& slot)
+{
+	m_reorderingBuffer.PopMin(slot);
+	if(--GetLinkParams(slot.m_gmaHeader.GetConnectionId())->m_reorderingCount == 0)
 	{
-		minSn = MAX_GMA_SN;
+		m_reorderingLinkCount--;
+	}
+}
 
-		std::map < uint8_t, Ptr<LinkParams> >::iterator iter = m_linkParamsMap.begin();
-		while(iter != m_linkParamsMap.end())
+void
+GmaVirtualInterface::ReleaseMinSnPacket()
+{
+	GmaReorderingBuffer::Slot slot;
+	//release the min sn packet while no link that is up has an empty reordering queue.
+	while(!m_reorderingBuffer.IsEmpty())
+	{
+		if(m_reorderingLinkCount < m_linkParamsMap.size())
 		{
-			 //this while loop find the minimual sn and its cid of all reordering queues, 
-			//if more than one queue is empty, return minSN = -1
-			if(iter->second->m_reorderingQueue.size() == 0)// one queue is empty, break
+			//one or more links have no buffered packet, the failed links are skipped.
+			bool emptyQueue = false;
+			std::map < uint8_t, Ptr<LinkParams> >::iterator iter = m_linkParamsMap.begin();
+			while(iter != m_linkParamsMap.end())
 			{
-				if(m_linkState->IsLinkUp(iter->first))//this link is up
+				//we now do not care if the link is up or down for reordering.
+				if(iter->second->m_reorderingCount == 0 && m_linkState->IsLinkUp(iter->first))
 				{
-					//we now do not care if the link is up or down for reordering.
-					minSn = -1;	
+					emptyQueue = true;
 					break;
 				}
-				//else this link is failed, skip it
+				iter++;
 			}
-			else
+			if(emptyQueue)
 			{
-				if(minSn == MAX_GMA_SN || SnDiff(minSn, iter->second->m_reorderingQueue.front()->m_gmaHeader.GetSequenceNumber()) > 0)
-				{
-					//find the minimual sequence of all queues.
-					minSn = iter->second->m_reorderingQueue.front()->m_gmaHeader.GetSequenceNumber();
-					minCid = iter->first;
-				}
+				break;
 			}
-			iter++;
 		}
 
-		if(minSn == MAX_GMA_SN)
+		//deliver the packet with minimual sn
+		DequeueReorderingPacket(slot);
+
+		if(SnDiff(slot.m_gmaHeader.GetSequenceNumber(), m_gmaRxExpectedSn) >=0)
 		{
-			minSn = -1;
+			//deliver if the packet's sn is greater or equal to the expected SN
+			MeasureAndForward (slot.m_packet, slot.m_gmaHeader);
+			m_gmaRxExpectedSn = (slot.m_gmaHeader.GetSequenceNumber() + 1) & MAX_GMA_SN;
+			//std::cout << "deliver sn " << slot.m_gmaHeader.GetSequenceNumber() << "\n";
 		}
-
-		if(minSn >= 0)//no queue is empty
+		else
 		{
-			//deliver the packet with minimual sn
-			NS_ASSERT_MSG( minCid!= 255, " cannot be the initial value");
-
-			Ptr<RxQueueIterm> itemDequeue = m_linkParamsMap[minCid]->m_reorderingQueue.front();
-			m_linkParamsMap[minCid]->m_reorderingQueue.pop();
-			m_totalQueueSize--;
-
-			if(SnDiff(itemDequeue->m_gmaHeader.GetSequenceNumber(), m_gmaRxExpectedSn) >=0)
-			{
-				//deliver if the packet's sn is greater or equal to the expected SN
-				MeasureAndForward (itemDequeue->m_packet, itemDequeue->m_gmaHeader);
-				m_gmaRxExpectedSn = (itemDequeue->m_gmaHeader.GetSequenceNumber() + 1) & MAX_GMA_SN;
-				//std::cout << "deliver sn " << itemDequeue->m_gmaHeader.GetSequenceNumber() << "\n";
-			}
-			else
-			{
-				MeasureAndForward (itemDequeue->m_packet, itemDequeue->m_gmaHeader);
-				//discard duplicated packets.
-			}
+			MeasureAndForward (slot.m_packet, slot.m_gmaHeader);
+			//discard duplicated packets.
 		}
 	}
 
@@ -1889,37 +1918,19 @@ GmaVirtualInterface::ReleaseMinSnPacket()
 void
 GmaVirtualInterface::UpdateReorderTimeout(){
 	//update the reordering timeout if the current measurement measures a higher timeout value;
-	Time newReorderingTimeout = m_reorderingTimeout;
-
-	uint32_t maxOwd = 0;
-	uint32_t minOwd = UINT32_MAX;
-
-	std::map < uint8_t, Ptr<MeasureParam> >::iterator iter = m_measureParamPerCidMap.begin();
-	while(iter!=m_measureParamPerCidMap.end())
-	{
-		if(maxOwd < iter->second->m_maxOwd)
-		{
-			maxOwd = iter->second->m_maxOwd;
-		}
-
-		if(minOwd > iter->second->m_minOwd)
-		{
-			minOwd = iter->second->m_minOwd;
-		}
-		iter++;
-	}
-	if(maxOwd!=0 && minOwd!=UINT32_MAX)
+	//this is called per released packet, the min and max owd of all links are maintained per received packet.
+	if(m_intervalMaxOwd!=0 && m_intervalMinOwd!=UINT32_MAX)
 	{
 		//reordering timeout equals 2* (max OWD - min OWD), it is also in the rage of [MIN..., MAX_REORDERING_TIMEOUT]
-		if(m_measureParamPerCidMap.size() > 1)
+		if(m_measuredLinkCount > 1)
 		{
-			newReorderingTimeout = std::max(MIN_REORDERING_TIMEOUT, std::min(MAX_REORDERING_TIMEOUT, MilliSeconds(2*(maxOwd-minOwd))));
+			Time newReorderingTimeout = std::max(MIN_REORDERING_TIMEOUT, std::min(MAX_REORDERING_TIMEOUT, MilliSeconds(2*(m_intervalMaxOwd-m_intervalMinOwd))));
 			if(newReorderingTimeout > m_reorderingTimeout)
 			{
 				m_reorderingTimeout = newReorderingTimeout;
 				//update reordering timeout to the bigger one.
-				//std::cout << Now().GetSeconds() << " node: " << m_nodeId << " UPDATE reordering timeout maxOwd:" << maxOwd 
-				//<< "ms, min Owd:" << minOwd << "ms, timeout:" << m_reorderingTimeout.GetMilliSeconds() << "ms@@@@@@@@\n";
+				//std::cout << Now().GetSeconds() << " node: " << m_nodeId << " UPDATE reordering timeout maxOwd:" << m_intervalMaxOwd 
+				//<< "ms, min Owd:" << m_intervalMinOwd << "ms, timeout:" << m_reorderingTimeout.GetMilliSeconds() << "ms@@@@@@@@\n";
 			}
 		}
 
@@ -1929,53 +1940,28 @@ GmaVirtualInterface::UpdateReorderTimeout(){
 void
 GmaVirtualInterface::ReleaseInOrderPackets()
 {
+	GmaReorderingBuffer::Slot slot;
 	//this function should not be called if all queues are full!!!!
 	//call ReleaseMinSnPacket() first!!!
 
 	//now we try to deliver all in order packets
 	UpdateReorderTimeout();
-	uint32_t minSn = MAX_GMA_SN;
-	uint8_t minCid = 255;
 
-	while(m_totalQueueSize > 0)
+	while(!m_reorderingBuffer.IsEmpty())
 	{
-		//compare the first packet of all queues and get the min SN. If it is out of order, all other packets are out of order
-		std::map < uint8_t, Ptr<LinkParams> >::iterator iter = m_linkParamsMap.begin();
-
-		minSn = MAX_GMA_SN;
-
-		while(iter != m_linkParamsMap.end())
-		{
-			//this while loop find the min SN and its cid, ingores the empty queue
-			if(iter->second->m_reorderingQueue.size() == 0)// queue is empty
-			{
-				//do nothing
-			}
-			else
-			{
-				if(minSn == MAX_GMA_SN || SnDiff(minSn, iter->second->m_reorderingQueue.front()->m_gmaHeader.GetSequenceNumber()) > 0)
-				{
-					//find the minimual sequence of all queues.
-					minSn = iter->second->m_reorderingQueue.front()->m_gmaHeader.GetSequenceNumber();
-					minCid = iter->first;
-				}
-			}
-			iter++;
-		}
+		//the min SN of all buffered packets. If it is out of order, all other packets are out of order
+		uint32_t minSn = m_reorderingBuffer.GetMinSn();
 
 		if(minSn == m_gmaRxExpectedSn)//in order delivery
 		{
-			NS_ASSERT_MSG( minCid!= 255, " cannot be the initial value");
-			Ptr<RxQueueIterm> itemDequeue = m_linkParamsMap[minCid]->m_reorderingQueue.front();
-			m_linkParamsMap[minCid]->m_reorderingQueue.pop();
-			m_totalQueueSize--;
+			DequeueReorderingPacket(slot);
 
-			MeasureAndForward (itemDequeue->m_packet, itemDequeue->m_gmaHeader);
-			m_gmaRxExpectedSn = (itemDequeue->m_gmaHeader.GetSequenceNumber()+1) & MAX_GMA_SN;
-			//std::cout << "deliver sn " << itemDequeue->m_gmaHeader.GetSequenceNumber() << "\n";
-			if(m_newLinkCid == itemDequeue->m_gmaHeader.GetConnectionId())//stop reordering if the inoder packet arrived at the new link:
+			MeasureAndForward (slot.m_packet, slot.m_gmaHeader);
+			m_gmaRxExpectedSn = (slot.m_gmaHeader.GetSequenceNumber()+1) & MAX_GMA_SN;
+			//std::cout << "deliver sn " << slot.m_gmaHeader.GetSequenceNumber() << "\n";
+			if(m_newLinkCid == slot.m_gmaHeader.GetConnectionId())//stop reordering if the inoder packet arrived at the new link:
 			{
-				//std::cout << "(after reordering) in order pkt sn:" << +itemDequeue->m_gmaHeader.GetSequenceNumber() << " from cid:" << +itemDequeue->m_gmaHeader.GetConnectionId() << "\n";
+				//std::cout << "(after reordering) in order pkt sn:" << +slot.m_gmaHeader.GetSequenceNumber() << " from cid:" << +slot.m_gmaHeader.GetConnectionId() << "\n";
 				StopReordering(0);
 			}
 		}
@@ -1983,81 +1969,59 @@ GmaVirtualInterface::ReleaseInOrderPackets()
 		{
 			//smaller sn, may happen in duplicate mode
 			//NS_FATAL_ERROR("should not happen, the smaller sn should be delivered in the previous step");
-			Ptr<RxQueueIterm> itemDequeue = m_linkParamsMap[minCid]->m_reorderingQueue.front();
-			m_linkParamsMap[minCid]->m_reorderingQueue.pop();
-			m_totalQueueSize--;
-			MeasureAndForward (itemDequeue->m_packet, itemDequeue->m_gmaHeader);
+			DequeueReorderingPacket(slot);
+			MeasureAndForward (slot.m_packet, slot.m_gmaHeader);
 		}
 		else
 		{
 			//larger sn than next sn
-			NS_ASSERT_MSG( minCid!= 255, " cannot be the initial value");
-	
-			Ptr<RxQueueIterm> itemFront = m_linkParamsMap[minCid]->m_reorderingQueue.front();
-			if(itemFront->m_inOrder)
-			{
-				//even if there is a gap, if this packet is marked as in order use LSN, we delivery
-				// a packet is makred as inorder if this SN diff is the same as LSN diff.
-				m_linkParamsMap[minCid]->m_reorderingQueue.pop();
-				m_totalQueueSize--;
-
-				MeasureAndForward (itemFront->m_packet, itemFront->m_gmaHeader);
-				m_gmaRxExpectedSn = (itemFront->m_gmaHeader.GetSequenceNumber()+1) & MAX_GMA_SN;
-
-				//std::cout << "deliver sn " << itemFront->m_gmaHeader.GetSequenceNumber() << "\n";
-			}
-			else
+			bool release = m_reorderingBuffer.GetMin().m_inOrder;
+			//even if there is a gap, if this packet is marked as in order use LSN, we delivery
+			// a packet is makred as inorder if this SN diff is the same as LSN diff.
+			if(!release)
 			{
 				//the min SN is lager than next sn. not inorder(from the LSN algorithm)
-				bool expiredPacketExist = false;
-				iter = m_linkParamsMap.begin();
-				while(iter != m_linkParamsMap.end())
-				{
-					if(iter->second->m_reorderingQueue.size() != 0)
-					{
-						//Check is there any expired packet in the queue!
-						if(Now() >= iter->second->m_reorderingQueue.front()->m_receivedTime + m_reorderingTimeout)
-						{
-							//find an expired packet!
-							expiredPacketExist = true;
-							break;
-						}
-					}
-					iter++;
-				}
-
-				if(expiredPacketExist)
+				//Check is there any expired packet in the buffer!
+				if(Now() >= m_reorderingBuffer.GetOldestReceivedTime() + m_reorderingTimeout)
 				{
 					//if there is an expired packet, we will release the min sn packet first;
 					//if the expired packet is not the min sn, we will repeast releasing packets until we release this expired packets
 					//this way, we make sure the packets are released in order!
 					m_reorderingTimeoutCounter++;
-					m_linkParamsMap[minCid]->m_reorderingQueue.pop();
-					m_totalQueueSize--;
+					release = true;
+				}
+			}
 
-					MeasureAndForward (itemFront->m_packet, itemFront->m_gmaHeader);
-					m_gmaRxExpectedSn = (itemFront->m_gmaHeader.GetSequenceNumber()+1) & MAX_GMA_SN;
+			if(release)
+			{
+				DequeueReorderingPacket(slot);
 
-					//std::cout << "deliver sn " << itemFront->m_gmaHeader.GetSequenceNumber() << "\n";
-				}
-				else
-				{
-					//the min SN packet in the queue is greater than next sn and no packet is expired, break the loop and return
-					break;
-				}
+				MeasureAndForward (slot.m_packet, slot.m_gmaHeader);
+				m_gmaRxExpectedSn = (slot.m_gmaHeader.GetSequenceNumber()+1) & MAX_GMA_SN;
+
+				//std::cout << "deliver sn " << slot.m_gmaHeader.GetSequenceNumber() << "\n";
+			}
+			else
+			{
+				//the min SN packet in the queue is greater than next sn and no packet is expired, break the loop and return
+				break;
 			}
 		}
 	}
 
-	if(m_totalQueueSize > 0)
+	if(!m_reorderingBuffer.IsEmpty())
 	{
-		m_reorderingTimeoutEvent.Cancel();
 		//add 1 milli second as gurad time
-		//here I just assume the packet with min CID is the packet received earliest (obviously not correct).
+		//here I just assume the packet with min SN is the packet received earliest (obviously not correct).
 		//because if I check the "actual" expired packet, the packets with smaller SN will also need to be cleared!!!!
 
-		Time delay = m_reorderingTimeout + MilliSeconds(1) - (Now() - m_linkParamsMap[minCid]->m_reorderingQueue.front()->m_receivedTime);
-		m_reorderingTimeoutEvent = Simulator::Schedule(delay, &GmaVirtualInterface::ReorderingTimeout, this);
+		Time delay = m_reorderingTimeout + MilliSeconds(1) - (Now() - m_reorderingBuffer.GetMin().m_receivedTime);
+		//the min packet and the timeout rarely change between two releases, keep the timer if it expires at the same tick.
+		if (!m_reorderingTimeoutEvent.IsRunning() || m_reorderingTimeoutEvent.GetTs() != m_timerWheel->GetTickTime(Now() + delay))
+		{
+			m_reorderingTimeoutEvent.Cancel();
+			m_reorderingTimeoutEvent = m_timerWheel->Schedule(delay, &GmaVirtualInterface::ReorderingTimeout, this);
+		}
 	}
 	else if (m_reorderingTimeoutEvent.IsRunning())
 	{
@@ -2068,43 +2032,15 @@ GmaVirtualInterface::ReleaseInOrderPackets()
 void
 GmaVirtualInterface::ReleaseAllPackets()
 {
-	uint32_t minSn = MAX_GMA_SN;
-	uint8_t minCid = 255;
-
-	while(m_totalQueueSize > 0)
+	GmaReorderingBuffer::Slot slot;
+	while(!m_reorderingBuffer.IsEmpty())
 	{
-		//compare the first packet of all queues and get the min SN. If it is out of order, all other packets are out of order
-		std::map < uint8_t, Ptr<LinkParams> >::iterator iter = m_linkParamsMap.begin();
-
-		minSn = MAX_GMA_SN;
-
-		while(iter != m_linkParamsMap.end())
-		{
-			//this while loop find the min SN and its cid, ingores the empty queue
-			if(iter->second->m_reorderingQueue.size() == 0)// queue is empty
-			{
-				//do nothing
-			}
-			else
-			{
-				if(minSn == MAX_GMA_SN || SnDiff(minSn, iter->second->m_reorderingQueue.front()->m_gmaHeader.GetSequenceNumber()) > 0)
-				{
-					//find the minimual sequence of all queues.
-					minSn = iter->second->m_reorderingQueue.front()->m_gmaHeader.GetSequenceNumber();
-					minCid = iter->first;
-				}
-			}
-			iter++;
-		}
+		//release the packet with the min SN of all links
+		DequeueReorderingPacket(slot);
 
-		NS_ASSERT_MSG( minCid!= 255, " cannot be the initial value");
-		Ptr<RxQueueIterm> itemDequeue = m_linkParamsMap[minCid]->m_reorderingQueue.front();
-		m_linkParamsMap[minCid]->m_reorderingQueue.pop();
-		m_totalQueueSize--;
-
-		MeasureAndForward (itemDequeue->m_packet, itemDequeue->m_gmaHeader);
-		m_gmaRxExpectedSn = (itemDequeue->m_gmaHeader.GetSequenceNumber()+1) & MAX_GMA_SN;
-		//std::cout << "deliver sn " << itemDequeue->m_gmaHeader.GetSequenceNumber() << "\n";
+		MeasureAndForward (slot.m_packet, slot.m_gmaHeader);
+		m_gmaRxExpectedSn = (slot.m_gmaHeader.GetSequenceNumber()+1) & MAX_GMA_SN;
+		//std::cout << "deliver sn " << slot.m_gmaHeader.GetSequenceNumber() << "\n";
 	}
 
 	
@@ -2163,13 +2099,13 @@ GmaVirtualInterface::PeriodicProbeMsg()
 	if (m_probeCounter < PROBE_BURST_SIZE)
 	{
 		//send another probe after the gap
-		m_periodicProbeEvent = Simulator::Schedule(m_probeBurstGap, &GmaVirtualInterface::PeriodicProbeMsg, this);
+		m_periodicProbeEvent = m_timerWheel->Schedule(m_probeBurstGap, &GmaVirtualInterface::PeriodicProbeMsg, this);
 		//m_probeBurstGap += m_probeBurstGap;//double the gap every time
 	}
 	else
 	{
 		//all probes in this burst is been sent. Resent probe burst (multiple probe msgs) after PROBE_INTERVAL.
-		m_periodicProbeEvent = Simulator::Schedule(PROBE_INTERVAL, &GmaVirtualInterface::PeriodicProbeMsg, this);
+		m_periodicProbeEvent = m_timerWheel->Schedule(PROBE_INTERVAL, &GmaVirtualInterface::PeriodicProbeMsg, this);
 		m_probeBurstGap = MilliSeconds(1);
 		m_probeCounter = 0;
 	}
@@ -2191,7 +2127,7 @@ GmaVirtualInterface::QosTestingRequestMsg (uint8_t cid, uint8_t duration, uint8_
 	mxHeader.SetTestDuration(duration);
 
 	//we only know the channel ID for WiFi.
-	uint16_t apId = m_linkParamsMap[cid]->m_phyAccessContrl->GetApId();
+	uint16_t apId = GetLinkParams(cid)->m_phyAccessContrl->GetApId();
 	if(apId == UINT8_MAX)
 	{
 		//NS_FATAL_ERROR("cannot find the AP ID for this node");
@@ -2465,7 +2401,7 @@ GmaVirtualInterface::SendCtrlMsg (const MxControlHeader& header, bool retx)
 
 				GmaHeader gmaHeader;
 				newP->AddHeader (gmaHeader);
-				//m_linkParamsMap[cid]->m_socket->SendTo (newP, 0 ,InetSocketAddress (m_linkParamsMap[cid]->m_ipAddr, START_PORT_NUM+cid));
+				//GetLinkParams(cid)->m_socket->SendTo (newP, 0 ,InetSocketAddress (GetLinkParams(cid)->m_ipAddr, START_PORT_NUM+cid));
 				//std::cout << "send over new link:" << +cid << std::endl;
 				SendByCid(cid, newP, (TOS_AC_BE & 0xE0) + (ip_tos & 0x1F));
 				//std::cout << Now().GetSeconds() << " Send TSU:" << newHeader << std::endl;
@@ -2501,7 +2437,7 @@ GmaVirtualInterface::SendCtrlMsg (const MxControlHeader& header, bool retx)
 		gmaHeader.SetClientId(m_nodeId);
 
 		newP->AddHeader (gmaHeader);
-		//m_linkParamsMap[cid]->m_socket->SendTo (newP, 0 ,InetSocketAddress (m_linkParamsMap[cid]->m_ipAddr, START_PORT_NUM+cid));
+		//GetLinkParams(cid)->m_socket->SendTo (newP, 0 ,InetSocketAddress (GetLinkParams(cid)->m_ipAddr, START_PORT_NUM+cid));
 		SendByCid(cid, newP, (TOS_AC_BE & 0xE0) + (ip_tos & 0x1F));
 
 	}
@@ -2513,9 +2449,9 @@ GmaVirtualInterface::SendCtrlMsg (const MxControlHeader& header, bool retx)
 
 		GmaHeader gmaHeader;
 		ctrP->AddHeader (gmaHeader);
-		NS_ASSERT_MSG(m_linkParamsMap.find(cid) != m_linkParamsMap.end(), " no such cid in the map");
+		NS_ASSERT_MSG(m_cidTable->Contains(cid), " no such cid in the map");
 
-		//m_linkParamsMap[cid]->m_socket->SendTo (ctrP, 0 ,InetSocketAddress (m_linkParamsMap[cid]->m_ipAddr, START_PORT_NUM+cid));
+		//GetLinkParams(cid)->m_socket->SendTo (ctrP, 0 ,InetSocketAddress (GetLinkParams(cid)->m_ipAddr, START_PORT_NUM+cid));
 		SendByCid(cid, ctrP, (TOS_AC_BE & 0xE0) + (ip_tos & 0x1F));
 	}
 
@@ -2540,7 +2476,7 @@ GmaVirtualInterface::SendCtrlMsg (const MxControlHeader& header, bool retx)
 			m_ctrRto = MilliSeconds(RTO_SCALER*m_measurementManager->GetMaxRttMs());
 			//std::cout << Now().GetSeconds() << " " << this << " ---------------------Update RTO:" << m_ctrRto.GetSeconds() << "\n";
 		}
-		Simulator::Schedule(m_ctrRto, &GmaVirtualInterface::RetxCtrlMsgExpires, this, header.GetSequenceNumber());//retx if ack is not received after this event expires
+		item->m_retxTimer = m_timerWheel->Schedule(m_ctrRto, &GmaVirtualInterface::RetxCtrlMsgExpires, this, header.GetSequenceNumber());//retx if ack is not received after this event expires
 	}
 	else
 	{
@@ -2614,7 +2550,7 @@ GmaVirtualInterface::RetxCtrlMsgExpires(uint16_t csn)
 					m_ctrRto = MilliSeconds(RTO_SCALER*m_measurementManager->GetMaxRttMs());
 					//std::cout << Now().GetSeconds() << " " << this << " ---------------------Update RTO:" << m_ctrRto.GetSeconds() << "\n";
 				}
-				Simulator::Schedule(m_ctrRto*std::pow(2, m_txedCtrQueue[csn]->m_csnToTxtimeMap.size()-1), 
+				m_txedCtrQueue[csn]->m_retxTimer = m_timerWheel->Schedule(m_ctrRto*std::pow(2, m_txedCtrQueue[csn]->m_csnToTxtimeMap.size()-1), 
 					&GmaVirtualInterface::RetxCtrlMsgExpires, this, csn); //schedule retx timeout, double the rto every retx
 			}
 		}
@@ -2642,23 +2578,29 @@ GmaVirtualInterface::RecvCtrlMsg (Ptr<Packet> packet, const Ipv4Address& phyAddr
 			uint8_t txCid = mxHeader.GetConnectionId();
 			//std::cout << Now().GetSeconds() <<" " << this << " txcid:" << +txCid << " type:" << +mxHeader.GetType() << " timestamp:" << mxHeader.GetTimeStamp() << " ctl owd: "<< +owd << "\n";
 
-			if(m_measureParamPerCidMap.find(txCid) == m_measureParamPerCidMap.end())
+			if(m_cidTable->Contains(txCid))
 			{
-				Ptr<MeasureParam> measureParam = Create<MeasureParam>();
-				m_measureParamPerCidMap[txCid] = measureParam;
-			}
+				MeasureParam& measureParam = GetLinkParams(txCid)->m_measureParam;
+				if(measureParam.m_count == 0)
+				{
+					m_measuredLinkCount++; //first packet of this link in the report interval.
+				}
 
-			if(m_measureParamPerCidMap[txCid]->m_maxOwd < owd)
-			{
-				m_measureParamPerCidMap[txCid]->m_maxOwd = owd;
-			}
+				if(measureParam.m_maxOwd < owd)
+				{
+					measureParam.m_maxOwd = owd;
+					m_intervalMaxOwd = std::max(m_intervalMaxOwd, owd);
+				}
 
-			if(m_measureParamPerCidMap[txCid]->m_minOwd > owd)
-			{
-				m_measureParamPerCidMap[txCid]->m_minOwd = owd;
+				if(measureParam.m_minOwd > owd)
+				{
+					measureParam.m_minOwd = owd;
+					m_intervalMinOwd = std::min(m_intervalMinOwd, owd);
+				}
+				measureParam.m_owdSum += owd;
+				measureParam.m_count++;
+				measureParam.m_owdSketch.Add(owd);
 			}
-			m_measureParamPerCidMap[txCid]->m_owdSum += owd;
-			m_measureParamPerCidMap[txCid]->m_count++;
 		}
 	}
 
@@ -2730,8 +2672,8 @@ GmaVirtualInterface::RecvCtrlMsg (Ptr<Packet> packet, const Ipv4Address& phyAddr
 
 		GmaHeader gmaHeader;
 		ackPacket->AddHeader (gmaHeader);
-		NS_ASSERT_MSG(m_linkParamsMap.find(cid) != m_linkParamsMap.end(), " no such cid in the map");
-		//m_linkParamsMap[cid]->m_socket->SendTo (ackPacket, 0 ,InetSocketAddress (m_linkParamsMap[cid]->m_ipAddr, START_PORT_NUM+cid));
+		NS_ASSERT_MSG(m_cidTable->Contains(cid), " no such cid in the map");
+		//GetLinkParams(cid)->m_socket->SendTo (ackPacket, 0 ,InetSocketAddress (GetLinkParams(cid)->m_ipAddr, START_PORT_NUM+cid));
 		if(mxHeader.GetProbeFlag() == 1)
 		{
 			SendByCid(cid, ackPacket, (TOS_AC_BE & 0xE0) + (ip_tos & 0x1F));//normal Probe
@@ -2739,10 +2681,10 @@ GmaVirtualInterface::RecvCtrlMsg (Ptr<Packet> packet, const Ipv4Address& phyAddr
 		else
 		{
 			//test probe, we need to send ACK back with the same IP...
-			Ipv4Address addrTemp = m_linkParamsMap[mxHeader.GetConnectionId()]->m_phyAccessContrl->GetIp();
-			m_linkParamsMap[mxHeader.GetConnectionId()]->m_phyAccessContrl->SetIp(phyAddr);
+			Ipv4Address addrTemp = GetLinkParams(mxHeader.GetConnectionId())->m_phyAccessContrl->GetIp();
+			GetLinkParams(mxHeader.GetConnectionId())->m_phyAccessContrl->SetIp(phyAddr);
 			SendByCid(cid, ackPacket, (TOS_AC_BE & 0xE0) + (ip_tos & 0x1F));//normal Probe
-			m_linkParamsMap[mxHeader.GetConnectionId()]->m_phyAccessContrl->SetIp(addrTemp);
+			GetLinkParams(mxHeader.GetConnectionId())->m_phyAccessContrl->SetIp(addrTemp);
 
 		}
 
@@ -2939,8 +2881,7 @@ GmaVirtualInterface::RecvCtrlMsg (Ptr<Packet> packet, const Ipv4Address& phyAddr
 				{
 					std::ostringstream fileName;
 					fileName <<"rx-tsu-node-"<<m_nodeId<<"-interface-"<<+m_gmaInterfaceId<<".csv";
-					std::ofstream myfile;
-					myfile.open (fileName.str ().c_str (), std::ios::out | std::ios::app);
+					std::ostream& myfile = ReportWriter::GetStream(fileName.str ());
 					myfile << Simulator::Now ().GetSeconds () << ":\t";
 					//std::vector<uint8_t> splitVector = mxHeader.GetKVector();
 					//for (uint8_t ind = 0; ind < splitVector.size(); ind++)
@@ -2948,8 +2889,7 @@ GmaVirtualInterface::RecvCtrlMsg (Ptr<Packet> packet, const Ipv4Address& phyAddr
 					//	myfile << +splitVector.at(ind)<<",\t";
 					//}
 					//myfile<< +mxHeader.GetL() <<std::endl;	
-					myfile << mxHeader <<std::endl;	
-					myfile.close();
+					myfile << mxHeader << "\n";
 				}
 			}
 		}
@@ -2984,15 +2924,15 @@ GmaVirtualInterface::RecvCtrlMsg (Ptr<Packet> packet, const Ipv4Address& phyAddr
 
 		GmaHeader gmaHeader;
 		tsaPacket->AddHeader (gmaHeader);
-		NS_ASSERT_MSG(m_linkParamsMap.find(cid) != m_linkParamsMap.end(), " no such cid in the map");
-		//m_linkParamsMap[cid]->m_socket->SendTo (tsaPacket, 0 ,InetSocketAddress (m_linkParamsMap[cid]->m_ipAddr, START_PORT_NUM+cid));
+		NS_ASSERT_MSG(m_cidTable->Contains(cid), " no such cid in the map");
+		//GetLinkParams(cid)->m_socket->SendTo (tsaPacket, 0 ,InetSocketAddress (GetLinkParams(cid)->m_ipAddr, START_PORT_NUM+cid));
 		SendByCid(cid, tsaPacket, (TOS_AC_BE & 0xE0) + (ip_tos & 0x1F));//normal Probe
 	}
 	else if (mxHeader.GetType () == 6 || mxHeader.GetType () == 7) // i use all ACK asd TSA to updat rtt and owd.
 	{
 		if(mxHeader.GetType () == 6)
 		{
-			if(m_linkParamsMap[mxHeader.GetConnectionId()]->m_phyAccessContrl->ProbeAcked(mxHeader.GetSequenceNumber()))
+			if(GetLinkParams(mxHeader.GetConnectionId())->m_phyAccessContrl->ProbeAcked(mxHeader.GetSequenceNumber()))
 			{
 				m_ctrRto = INITIAL_CONTROL_RTO; // reset rto
 			}
@@ -3012,6 +2952,7 @@ GmaVirtualInterface::RecvCtrlMsg (Ptr<Packet> packet, const Ipv4Address& phyAddr
 			sendTime = m_txedCtrQueue[mxHeader.GetSequenceNumber()]->m_csnToTxtimeMap.begin()->second; 
 			sendMsgType = m_txedCtrQueue[mxHeader.GetSequenceNumber()]->m_mxControlHeader.GetType();
 			sendMsg = m_txedCtrQueue[mxHeader.GetSequenceNumber()]->m_mxControlHeader;
+			m_txedCtrQueue[mxHeader.GetSequenceNumber()]->m_retxTimer.Cancel();
 			m_txedCtrQueue.erase(mxHeader.GetSequenceNumber()); //delete this msg from the txedqueue.
 		}
 		else
@@ -3028,6 +2969,7 @@ GmaVirtualInterface::RecvCtrlMsg (Ptr<Packet> packet, const Ipv4Address& phyAddr
 					sendTime = iter->second->m_csnToTxtimeMap[mxHeader.GetSequenceNumber()];
 					sendMsgType = iter->second->m_mxControlHeader.GetType();
 					sendMsg = iter->second->m_mxControlHeader;
+					iter->second->m_retxTimer.Cancel();
 					m_txedCtrQueue.erase(iter);//delete this msg from the txedqueue
 					break;
 				}
@@ -3189,7 +3131,7 @@ GmaVirtualInterface::RecvCtrlMsg (Ptr<Packet> packet, const Ipv4Address& phyAddr
 
 		m_qosClientTestingActive = true;//start qos testing session if not
 		uint8_t qosDuration = m_linkState->m_qosTestDurationUnit100ms;
-		Simulator::Schedule(MilliSeconds(qosDuration*100 + m_measurementManager->GetMaxRttMs()), &GmaVirtualInterface::QosTestingSessionEnd, this);//stop qos testing after qosDurationS
+		m_timerWheel->Schedule(MilliSeconds(qosDuration*100 + m_measurementManager->GetMaxRttMs()), &GmaVirtualInterface::QosTestingSessionEnd, this);//stop qos testing after qosDurationS
 
 		//Recv QoS Testing Start notify
 		if (mxHeader.GetConnectionId() != m_linkState->GetHighPriorityLinkCid())
@@ -3292,8 +3234,8 @@ GmaVirtualInterface::RespondAck(const MxControlHeader& header)
 
 	GmaHeader gmaHeader;
 	ackPacket->AddHeader (gmaHeader);
-	NS_ASSERT_MSG(m_linkParamsMap.find(cid) != m_linkParamsMap.end(), " no such cid("<< +cid << ") in the map");
-	//m_linkParamsMap[cid]->m_socket->SendTo (ackPacket, 0 ,InetSocketAddress (m_linkParamsMap[cid]->m_ipAddr, START_PORT_NUM+cid));
+	NS_ASSERT_MSG(m_cidTable->Contains(cid), " no such cid("<< +cid << ") in the map");
+	//GetLinkParams(cid)->m_socket->SendTo (ackPacket, 0 ,InetSocketAddress (GetLinkParams(cid)->m_ipAddr, START_PORT_NUM+cid));
 	uint8_t ip_tos = 0;
 	ip_tos += m_sliceId << 2;//add slice id (shift 2 bits) to tos.
 	SendByCid(cid, ackPacket, (TOS_AC_BE & 0xE0) + (ip_tos & 0x1F));//normal Probe
@@ -3354,8 +3296,8 @@ void
 GmaVirtualInterface::WifiPeriodicPowerTrace(uint8_t cid, uint8_t apId, double power)
 {
 	//std::cout << Now().GetSeconds() << " node:" << m_nodeId << " cid:" << +cid << " apId:" << +apId << " power:" << power <<"\n";
-	NS_ASSERT_MSG(m_linkParamsMap.find(cid) != m_linkParamsMap.end(), " no such cid in the map");
-	m_linkParamsMap[cid]->m_phyAccessContrl->ReportRssi(power, apId);
+	NS_ASSERT_MSG(m_cidTable->Contains(cid), " no such cid in the map");
+	GetLinkParams(cid)->m_phyAccessContrl->ReportRssi(power, apId);
 
 
 	if(m_wifiPowerAvailable == false)
@@ -3363,7 +3305,7 @@ GmaVirtualInterface::WifiPeriodicPowerTrace(uint8_t cid, uint8_t apId, double po
 		m_wifiPowerAvailable = true;
 	}
 
-	if(apId == m_linkParamsMap[cid]->m_phyAccessContrl->GetApId())//power trace for connected ap
+	if(apId == GetLinkParams(cid)->m_phyAccessContrl->GetApId())//power trace for connected ap
 	{
 		if(power < m_wifiLowPowerThreshDbm && m_wifiPowerRange != 0)
 	    {
@@ -3482,11 +3424,11 @@ GmaVirtualInterface::SendEndMarker(uint8_t cid)
 	Ptr<Packet> dummyP = Create<Packet>();
 	dummyP->AddHeader(gmaHeader);
 	//std::cout <<Now().GetSeconds() <<" TX IP: " <<ipv4Header.GetSource()<<  " -> " << ipv4Header.GetDestination() <<" link CID:" << +cid
-	//<< " SN:" << m_gmaTxSn << " LSN:"<< +m_linkParamsMap[cid]->m_gmaTxLocalSn << "\n";
+	//<< " SN:" << m_gmaTxSn << " LSN:"<< +GetLinkParams(cid)->m_gmaTxLocalSn << "\n";
 	//std::cout << Now().GetSeconds() << " node: "<< m_nodeId <<" Respond end marker over link " <<+cid <<"\n";
 
-	NS_ASSERT_MSG (m_linkParamsMap.find(cid) != m_linkParamsMap.end(), "this cid doesnot exit");
-	//m_linkParamsMap[cid]->m_socket->SendTo (dummyP, 0 ,InetSocketAddress (m_linkParamsMap[cid]->m_ipAddr, START_PORT_NUM+cid));
+	NS_ASSERT_MSG (m_cidTable->Contains(cid), "this cid doesnot exit");
+	//GetLinkParams(cid)->m_socket->SendTo (dummyP, 0 ,InetSocketAddress (GetLinkParams(cid)->m_ipAddr, START_PORT_NUM+cid));
 	uint8_t ip_tos = 0;
 	ip_tos += m_sliceId << 2;//add slice id (shift 2 bits) to tos.
 	SendByCid(cid, dummyP, (TOS_AC_BE & 0xE0) + (ip_tos & 0x1F));//normal Probe
@@ -3495,11 +3437,11 @@ GmaVirtualInterface::SendEndMarker(uint8_t cid)
 void
 GmaVirtualInterface::SendByCid(uint8_t cid, Ptr<Packet> pkt, uint8_t tos)
 {
-	NS_ASSERT_MSG (m_linkParamsMap.find(cid) != m_linkParamsMap.end(), "this cid doesnot exit");
-	if (m_linkParamsMap[cid]->m_emulateDelay > 0)
+	NS_ASSERT_MSG (m_cidTable->Contains(cid), "this cid doesnot exit");
+	if (GetLinkParams(cid)->m_emulateDelay > 0)
 	{
 		//emulate queueing delay, this might cause out of order.
-    	Simulator::Schedule(MilliSeconds(m_linkParamsMap[cid]->m_emulateDelay), &GmaVirtualInterface::SendByCidNow, this, cid, pkt, tos);
+    	Simulator::Schedule(MilliSeconds(GetLinkParams(cid)->m_emulateDelay), &GmaVirtualInterface::SendByCidNow, this, cid, pkt, tos);
 	}
 	else
 	{
@@ -3517,16 +3459,16 @@ GmaVirtualInterface::SendByCidNow(uint8_t cid, Ptr<Packet> pkt, uint8_t tos)
 
 	if(okeyToTx)
 	{
-		//std::cout << "TX to IP:" << m_linkParamsMap[cid]->m_ipAddr << " port:" <<START_PORT_NUM+cid << "!\n";
-		//m_linkParamsMap[cid]->m_phyAccessContrl->GetSocket()->SendTo (pkt, 0 ,InetSocketAddress (m_linkParamsMap[cid]->m_ipAddr, START_PORT_NUM+cid));
-		NS_ASSERT_MSG(m_linkParamsMap.find(cid) != m_linkParamsMap.end(), " no such cid in the map");
-		if(m_linkParamsMap[cid]->m_phyAccessContrl->SendPacket(pkt, tos))
+		//std::cout << "TX to IP:" << GetLinkParams(cid)->m_ipAddr << " port:" <<START_PORT_NUM+cid << "!\n";
+		//GetLinkParams(cid)->m_phyAccessContrl->GetSocket()->SendTo (pkt, 0 ,InetSocketAddress (GetLinkParams(cid)->m_ipAddr, START_PORT_NUM+cid));
+		NS_ASSERT_MSG(m_cidTable->Contains(cid), " no such cid in the map");
+		if(GetLinkParams(cid)->m_phyAccessContrl->SendPacket(pkt, tos))
 		{
 			//link down flag true
 			m_ctrRto = INITIAL_CONTROL_RTO; //reset rto timer;
 			//IP changed -> Wi-Fi to Wi-Fi handover, we set the control msg failed... Do not use this link until at least one control msg is received from this link.
 			uint8_t oldCid = m_gmaTxControl->GetDeliveryLinkCid();
-			if(m_linkParamsMap[cid]->m_phyAccessContrl->GetLinkDownTime() > Seconds(0))//simulate single radio...
+			if(GetLinkParams(cid)->m_phyAccessContrl->GetLinkDownTime() > Seconds(0))//simulate single radio...
 			{
 				if(m_linkState->CtrlMsgDown(cid))//cid updates
 				{
@@ -3614,9 +3556,9 @@ GmaVirtualInterface::MonitorSniffRx(std::string path,
 	{
 		//std::cout << " addr1: " << wifiHeader.GetAddr1 () << " addr2: " << wifiHeader.GetAddr2 () << " addr3: " << wifiHeader.GetAddr3 () << " addr4: " << wifiHeader.GetAddr4 () <<std::endl;
 		int cellId = -1;
-		if(m_linkParamsMap.find(WIFI_CID) != m_linkParamsMap.end())
+		if(m_cidTable->Contains(WIFI_CID))
 		{
-			cellId = m_linkParamsMap[WIFI_CID]->m_phyAccessContrl->GetApIdFromMacAddr(wifiHeader.GetAddr2 ());//not sure to user addr2 or addr3??
+			cellId = GetLinkParams(WIFI_CID)->m_phyAccessContrl->GetApIdFromMacAddr(wifiHeader.GetAddr2 ());//not sure to user addr2 or addr3??
 		}
 		if (cellId == -1)
 		{
@@ -16,6 +16,10 @@
 #include "gma-tx-control.h"
 #include "link-state.h"
 #include "phy-access-control.h"
+#include "gma-reordering-buffer.h"
+#include "gma-quantile-sketch.h"
+#include "gma-packet-trace.h"
+#include "gma-timer-wheel.h"
 #include <ns3/integer.h>
 #include "ns3/gma-data-processor.h"
 #include "ns3/wifi-module.h"
@@ -110,6 +114,7 @@ private:
 
   //collect measurement results, and generate report
   void CollectMeasureResults();
+  Ptr<NetworkStats> CreateNetworkStats (std::string source, uint64_t ts);
 
   void MeasurementGuardIntervalEnd();
 
@@ -153,23 +158,37 @@ private:
   //we classify data packet based on qos, control packets are all best effort.
   void SendByCid (uint8_t cid, Ptr<Packet> pkt, uint8_t tos); //we emulate queueing delay here, out of order packet might happen here.
   void SendByCidNow (uint8_t cid, Ptr<Packet> pkt, uint8_t tos);
+  void AddGmaDataHeader (Ptr<Packet> packet, uint8_t cid, uint32_t timeStamp, uint8_t flowId); //add the gma header of a data packet sent over this cid.
 
-  //struct queue item for reordering queue. Each packet is tagged with its gma header
-  //and whether it is in order (use GSN diff and LSN diff comparison)
-  struct RxQueueIterm : public SimpleRefCount<RxQueueIterm>
+  // struct link parameters per physic link.
+  struct MeasureParam : public SimpleRefCount<MeasureParam>
+  {
+    uint64_t m_rcvBytes = 0;;
+    uint32_t m_minOwd = UINT32_MAX;
+    uint32_t m_maxOwd = 0;
+    uint64_t m_owdSum = 0;
+    uint64_t m_count = 0;
+    uint64_t m_numOfHighDelayPkt = 0;
+    uint64_t m_numofT1DelayPkt = 0;
+    uint64_t m_numofT2DelayPkt = 0;
+    uint64_t m_numOfInOrderPacketsForReport = 0;
+    uint64_t m_numOfMissingPacketsForReport = 0;
+    uint64_t m_numOfAbnormalPacketsForReport = 0;
+    GmaQuantileSketch m_owdSketch; //owd distribution of this link in the report interval.
+  };
+
+  struct MeasureSn
   {
-    Ptr<Packet> m_packet;
-    GmaHeader m_gmaHeader;
-    bool m_inOrder = false;
-    Time m_receivedTime;
+    uint8_t m_lastLsn = MAX_GMA_LSN;
+    uint64_t m_lastGsn = MAX_GMA_SN;
   };
 
-  // struct link parameters per physic link.
   struct LinkParams : public SimpleRefCount<LinkParams>
   {
     //Ptr<Socket> m_socket; //socket per link
     uint8_t m_gmaTxLocalSn = 0; //lsn per link
-    std::queue< Ptr<RxQueueIterm> > m_reorderingQueue; //reordering queue per link
+    GmaHeader m_txGmaHeader; //gma header of the data packets sent over this link, the cid is set once.
+    uint32_t m_reorderingCount = 0; //number of packets from this link in the reordering buffer
     uint8_t m_gmaRxLastLocalSn = 255; //LSN of last received packet from this link;
     uint32_t m_gmaRxLastSn = MAX_GMA_SN;//SN of last received packet from this link;
     //Ipv4Address m_ipAddr; //ip address per link
@@ -178,6 +197,8 @@ private:
     Ptr<PhyAccessControl> m_phyAccessContrl;
     double m_qosMarking = 0.0; //0 for false, 1 for true
     uint32_t m_emulateDelay = 0; //unit ms
+    MeasureParam m_measureParam; //measurement of this link in the report interval, m_count is 0 if nothing is received.
+    MeasureSn m_measureSn; //last in order lsn and sn of this link, for the loss in the report.
   };
 
   uint32_t m_gmaTxSn = 0; //sender tx gma sn per flow
@@ -190,11 +211,18 @@ private:
 
   uint16_t m_maxTsuSeqNum = 0; // the max sn of TSU message.
 
-  std::map < uint8_t, Ptr<LinkParams> > m_linkParamsMap; // a map of link parameters, the key is the cid of that link
+  std::map < uint8_t, Ptr<LinkParams> > m_linkParamsMap; // a map of link parameters, the key is the cid of that link, iterated in the order of cid.
+  Ptr<CidTable> m_cidTable; //cid to slot table shared with the link state and the measurement manager.
+  std::vector< Ptr<LinkParams> > m_linkParamsList; //link parameters indexed by the slot of the cid, for the per packet lookups.
+  void AddLinkParams (uint8_t cid, Ptr<LinkParams> linkParams);
+  const Ptr<LinkParams>& GetLinkParams (uint8_t cid);
 
   Callback<void, Ptr<Packet> > m_forwardPacketCallback; //callback that sends packet to GMA to transmit
 
-  uint32_t m_totalQueueSize = 0; //number of packets in all of the reordering queues combined.
+  GmaReorderingBuffer m_reorderingBuffer; //out of order packets of all links, indexed by sn.
+  uint32_t m_reorderingLinkCount = 0; //number of links with packets in the reordering buffer.
+  void EnqueueReorderingPacket (uint8_t cid, Ptr<Packet> packet, const GmaHeader& gmaHeader, bool inOrder); //buffer an out of order packet received from this cid.
+  void DequeueReorderingPacket (GmaReorderingBuffer::Slot& slot); //move the packet with the min sn out of the reordering buffer.
 
   //in andorid app, the value of timeout is configured use the 2*(MAX OWD of all links - MIN OWD of all links)!!!!
   //change it after we do the wifi offset measurement
@@ -202,20 +230,21 @@ private:
   const Time MIN_REORDERING_TIMEOUT = MilliSeconds(10);
   Time m_reorderingTimeout = MAX_REORDERING_TIMEOUT;//initial value
 
-  EventId m_reorderingTimeoutEvent;
+  GmaTimerWheel::TimerId m_reorderingTimeoutEvent;
 
-  EventId m_stopReorderEvent;
+  GmaTimerWheel::TimerId m_stopReorderEvent;
 
   //tag send time and retx attempts with a control header. C-SN is the key to get this item
   struct TexedCtrQueueItem : public SimpleRefCount<TexedCtrQueueItem>
   {
     MxControlHeader m_mxControlHeader;
     std::map <uint16_t, Time> m_csnToTxtimeMap;
+    GmaTimerWheel::TimerId m_retxTimer; //canceled when the ack is received.
   };
 
   std::map<uint16_t, Ptr<TexedCtrQueueItem> > m_txedCtrQueue; //stores the contorl messages waiting for ACKS, key = control SN
 
-  EventId m_periodicProbeEvent;
+  GmaTimerWheel::TimerId m_periodicProbeEvent;
 
   Time m_ctrRto; // waiting time before a retx timeout
 
@@ -232,6 +261,7 @@ private:
 
   Ptr<GmaRxControl> m_gmaRxControl;
   Ptr<GmaTxControl> m_gmaTxControl;
+  Ptr<GmaTimerWheel> m_timerWheel; //the probe, control msg retx, reordering and qos testing timers.
 
   bool m_txMode = false;
   bool m_rxMode = false;
@@ -240,36 +270,19 @@ private:
 
   bool m_enableMeasureReport = false;
   bool m_saveToFile = true;
+  std::string m_packetTraceFile; //prefix of the per packet trace file, empty if disabled.
+  Ptr<GmaPacketTrace> m_packetTrace; //null if the per packet trace is disabled.
+  std::string m_decisionTraceFile; //prefix of the decision trace file, empty if disabled.
 
   bool m_fileTile = false;
   uint64_t m_receivedBytes = 0;
   uint64_t m_reorderingTimeoutCounter = 0;
   uint64_t m_tsuCounter = 0;
 
-  struct MeasureParam : public SimpleRefCount<MeasureParam>
-  {
-    uint64_t m_rcvBytes = 0;;
-    uint32_t m_minOwd = UINT32_MAX;
-    uint32_t m_maxOwd = 0;
-    uint64_t m_owdSum = 0;
-    uint64_t m_count = 0;
-    uint64_t m_numOfHighDelayPkt = 0;
-    uint64_t m_numofT1DelayPkt = 0;
-    uint64_t m_numofT2DelayPkt = 0;
-    uint64_t m_numOfInOrderPacketsForReport = 0;
-    uint64_t m_numOfMissingPacketsForReport = 0;
-    uint64_t m_numOfAbnormalPacketsForReport = 0;
-  };
-
-  struct MeasureSn : public SimpleRefCount<MeasureSn>
-  {
-    uint8_t m_lastLsn = MAX_GMA_LSN;
-    uint64_t m_lastGsn = MAX_GMA_SN;
-  };
-
-
-  std::map < uint8_t, Ptr<MeasureParam> > m_measureParamPerCidMap;
-  std::map < uint8_t, Ptr<MeasureSn> > m_measureSnPerCidMap;
+  void ResetMeasureParams (); //clear the measurement of all links at the end of a report interval.
+  uint32_t m_measuredLinkCount = 0; //number of links with a measurement (m_count > 0) in the report interval.
+  uint32_t m_intervalMinOwd = UINT32_MAX; //min of m_minOwd of all links, updated per packet.
+  uint32_t m_intervalMaxOwd = 0; //max of m_maxOwd of all links, updated per packet.
 
 
   uint16_t m_gmaInterfaceId = 0;
@@ -0,0 +1,96 @@
+/* Copyright(C) 2024 Intel Corporation
+*  SPDX-License-Identifier: GPL-2.0
+*  https://spdx.org/licenses/GPL-2.0.html
+*/
+
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+
+#include "gma-windowed-filter.h"
+#include <algorithm>
+
+namespace ns3 {
+
+GmaWindowedFilter::GmaWindowedFilter (Type type)
+  : m_type (type)
+{
+}
+
+void
+GmaWindowedFilter::SetWindow (uint32_t windowMs)
+{
+  m_slotMs = std::max (1u, windowMs / NUM_SLOTS);
+  m_windowMs = m_slotMs * NUM_SLOTS;
+  Clear ();
+}
+
+uint32_t
+GmaWindowedFilter::GetWindow () const
+{
+  return m_windowMs;
+}
+
+bool
+GmaWindowedFilter::IsBetter (uint32_t value, uint32_t other) const
+{
+  return m_type == MIN ? value <= other : value >= other;
+}
+
+void
+GmaWindowedFilter::Expire (int64_t slot)
+{
+  //a sample stays in the window for NUM_SLOTS slots after the slot it is measured in.
+  while (m_size > 0 && m_sampleList[m_head].m_slot + NUM_SLOTS < slot)
+  {
+    m_head = (m_head + 1) & (CAPACITY - 1);
+    m_size--;
+  }
+}
+
+void
+GmaWindowedFilter::Update (uint32_t value, int64_t nowMs)
+{
+  int64_t slot = nowMs / m_slotMs;
+  Expire (slot);
+
+  //the older samples that are not better than the new one can never be the min (max) again.
+  while (m_size > 0)
+  {
+    uint32_t tail = (m_head + m_size - 1) & (CAPACITY - 1);
+    if (!IsBetter (value, m_sampleList[tail].m_value))
+    {
+      break;
+    }
+    m_size--;
+  }
+
+  if (m_size > 0 && m_sampleList[(m_head + m_size - 1) & (CAPACITY - 1)].m_slot == slot)
+  {
+    //a better sample of the same slot is already stored, and it expires at the same time as this one.
+    return;
+  }
+
+  Sample& sample = m_sampleList[(m_head + m_size) & (CAPACITY - 1)];
+  sample.m_slot = slot;
+  sample.m_value = value;
+  m_size++;
+}
+
+uint32_t
+GmaWindowedFilter::Get (int64_t nowMs)
+{
+  Expire (nowMs / m_slotMs);
+  if (m_size == 0)
+  {
+    return m_type == MIN ? UINT32_MAX : 0;
+  }
+  return m_sampleList[m_head].m_value;
+}
+
+void
+GmaWindowedFilter::Clear ()
+{
+  m_head = 0;
+  m_size = 0;
+}
+
+}
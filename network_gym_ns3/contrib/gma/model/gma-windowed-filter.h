@@ -0,0 +1,55 @@
+/* Copyright(C) 2024 Intel Corporation
+*  SPDX-License-Identifier: GPL-2.0
+*  https://spdx.org/licenses/GPL-2.0.html
+*/
+
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+#ifndef GMA_WINDOWED_FILTER_H
+#define GMA_WINDOWED_FILTER_H
+
+#include <stdint.h>
+#include <array>
+
+namespace ns3 {
+
+//sliding window min (or max) of delay samples (ms), kept in a monotonic queue. The window is divided into
+//NUM_SLOTS time slots and the samples of the same slot are merged, so the queue never holds more than
+//NUM_SLOTS + 1 entries. Update and Get are amortized O(1). The window length is rounded to a multiple of the slot.
+class GmaWindowedFilter
+{
+public:
+  enum Type
+  {
+    MIN = 0,
+    MAX = 1
+  };
+
+  GmaWindowedFilter (Type type);
+  void SetWindow (uint32_t windowMs); //also clears the samples.
+  uint32_t GetWindow () const;
+  void Update (uint32_t value, int64_t nowMs);
+  uint32_t Get (int64_t nowMs); //return UINT32_MAX (MIN filter) or 0 (MAX filter) if no sample is in the window.
+  void Clear ();
+
+  static const uint32_t NUM_SLOTS = 32;
+private:
+  struct Sample
+  {
+    int64_t m_slot;
+    uint32_t m_value;
+  };
+  bool IsBetter (uint32_t value, uint32_t other) const; //return true if value replaces other, e.g., value <= other for a MIN filter.
+  void Expire (int64_t slot); //remove the samples that are older than the window.
+
+  static const uint32_t CAPACITY = 64; //power of 2 and larger than NUM_SLOTS + 1.
+  std::array<Sample, CAPACITY> m_sampleList; //ring buffer, the values are monotonic from the head to the tail.
+  uint32_t m_head = 0;
+  uint32_t m_size = 0;
+  Type m_type;
+  uint32_t m_windowMs = 12000;
+  uint32_t m_slotMs = 12000 / NUM_SLOTS;
+};
+
+}
+
+#endif /* GMA_WINDOWED_FILTER_H */
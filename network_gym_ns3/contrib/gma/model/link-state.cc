@@ -6,6 +6,7 @@
 /* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
 
 #include "link-state.h"
+#include <algorithm>
 
 namespace ns3 {
 
@@ -13,9 +14,58 @@ NS_LOG_COMPONENT_DEFINE ("LinkState");
 
 NS_OBJECT_ENSURE_REGISTERED (LinkState);
 
+CidTable::CidTable ()
+{
+  m_cidToSlot.fill (NO_SLOT);
+}
+
+uint8_t
+CidTable::Add (uint8_t cid)
+{
+  if (m_cidToSlot[cid] == NO_SLOT)
+  {
+    NS_ASSERT_MSG (m_cidList.size () < NO_SLOT, "too many links");
+    m_cidToSlot[cid] = m_cidList.size ();
+    m_cidList.push_back (cid);
+  }
+  return m_cidToSlot[cid];
+}
+
+bool
+CidTable::Contains (uint8_t cid) const
+{
+  return m_cidToSlot[cid] != NO_SLOT;
+}
+
+uint8_t
+CidTable::GetSlot (uint8_t cid) const
+{
+  return m_cidToSlot[cid];
+}
+
+uint8_t
+CidTable::GetCid (uint8_t slot) const
+{
+  return m_cidList.at (slot);
+}
+
+uint8_t
+CidTable::GetSize () const
+{
+  return m_cidList.size ();
+}
+
+const std::vector<uint8_t>&
+CidTable::GetCidList () const
+{
+  return m_cidList;
+}
+
 LinkState::LinkState ()
 {
   NS_LOG_FUNCTION (this);
+  m_cidTable = Create<CidTable> ();
+  m_linkDownFlags.fill (0);
 }
 
 
@@ -71,18 +121,24 @@ LinkState::SetFixedDefaultCid(uint8_t cid)
 bool
 LinkState::IsLinkUp(uint8_t cid)
 {
-	if(m_ctrFailedLinkMap.find(cid) == m_ctrFailedLinkMap.end() 
-		&& m_lowQualityLinkMap.find(cid) == m_lowQualityLinkMap.end()
-		 && m_bitmapFailedLinkMap.find(cid) == m_bitmapFailedLinkMap.end())
-	{
-		//this link is not failed, not low quality, nor tsu indicate down, --> link should be up
-		return true;
-	}
-	else
-	{
-		//this link is either low quality, failed, or tsu indicate down -> this link should be down
-		return false;
-	}
+	//this link is not failed, not low quality, nor tsu indicate down, --> link should be up
+	return m_linkDownFlags[cid] == 0;
+}
+
+bool
+LinkState::LinkDown(uint8_t cid, uint8_t flag)
+{
+	bool newFlag = (m_linkDownFlags[cid] & flag) == 0;
+	m_linkDownFlags[cid] |= flag;
+	return newFlag;
+}
+
+bool
+LinkState::LinkUp(uint8_t cid, uint8_t flag)
+{
+	bool oldFlag = (m_linkDownFlags[cid] & flag) != 0;
+	m_linkDownFlags[cid] &= ~flag;
+	return oldFlag;
 }
 
 void
@@ -103,16 +159,16 @@ LinkState::CtrlMsgDown(uint8_t cid)
 	bool update = false;
 	if(IsLinkUp(cid))//if link is still up, need to set it as down!
 	{
-		m_ctrFailedLinkMap[cid] = true;//set this link as failed, m_linkState->IsLinkUp will return false now
+		LinkDown(cid, CTRL_FAILED);//set this link as failed, m_linkState->IsLinkUp will return false now
 		std::cout <<  "!!!!!!!!!!!!!!!!!!!!!!!!!node:" << +m_nodeId << " cid:" << +cid << " control message retx failed or no data -> LINK DOWN\n";
 		update = UpdateDefaultLink();
 	}
 	else
 	{
-		if(m_ctrFailedLinkMap.find(cid) == m_ctrFailedLinkMap.end())
+		if((m_linkDownFlags[cid] & CTRL_FAILED) == 0)
 		{
 			std::cout <<  "!!!!!!!!!!!!!!!!!!!!!!!!!node:" << +m_nodeId << " cid:" << +cid << " control message retx failed or no data \n";
-			m_ctrFailedLinkMap[cid] = true;//set this link as failed, m_linkState->IsLinkUp will return false now
+			LinkDown(cid, CTRL_FAILED);//set this link as failed, m_linkState->IsLinkUp will return false now
 		}
 	}
 	return update;
@@ -124,10 +180,8 @@ LinkState::CtrlMsgUp(uint8_t cid)
 	bool update = false;
 	if(!IsLinkUp(cid))//link is down
 	{
-		if(m_ctrFailedLinkMap.find(cid) != m_ctrFailedLinkMap.end())
+		if(LinkUp(cid, CTRL_FAILED))//this will not mark this link as down for this reason any more
 		{
-			m_ctrFailedLinkMap.erase(cid);//this will not mark this link as failed link any more
-
 			if(IsLinkUp(cid))//if the link is up ,we need to notify the control
 			{
 				std::cout <<  "!!!!!!!!!!!!!!!!!!!!!!!!!node:" << +m_nodeId << " cid:" << +cid << " control message received -> LINK UP\n";
@@ -149,7 +203,7 @@ LinkState::LowRssiDown(uint8_t cid)
 	bool update = false;
 	if(IsLinkUp(cid))//if link is still up, need to set it as down!
 	{
-		m_lowQualityLinkMap[cid] = true;//set this link as low quality, m_linkState->IsLinkUp will return false now
+		LinkDown(cid, LOW_QUALITY);//set this link as low quality, m_linkState->IsLinkUp will return false now
 		std::cout << Now().GetSeconds() <<  "!!!!!!!!!!!!!!!!!!!!!!!!!node:" << +m_nodeId << " cid:" << +cid <<  ". RSSI low -> LINK DOWN\n";
 		update = UpdateDefaultLink();
 		//Ptr<SplittingDecision> decision = m_gmaRxControl->LinkDown(cid);
@@ -163,10 +217,10 @@ LinkState::LowRssiDown(uint8_t cid)
 	else
 	{
 		//link is already down.
-		if(m_lowQualityLinkMap.find(cid) == m_lowQualityLinkMap.end())
+		if((m_linkDownFlags[cid] & LOW_QUALITY) == 0)
 		{
 			std::cout << Now().GetSeconds() <<  "!!!!!!!!!!!!!!!!!!!!!!!!!node:" << +m_nodeId << " cid:" << +cid << ". RSSI low\n";
-			m_lowQualityLinkMap[cid] = true;//set this link as low quality, m_linkState->IsLinkUp will return false now
+			LinkDown(cid, LOW_QUALITY);//set this link as low quality, m_linkState->IsLinkUp will return false now
 		}
 	}
 	return update;
@@ -179,10 +233,8 @@ LinkState::HighRssiUp(uint8_t cid)
 	if(!IsLinkUp(cid))//link is down
 	{
 		//signal strength is high, this link is not low quality anymore.
-		if(m_lowQualityLinkMap.find(cid) != m_lowQualityLinkMap.end())
+		if(LinkUp(cid, LOW_QUALITY))//this will not mark this link as down for this reason any more
 		{
-			m_lowQualityLinkMap.erase(cid);//this will not mark this link as low quality any more.
-
 			if(IsLinkUp(cid))//if the link is up ,we need to notify the control
 			{
 				std::cout << Now().GetSeconds() <<  "!!!!!!!!!!!!!!!!!!!!!!!!!node:" << +m_nodeId << " cid:" << +cid << ". RSSI high -> LINK UP\n";
@@ -211,16 +263,16 @@ LinkState::LinkBitMapDown(uint8_t cid)
 	if(IsLinkUp(cid))//if wifi link is still up, need to set it as down!
 	{
 
-		m_bitmapFailedLinkMap[cid] = true;//set this link as failed, m_linkState->IsLinkUp will return false now
+		LinkDown(cid, BITMAP_FAILED);//set this link as failed, m_linkState->IsLinkUp will return false now
 		std::cout <<  "!!!!!!!!!!!!!!!!!!!!!!!!!node:" << +m_nodeId << " cid:" << +cid << " Link Bit Map DOWN -> LINK DOWN\n";
 		update = UpdateDefaultLink();
 	}
 	else
 	{
-		if(m_bitmapFailedLinkMap.find(cid) == m_bitmapFailedLinkMap.end())
+		if((m_linkDownFlags[cid] & BITMAP_FAILED) == 0)
 		{
 			std::cout <<  "!!!!!!!!!!!!!!!!!!!!!!!!!node:" << +m_nodeId << " cid:" << +cid << " Link Bit Map Down.\n";
-			m_bitmapFailedLinkMap[cid] = true;//set this link as failed, m_linkState->IsLinkUp will return false now
+			LinkDown(cid, BITMAP_FAILED);//set this link as failed, m_linkState->IsLinkUp will return false now
 		}
 	}
 	return update;
@@ -234,10 +286,8 @@ LinkState::LinkBitMapUp(uint8_t cid)
 	if(!IsLinkUp(cid))//link is down
 	{
 
-		if(m_bitmapFailedLinkMap.find(cid) != m_bitmapFailedLinkMap.end())
+		if(LinkUp(cid, BITMAP_FAILED))//this will not mark this link as down for this reason any more
 		{
-			m_bitmapFailedLinkMap.erase(cid);//this will not mark this link as failed link any more
-
 			if(IsLinkUp(cid))//if the link is up ,we need to notify the control
 			{
 				std::cout <<  "!!!!!!!!!!!!!!!!!!!!!!!!!node:" << +m_nodeId << " cid:" << +cid << " Link Bit Map UP -> LINK UP\n";
@@ -267,15 +317,16 @@ LinkState::UpdateDefaultLink()
 	uint8_t minOkCid = UINT8_MAX;
 	int maxOkCid = -1;
 
-	for (uint8_t ind = 0; ind < m_cidList.size(); ind++)//find a link with min cid still ok as default
+	const std::vector<uint8_t>& cidList = m_cidTable->GetCidList();
+	for (uint8_t ind = 0; ind < cidList.size(); ind++)//find a link with min cid still ok as default
 	{
-		if(IsLinkUp(m_cidList.at(ind)) && (int)m_cidList.at(ind) > maxOkCid)
+		if(IsLinkUp(cidList.at(ind)) && (int)cidList.at(ind) > maxOkCid)
 		{
-			maxOkCid = m_cidList.at(ind);
+			maxOkCid = cidList.at(ind);
 		}
-		if(IsLinkUp(m_cidList.at(ind)) && m_cidList.at(ind) < minOkCid)
+		if(IsLinkUp(cidList.at(ind)) && cidList.at(ind) < minOkCid)
 		{
-			minOkCid = m_cidList.at(ind);
+			minOkCid = cidList.at(ind);
 		}
 	}
 	
@@ -317,14 +368,30 @@ void
 LinkState::AddLinkCid(uint8_t cid)
 {
 	std::cout << "Link State add link cid:" << +cid << "\n";
-	m_cidList.push_back(cid);
-	m_cidToIndexMap[cid]=m_cidList.size()-1;
+	uint8_t slot = m_cidTable->Add(cid);
+	if (slot >= m_skipUntilMs.size())
+	{
+		m_skipUntilMs.resize(slot + 1, -1);
+	}
 }
 
-std::vector<uint8_t> 
+const std::vector<uint8_t>&
 LinkState::GetCidList()
 {
-	return m_cidList;
+	return m_cidTable->GetCidList();
+}
+
+Ptr<CidTable>
+LinkState::GetCidTable()
+{
+	return m_cidTable;
+}
+
+uint8_t
+LinkState::GetLinkIndex(uint8_t cid)
+{
+	NS_ASSERT_MSG(m_cidTable->Contains(cid), "this cid is not added");
+	return m_cidTable->GetSlot(cid);
 }
 
 
@@ -400,48 +467,43 @@ void
 LinkState::UpdateLinkQueueingDelay (std::vector<uint8_t> queueingDelayVector)
 {
 	//we skip a link for a duration that equals the queueing delay to drain the queue.
-	NS_ASSERT_MSG(queueingDelayVector.size() == m_cidList.size(), "The size of the delay measurement and cid list is not the same.");
+	const std::vector<uint8_t>& cidList = m_cidTable->GetCidList();
+	NS_ASSERT_MSG(queueingDelayVector.size() == cidList.size(), "The size of the delay measurement and cid list is not the same.");
 
-	std::cout << Now().GetMilliSeconds() << " [cid, drain delay, expire time]: ";
-	for (uint8_t link = 0; link < m_cidList.size(); link++)
+	int64_t nowMs = Now().GetMilliSeconds();
+	std::cout << nowMs << " [cid, drain delay, expire time]: ";
+	for (uint8_t link = 0; link < cidList.size(); link++)
 	{
 		if(queueingDelayVector.at(link) != UINT8_MAX && queueingDelayVector.at(link) > 0) //queuing delay available.
 		{
 			uint8_t drainTime = queueingDelayVector.at(link);
-			m_skipCidMap[m_cidList.at(link)] = Now().GetMilliSeconds() + drainTime;
-			std::cout << "[" << +m_cidList.at(link) << ", " <<+drainTime <<", "  << +m_skipCidMap[m_cidList.at(link)] << "] ";
+			if (m_skipUntilMs[link] < 0)
+			{
+				m_skipCount++;
+			}
+			m_skipUntilMs[link] = nowMs + drainTime;
+			std::cout << "[" << +cidList.at(link) << ", " <<+drainTime <<", "  << m_skipUntilMs[link] << "] ";
 		}
 		else
 		{
-			if (m_skipCidMap.find(m_cidList.at(link)) != m_skipCidMap.end())//find map from previous update
+			if (m_skipUntilMs[link] >= 0)//find map from previous update
 			{
-				if(m_skipCidMap[m_cidList.at(link)] < Now().GetMilliSeconds() )//map already expired
-				{
-					//already expired map, we can remove it now.
-					m_skipCidMap.erase(m_cidList.at(link));
-				}
-				else
+				if(m_skipUntilMs[link] >= nowMs)//map not expired yet
 				{
 					//we receive a not synced tsu, may due to link down or link up.
-					std::cout << "This should only happen after link is up or link down. time: " << Now().GetMilliSeconds () <<  std::endl;
-
-					//remove the delay
-					m_skipCidMap.erase(m_cidList.at(link));
-					/*auto iterS = m_skipCidMap.begin();
-					while (iterS!=m_skipCidMap.end())
-					{
-						std::cout << " cid: " << +iterS->first << " value: " << iterS->second << std::endl;
-						iterS++;
-					}*/
+					std::cout << "This should only happen after link is up or link down. time: " << nowMs <<  std::endl;
 				}
+				//remove the delay
+				m_skipUntilMs[link] = -1;
+				m_skipCount--;
 			}
-			std::cout << "[" << +m_cidList.at(link) << ", " <<+queueingDelayVector.at(link) <<", NA] ";
+			std::cout << "[" << +cidList.at(link) << ", " <<+queueingDelayVector.at(link) <<", NA] ";
 		}
 
 	}
 	std::cout << std::endl;	
 
-	if (m_skipCidMap.size() == m_cidList.size())
+	if (m_skipCount == cidList.size())
 	{
 		NS_FATAL_ERROR("cannot have all link be skipped!!!!");
 	}
@@ -450,20 +512,19 @@ LinkState::UpdateLinkQueueingDelay (std::vector<uint8_t> queueingDelayVector)
 bool
 LinkState::IsLinkLowQueueingDelay(uint8_t cid)
 {
-	if (m_skipCidMap.find(cid) == m_skipCidMap.end())//link is not in the skip map
+	uint8_t slot = m_cidTable->GetSlot(cid);
+	if (slot == CidTable::NO_SLOT || m_skipUntilMs[slot] < 0)//link is not skipped
 	{
 		//link is not skipped, therefore the queueing delay is low
 		return true;
 	}
-	else
+	//link is skipped, check if it is expired
+	if(m_skipUntilMs[slot] <= Now().GetMilliSeconds() )//already expired
 	{
-		//found link in skip map, check if map is expired
-		if(m_skipCidMap[cid] <= Now().GetMilliSeconds() )//map already expired
-		{
-			//already expired map, we can remove it now.
-			m_skipCidMap.erase(cid);
-			return true; //the queue should be drained, and the queueing delay is low
-		}
+		//already expired, we can remove it now.
+		m_skipUntilMs[slot] = -1;
+		m_skipCount--;
+		return true; //the queue should be drained, and the queueing delay is low
 	}
 	return false;//high queueing delay.
 }
@@ -471,7 +532,8 @@ LinkState::IsLinkLowQueueingDelay(uint8_t cid)
 void
 LinkState::StopLinkSkipping ()
 {
-	m_skipCidMap.clear();
+	std::fill(m_skipUntilMs.begin(), m_skipUntilMs.end(), -1);
+	m_skipCount = 0;
 }
 
 }
@@ -12,6 +12,7 @@
 #include <ns3/virtual-net-device.h>
 #include "mx-control-header.h"
 #include <ns3/integer.h>
+#include <array>
 
 namespace ns3 {
 
@@ -20,6 +21,24 @@ const int WIFI_CID = 0; //CID for Wi-Fi.
 const int CELLULAR_NR_CID = 2; //CID for 5G NR.
 const int CELLULAR_LTE_CID = 11; //CID for 4G LTE. //by default, larger cid -> higher priority
 
+//dense table from the cid of a link to its slot. Slots are assigned in the order the links are added,
+//so per link state can be stored in vectors indexed by the slot instead of maps keyed by the cid.
+class CidTable : public SimpleRefCount<CidTable>
+{
+public:
+  CidTable ();
+  uint8_t Add (uint8_t cid); //return the slot of this cid, a new slot is assigned if the cid is not added yet.
+  bool Contains (uint8_t cid) const;
+  uint8_t GetSlot (uint8_t cid) const; //return NO_SLOT if the cid is not added.
+  uint8_t GetCid (uint8_t slot) const;
+  uint8_t GetSize () const;
+  const std::vector<uint8_t>& GetCidList () const; //cid of each slot.
+  static const uint8_t NO_SLOT = UINT8_MAX;
+private:
+  std::array<uint8_t, 256> m_cidToSlot;
+  std::vector<uint8_t> m_cidList;
+};
+
 class LinkState : public Object
 {
 public:
@@ -43,7 +62,9 @@ public:
   bool UpdateDefaultLink();
 
   void AddLinkCid (uint8_t cid);
-  std::vector<uint8_t> GetCidList();
+  const std::vector<uint8_t>& GetCidList();
+  Ptr<CidTable> GetCidTable (); //the cid table shared by the modules of this interface.
+  uint8_t GetLinkIndex (uint8_t cid); //index of the cid in the cid list.
   uint8_t GetHighPriorityLinkCid ();
   uint8_t GetLowPriorityLinkCid ();
 
@@ -53,7 +74,6 @@ public:
   uint8_t m_qosTestDurationUnit100ms = 100;//duration for qos testing
   const Time MIN_QOS_TESTING_INTERVAL = Seconds (5); //min time between 2 failed QoS testing request.
   const Time MAX_QOS_VALID_INTERVAL = Seconds (5); //for idle flow, we assume the link still meet the qos requirement within this interval.
-  std::map<uint8_t, uint8_t> m_cidToIndexMap;//get the index from cid
   //convert format from int to string
   static std::string ConvertCidFormat(int cid);
   //convert format from string to int
@@ -64,13 +84,19 @@ public:
 private:
   uint8_t m_highPriorityLinkCid = CELLULAR_LTE_CID;
   uint8_t m_lowPriorityLinkCid = WIFI_CID;
-  std::map<uint8_t, bool> m_ctrFailedLinkMap;  //input cid, return true means link is failed
-  std::map<uint8_t, bool> m_lowQualityLinkMap;  //input cid, return true means link quality (signal strength) is low
-  std::map<uint8_t, bool> m_bitmapFailedLinkMap;// input cid, return true means link is set down by TSU, we only alow one side to set link map in the TSU, and the other side the read from it
-  std::map<uint8_t, uint32_t> m_skipCidMap; //the key is the cid, the value is when to start sending packet again. if current time < the map value, skip this link.
+  //reasons of a link down, stored as bits per cid. The link is up if no bit is set.
+  static const uint8_t CTRL_FAILED = 1; //control message failed.
+  static const uint8_t LOW_QUALITY = 2; //link quality (signal strength) is low.
+  static const uint8_t BITMAP_FAILED = 4; //link is set down by TSU, we only alow one side to set link map in the TSU, and the other side the read from it
+  std::array<uint8_t, 256> m_linkDownFlags;
+  bool LinkDown (uint8_t cid, uint8_t flag); //set the down flag, return true if it is newly set.
+  bool LinkUp (uint8_t cid, uint8_t flag); //clear the down flag, return true if it was set.
+
+  std::vector<int64_t> m_skipUntilMs; //indexed by the slot, when to start sending packet again (-1 if the link is not skipped). if current time < the value, skip this link.
+  uint8_t m_skipCount = 0; //number of skipped links.
   uint32_t m_nodeId = 0;
   bool m_fixDefaultLink = false;
-  std::vector<uint8_t> m_cidList; //the list of cid for connected physic links
+  Ptr<CidTable> m_cidTable; //the list of cid for connected physic links
   bool m_preferLargeCidValue = false; //if true: large the cid -> high priority.
 };
 
@@ -73,6 +73,10 @@ MeasureDevice::UpdateLastPacketOwd(uint32_t owdMs, bool dataFlag)
 	//uint32_t currentTimeMs = Now().GetMilliSeconds();
 	m_lastPacketOwd = owdMs;
 
+	int64_t nowMs = Now().GetMilliSeconds();
+	m_minOwdWindow.Update(owdMs, nowMs);
+	m_maxOwdWindow.Update(owdMs, nowMs);
+
 	if (m_currentMinOwd > owdMs)
 	{
 		m_currentMinOwd = owdMs;
@@ -122,12 +126,21 @@ MeasureDevice::UpdateRtt (uint32_t rtt, uint32_t owd)
 
 	m_rtt = rtt;
 	m_owdSamePktOfRtt = owd;
+	m_maxRttWindow.Update(rtt, Now().GetMilliSeconds());
 	//std::cout << " now: " << Now().GetSeconds() << " last update: " << m_lastRttUpdateTime.GetSeconds() << "------------ m_rtt:" << m_rtt
 	//<< " m_owdSamePktOfRtt:" << m_owdSamePktOfRtt << " cid: " << LinkState::ConvertCidFormat(m_cid)
 	//<< std::endl; 
 	m_lastRttUpdateTime = Now();
 }
 
+void
+MeasureDevice::SetWindow (Time window)
+{
+	m_minOwdWindow.SetWindow(window.GetMilliSeconds());
+	m_maxOwdWindow.SetWindow(window.GetMilliSeconds());
+	m_maxRttWindow.SetWindow(window.GetMilliSeconds());
+}
+
 uint32_t
 MeasureDevice::GetRtt ()
 {
@@ -161,16 +174,17 @@ MeasureDevice::UpdateLsn(uint8_t lastLsn)
 	else
 	{
 		//determing in order or not
-		if(LsnDiff(lastLsn, m_lastLsn) == 1)
+		int lsnDiff = LsnDiff(lastLsn, m_lastLsn);
+		if(lsnDiff == 1)
 		{
 			// in order packets
 			m_numOfInOrderPacketsPerCycle++;
 			m_lastLsn = lastLsn;
 		}
-		else if(LsnDiff(lastLsn, m_lastLsn) > 1)
+		else if(lsnDiff > 1)
 		{
 			// detect a gap: received Lsn larger than expected value.
-			m_numOfMissingPacketsPerCycle = m_numOfMissingPacketsPerCycle + LsnDiff(lastLsn, m_lastLsn)-1;
+			m_numOfMissingPacketsPerCycle = m_numOfMissingPacketsPerCycle + lsnDiff-1;
 			m_numOfInOrderPacketsPerCycle++;
 			m_lastLsn = lastLsn;
 		}
@@ -204,6 +218,7 @@ MeasurementManager::MeasurementManager ()
 	NS_LOG_FUNCTION (this);
 	m_sendTsuCallback = MakeNullCallback<void, Ptr<SplittingDecision> > ();
 	m_delayMeasurementEvent.Cancel();
+	m_cidTable = Create<CidTable> ();
 }
 
 TypeId
@@ -223,6 +238,11 @@ MeasurementManager::GetTypeId (void)
 			BooleanValue (true),
 			MakeBooleanAccessor (&MeasurementManager::m_senderSideOwdAdjustment),
 			MakeBooleanChecker ())
+	.AddAttribute ("OwdWindow",
+			"the window of the sliding window min and max owd (and max rtt) of each link, e.g., used by the reordering timeout",
+			TimeValue (Seconds (12.0)),
+			MakeTimeAccessor (&MeasurementManager::m_owdWindow),
+			MakeTimeChecker ())
   ;
   return tid;
 }
@@ -236,28 +256,53 @@ void
 MeasurementManager::AddDevice (uint8_t cid)
 {
 	Ptr<MeasureDevice> device = CreateObject<MeasureDevice> (cid);
-	m_deviceList.push_back(device);
+	AddDevice(device);
 }
 
 void
 MeasurementManager::AddDevice (uint8_t cid, uint32_t owdTarget)
 {
 	Ptr<MeasureDevice> device = CreateObject<MeasureDevice> (cid, owdTarget, m_rxControl->GetQueueingDelayTargetMs());
+	AddDevice(device);
+}
+
+void
+MeasurementManager::AddDevice (Ptr<MeasureDevice> device)
+{
+	//the device list is indexed by the slot of the cid.
+	uint8_t slot = m_cidTable->Add(device->GetCid());
+	NS_ASSERT_MSG(slot == m_deviceList.size(), "the devices should be added in the same order as the links.");
+	device->SetWindow(m_owdWindow);
 	m_deviceList.push_back(device);
 }
 
+void
+MeasurementManager::SetCidTable (Ptr<CidTable> cidTable)
+{
+	NS_ASSERT_MSG(m_deviceList.empty(), "the cid table should be set before adding devices.");
+	m_cidTable = cidTable;
+}
+
+int
+MeasurementManager::GetDeviceIndex (uint8_t cid)
+{
+	uint8_t slot = m_cidTable->GetSlot(cid);
+	if (slot >= m_deviceList.size())//not added, or the link is added but not the device yet
+	{
+		return -1;
+	}
+	return slot;
+}
+
 Ptr<MeasureDevice>
 MeasurementManager::GetDevice(uint8_t cid)
 {
-	for (uint8_t index = 0; index < m_deviceList.size(); index++)
+	int index = GetDeviceIndex(cid);
+	if (index < 0)
 	{
-		if (m_deviceList.at(index)->GetCid() == cid)
-		{
-			return m_deviceList.at(index);
-		}
+		NS_FATAL_ERROR("cannot find the device!!!!!");
 	}
-	NS_FATAL_ERROR("cannot find the device!!!!!");
-	return Ptr<MeasureDevice>();
+	return m_deviceList[index];
 }
 
 bool
@@ -275,27 +320,22 @@ MeasurementManager::DisableMeasurement()
 void
 MeasurementManager::DataMeasurementSample(uint32_t owdMs, uint8_t lsn, uint8_t cid)
 {
-	for (uint8_t index = 0; index < m_deviceList.size(); index++)
+	int index = GetDeviceIndex(cid);
+	if (index >= 0)
 	{
-		if (m_deviceList.at(index)->GetCid() == cid)
-		{
-			m_deviceList.at(index)->UpdateLastPacketOwd(owdMs, true);
-			m_deviceList.at(index)->UpdateLsn(lsn);
-			break;
-		}
+		m_deviceList[index]->UpdateLastPacketOwd(owdMs, true);
+		m_deviceList[index]->UpdateLsn(lsn);
+		m_numOfDataPacketsPerInterval++;
 	}
 }
 
 void
 MeasurementManager::UpdateRtt(uint32_t rtt, uint32_t owd, uint8_t cid)
 {
-	for (uint8_t index = 0; index < m_deviceList.size(); index++)
+	int index = GetDeviceIndex(cid);
+	if (index >= 0)
 	{
-		if (m_deviceList.at(index)->GetCid() == cid)
-		{
-			m_deviceList.at(index)->UpdateRtt(rtt, owd);
-			break;
-		}
+		m_deviceList[index]->UpdateRtt(rtt, owd);
 	}
 }
 
@@ -345,29 +385,59 @@ MeasurementManager::GetMinOwdMs()
 	return minOwd;
 }
 
+uint32_t
+MeasurementManager::GetWindowedMaxOwdMs()
+{
+	uint32_t maxOwd = 0;
+	int64_t nowMs = Now().GetMilliSeconds();
+	for (uint8_t index = 0; index < m_deviceList.size(); index++)
+	{
+		maxOwd = std::max(maxOwd, m_deviceList[index]->m_maxOwdWindow.Get(nowMs));
+	}
+	return maxOwd;
+}
+
+uint32_t
+MeasurementManager::GetWindowedMinOwdMs()
+{
+	uint32_t minOwd = UINT32_MAX;
+	int64_t nowMs = Now().GetMilliSeconds();
+	for (uint8_t index = 0; index < m_deviceList.size(); index++)
+	{
+		minOwd = std::min(minOwd, m_deviceList[index]->m_minOwdWindow.Get(nowMs));
+	}
+	return minOwd;
+}
+
+uint32_t
+MeasurementManager::GetWindowedMaxRttMs()
+{
+	uint32_t maxRtt = 0;
+	int64_t nowMs = Now().GetMilliSeconds();
+	for (uint8_t index = 0; index < m_deviceList.size(); index++)
+	{
+		maxRtt = std::max(maxRtt, m_deviceList[index]->m_maxRttWindow.Get(nowMs));
+	}
+	return maxRtt;
+}
+
 void
 MeasurementManager::UpdateOwdFromProbe(uint32_t owdMs, uint8_t cid)
 {
-	for (uint8_t index = 0; index < m_deviceList.size(); index++)
+	int index = GetDeviceIndex(cid);
+	if (index >= 0)
 	{
-		if (m_deviceList.at(index)->GetCid() == cid)
-		{
-			m_deviceList.at(index)->UpdateLastPacketOwd(owdMs, false);
-			break;
-		}
+		m_deviceList[index]->UpdateLastPacketOwd(owdMs, false);
 	}
 }
 
 void
 MeasurementManager::UpdateOwdFromAck(uint32_t owdMs, uint8_t cid)
 {
-	for (uint8_t index = 0; index < m_deviceList.size(); index++)
+	int index = GetDeviceIndex(cid);
+	if (index >= 0)
 	{
-		if (m_deviceList.at(index)->GetCid() == cid)
-		{
-			m_deviceList.at(index)->UpdateLastPacketOwd(owdMs, false);
-			break;
-		}
+		m_deviceList[index]->UpdateLastPacketOwd(owdMs, false);
 	}
 }
 
@@ -490,7 +560,7 @@ void MeasurementManager::MeasureIntervalStartCheck(Time t, uint32_t sn, uint32_t
 	}
 	//in-order pkt
 	m_lastIntervalStartSn = sn;
-	if(SnDiff(sn, m_measureStartSn) > 0 && m_measureIntervalStarted == false)
+	if(m_measureIntervalStarted == false && SnDiff(sn, m_measureStartSn) > 0)
 	{
 		//we assume the sender owd adjustment takes effects afer receives the packet after receives tsa.
 
@@ -572,54 +642,45 @@ MeasurementManager::MeasureIntervalStart(Time t)
 		m_deviceList.at(index)->m_numOfDelayViolationDataPacketsPerInterval = 0;
 		m_deviceList.at(index)->m_numOfDataPacketsPerInterval = 0;
 	}
+	m_numOfDataPacketsPerInterval = 0;
     m_measureIntervalIndex++;
     m_measureIntervalStarted = true;
     m_measureIntervalStartTime = t;
 	m_splittingBurstRequirementEst = 0;
     m_measureIntervalThresh = MilliSeconds(GetMaxRttMs());
     m_measureIntervalThresh = std::max(MIN_INTERVAL_DURATION, std::min(MAX_INTERVAL_DURATION, m_measureIntervalThresh));
+    m_measureIntervalThreshDeadline = t + m_measureIntervalThresh;
+    m_measureIntervalMaxDeadline = t + MAX_INTERVAL_DURATION;
     //std::cout << Now().GetSeconds() <<" interval " << +m_measureIntervalIndex  << " start \n";
 }
 
 void
 MeasurementManager::MeasureIntervalEndCheck(Time t)
 {
-	if(m_measureIntervalStarted)
+	//this is called for every data packet. Nothing can happen before the interval threshold (it is not larger than
+	//MAX_INTERVAL_DURATION), so the packets before the threshold deadline only cost one compare.
+	if(!m_measureIntervalStarted || t < m_measureIntervalThreshDeadline)
 	{
-		uint32_t totalPackets = 0;
-		for (uint8_t index = 0; index < m_deviceList.size(); index++)
-		{
-			totalPackets+= m_deviceList.at(index)->m_numOfDataPacketsPerInterval;
-		}
+		return;
+	}
 
-		if (m_splittingBurstRequirementEst == 0 && t >= (m_measureIntervalStartTime + m_measureIntervalThresh))
-		{
-			//measure the number of received packets after m_measureIntervalThresh
-			m_splittingBurstRequirementEst = totalPackets;
-		}
+	if (m_splittingBurstRequirementEst == 0)
+	{
+		//measure the number of received packets after m_measureIntervalThresh
+		m_splittingBurstRequirementEst = m_numOfDataPacketsPerInterval;
+	}
 
-		if(t > m_measureIntervalStartTime + MAX_INTERVAL_DURATION)
-		{
-			//interval more than max duration, check how many packets are received.
-			if((int)totalPackets > m_rxControl->GetMeasurementBurstRequirement())
-			{
-				MeasureIntervalEnd(t);
-			}
-			else
-			{
-				//in the andorid app, if no packet is received in both links, move all traffic to Wi-Fi.
-				//I am not doing that here.
-				MeasureIntervalEnd(t);
-			}
-		}
-		else
-		{
-			if((int)totalPackets > m_rxControl->GetMeasurementBurstRequirement() && t >= (m_measureIntervalStartTime + m_measureIntervalThresh))
-			{
-				//after one interval duration, we received enough packets.
-				MeasureIntervalEnd(t);
-			}
-		}
+	if(t > m_measureIntervalMaxDeadline)
+	{
+		//interval more than max duration, end it no matter how many packets are received.
+		//in the andorid app, if no packet is received in both links, move all traffic to Wi-Fi.
+		//I am not doing that here.
+		MeasureIntervalEnd(t);
+	}
+	else if((int)m_numOfDataPacketsPerInterval > m_rxControl->GetMeasurementBurstRequirement())
+	{
+		//after one interval duration, we received enough packets.
+		MeasureIntervalEnd(t);
 	}
 }
 
@@ -758,7 +819,17 @@ MeasurementManager::MeasureIntervalEnd (Time t)
 
 		}
 
+		if (m_decisionTrace)
+		{
+			//save the split of the rx control, it is also changed between the intervals (link down tsu, rl actions).
+			m_decisionTrace->Prepare(m_rxControl);
+		}
         Ptr<SplittingDecision> decision = m_rxControl->GetTrafficSplittingDecision(rxMeasurement);
+		if (m_decisionTrace)
+		{
+			//record the decision of the rx control, before the min owd feedback is added.
+			m_decisionTrace->Add(rxMeasurement, decision);
+		}
 
 		//check if we need to append min owd measurement to the tsu. Only do this for splitting mode!
 		if(m_rxControl->GetSplittingBurst() > 1 && m_senderSideOwdAdjustment) //splitting mode and sender side adjustment enabled.
@@ -896,6 +967,12 @@ MeasurementManager::SetRxControlApp(Ptr<GmaRxControl> control)
 	m_rxControl = control;
 }
 
+void
+MeasurementManager::SetDecisionTrace(Ptr<GmaDecisionTrace> trace)
+{
+	m_decisionTrace = trace;
+}
+
 int
 MeasurementManager::SnDiff(int x1, int x2)
 {
@@ -11,6 +11,8 @@
 #include <ns3/log.h>
 #include <ns3/simulator.h>
 #include "gma-rx-control.h"
+#include "gma-windowed-filter.h"
+#include "gma-decision-trace.h"
 
 namespace ns3 {
 
@@ -46,6 +48,11 @@ public:
 
   uint32_t m_lastMaxOwd = 0;
   uint32_t m_currentMaxOwd = 0;
+
+  //min and max owd of the sliding window, updated per sample. Unlike m_lastMinOwd, they follow a path change within one window.
+  GmaWindowedFilter m_minOwdWindow {GmaWindowedFilter::MIN};
+  GmaWindowedFilter m_maxOwdWindow {GmaWindowedFilter::MAX};
+  GmaWindowedFilter m_maxRttWindow {GmaWindowedFilter::MAX};
   uint32_t m_numOfDelayViolationDataPacketsPerInterval = 0; //the number of data packets violate queueing delay, e.g., owd - min_owd.
   int m_senderOwdAdjustment = 0; //owd offset adjustment at the sender, notified in the tsa msg.
   MeasureDevice (uint8_t cid);
@@ -59,6 +66,7 @@ public:
   void UpdateLastPacketOwd (uint32_t timestampMs, bool dataFlag);
   void UpdateRtt (uint32_t rtt, uint32_t owd);
   uint32_t GetRtt ();
+  void SetWindow (Time window); //set the window of the sliding window min and max.
 
   void UpdateLsn (uint8_t lastLsn);
   int LsnDiff(int x1, int x2);
@@ -86,6 +94,7 @@ public:
   void AddDevice (uint8_t cid, uint32_t owdTarget);
 
   Ptr<MeasureDevice> GetDevice (uint8_t cid);
+  void SetCidTable (Ptr<CidTable> cidTable); //share the cid table of the links, the device of a cid is stored at its slot.
 
   bool IsMeasurementOn();
   void DisableMeasurement();
@@ -106,6 +115,11 @@ public:
   uint32_t GetMaxOwdMs();
   uint32_t GetMinOwdMs();
 
+  //sliding window values of all devices, the window is set by the OwdWindow attribute.
+  uint32_t GetWindowedMaxOwdMs(); //value is 0 if no sample is in the window.
+  uint32_t GetWindowedMinOwdMs(); //value is UINT32_MAX if no sample is in the window.
+  uint32_t GetWindowedMaxRttMs(); //value is 0 if no sample is in the window.
+
   //menglei: TSA triggers a measureCycle start.
   void MeasureCycleStartByTsa(uint32_t measureStartSn, uint8_t delay, std::vector<uint8_t> owdVector); //Measurement cycle start triggered by TSA
   void MeasureCycleStart(uint32_t measureStartSn); //restart measurement due to no update needed, no tsu.
@@ -123,19 +137,28 @@ public:
 
   void SetSendTsuCallback(Callback<void, Ptr<SplittingDecision> > cb);
   void SetRxControlApp (Ptr<GmaRxControl> control);
+  void SetDecisionTrace (Ptr<GmaDecisionTrace> trace); //record the measurement and the decision of each interval.
   int SnDiff(int x1, int x2);
 
 protected:
-  std::vector < Ptr<MeasureDevice> > m_deviceList;
+  std::vector < Ptr<MeasureDevice> > m_deviceList; //indexed by the slot of the cid.
+  Ptr<CidTable> m_cidTable;
+  void AddDevice (Ptr<MeasureDevice> device);
+  int GetDeviceIndex (uint8_t cid); //return -1 if no device is added for this cid.
   uint8_t m_measureIntervalIndex = 0; // current measure interval index
   bool m_measureIntervalStarted = false;
   Time m_measureIntervalStartTime;
   Time m_measureIntervalThresh;
+  Time m_measureIntervalThreshDeadline; //start time + m_measureIntervalThresh, the interval cannot end before it.
+  Time m_measureIntervalMaxDeadline; //start time + MAX_INTERVAL_DURATION, the interval ends after it.
+  uint32_t m_numOfDataPacketsPerInterval = 0; //data packets of all devices in this interval.
   bool m_measurementOn = true; //true stands for a measurement cycle is started
   Ptr<GmaRxControl> m_rxControl;
+  Ptr<GmaDecisionTrace> m_decisionTrace; //null if the decision trace is disabled.
   Callback<void, Ptr<SplittingDecision> > m_sendTsuCallback; //callback that sends packet to GMA to transmit
   uint32_t m_lastIntervalStartSn = 0;
   bool m_senderSideOwdAdjustment = true; //enable this will report the raw owd to the rx controller, but will send the min owd measurement to server and delay packets accordingly.
+  Time m_owdWindow = Seconds(12.0); //window of the sliding window min and max owd.
 private:
 
   //menglei: parameters for one way delay measurement
@@ -381,5 +381,13 @@ PoissonUdpClient::GetTotalTx () const
   return m_totalTx;
 }
 
+int64_t
+PoissonUdpClient::AssignStreams (int64_t stream)
+{
+  NS_LOG_FUNCTION (this << stream);
+  m_urv->SetStream (stream);
+  return 1;
+}
+
 
 } // Namespace ns3
\ No newline at end of file
@@ -75,6 +75,15 @@ public:
    */
   uint64_t GetTotalTx () const;
 
+  /**
+   * \brief Assign a fixed random variable stream number to the random variables
+   * used by this model, e.g., to reseed a forked simulation after RngSeedManager::SetRun.
+   *
+   * \param stream first stream index to use
+   * \return the number of stream indices assigned by this model
+   */
+  int64_t AssignStreams (int64_t stream);
+
 protected:
   virtual void DoDispose (void);
 
@@ -3,11 +3,43 @@
 // Include a header file from your module to test.
 // An essential include is test.h
 #include "ns3/test.h"
+#include "ns3/gma-reordering-buffer.h"
+#include "ns3/gma-header.h"
+#include "ns3/packet.h"
+#include "ns3/link-state.h"
+#include "ns3/gma-tx-control.h"
+#include "ns3/gma-quantile-sketch.h"
+#include "ns3/gma-packet-trace.h"
+#include "ns3/gma-windowed-filter.h"
+#include "ns3/gma-timer-wheel.h"
+#include "ns3/gma-rx-control.h"
+#include "ns3/gma-rx-policy.h"
+#include "ns3/gma-decision-trace.h"
+#include "ns3/gma-bw-estimator.h"
+#include "ns3/enum.h"
+#include "ns3/boolean.h"
+#include "ns3/simulator.h"
+#include "ns3/log.h"
+#include "ns3/poisson-udp-client-helper.h"
+#include "ns3/internet-stack-helper.h"
+#include "ns3/rng-seed-manager.h"
+#include "ns3/abort.h"
+#include "ns3/uinteger.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <vector>
+#include <queue>
+#include <sys/wait.h>
+#include <unistd.h>
 
 // Do not put your test classes in namespace ns3.  You may find it useful
 // to use the using directive to access the ns3 namespace directly
 using namespace ns3;
 
+NS_LOG_COMPONENT_DEFINE ("GmaTestSuite");
+
 // This is an example TestCase.
 class GmaTestCase1 : public TestCase
 {
@@ -44,6 +76,1320 @@ GmaTestCase1::DoRun (void)
   NS_TEST_ASSERT_MSG_EQ_TOL (0.01, 0.01, 0.001, "Numbers are not equal within tolerance");
 }
 
+// Packets of several links arrive interleaved and the min sn is released whenever more than 256 packets
+// are buffered. The reordering buffer must release the same order as the per link queues it replaces,
+// including across the 24 bits sn wrap around. A large sn jump must not grow the ring beyond its max capacity.
+class GmaReorderingBufferTestCase : public TestCase
+{
+public:
+  GmaReorderingBufferTestCase ();
+  virtual ~GmaReorderingBufferTestCase ();
+
+protected:
+  GmaReorderingBufferTestCase (std::string name);
+  //release the packets of the links, the time per packet (ns) of both is returned.
+  void RunLinks (uint8_t links, uint32_t packets, double& legacyNs, double& bufferNs);
+
+private:
+  virtual void DoRun (void);
+  void RunSnJump (void);
+};
+
+GmaReorderingBufferTestCase::GmaReorderingBufferTestCase ()
+  : TestCase ("Gma reordering buffer release order")
+{
+}
+
+GmaReorderingBufferTestCase::GmaReorderingBufferTestCase (std::string name)
+  : TestCase (name)
+{
+}
+
+GmaReorderingBufferTestCase::~GmaReorderingBufferTestCase ()
+{
+}
+
+void
+GmaReorderingBufferTestCase::RunLinks (uint8_t links, uint32_t packets, double& legacyNs, double& bufferNs)
+{
+  // the sn are split to links in random bursts, a random link delivers its next packet.
+  const uint32_t window = 256;
+  std::vector<std::queue<uint32_t> > linkSnList (links);
+  uint32_t sn = 0x00FFFFFF - packets / 2;
+  uint32_t seed = 1;
+  uint8_t cid = 0;
+  for (uint32_t i = 0; i < packets; i++)
+    {
+      seed = seed * 1103515245 + 12345;
+      if ((seed >> 16) % 4 == 0)
+        {
+          cid = (cid + 1) % links;
+        }
+      linkSnList[cid].push (sn);
+      sn = (sn + 1) & 0x00FFFFFF;
+    }
+  std::vector<GmaHeader> arrivalList;
+  arrivalList.reserve (packets);
+  while (arrivalList.size () < packets)
+    {
+      seed = seed * 1103515245 + 12345;
+      cid = (seed >> 16) % links;
+      if (!linkSnList[cid].empty ())
+        {
+          GmaHeader header;
+          header.SetSequenceNumber (linkSnList[cid].front ());
+          header.SetConnectionId (cid);
+          arrivalList.push_back (header);
+          linkSnList[cid].pop ();
+        }
+    }
+  Ptr<Packet> packet = Create<Packet> (1400);
+
+  // legacy: a queue of allocated items per link, the heads of all queues are scanned for the min sn.
+  struct LegacyItem : public SimpleRefCount<LegacyItem>
+  {
+    Ptr<Packet> m_packet;
+    GmaHeader m_gmaHeader;
+    Time m_receivedTime;
+  };
+  std::vector<std::queue<Ptr<LegacyItem> > > queues (links);
+  uint32_t legacySize = 0;
+  std::vector<uint32_t> legacyOrder;
+  legacyOrder.reserve (packets);
+  auto start = std::chrono::steady_clock::now ();
+  for (uint32_t i = 0; i <= packets; i++)
+    {
+      if (i < packets)
+        {
+          Ptr<LegacyItem> item = Create<LegacyItem> ();
+          item->m_packet = packet;
+          item->m_gmaHeader = arrivalList[i];
+          queues[arrivalList[i].GetConnectionId ()].push (item);
+          legacySize++;
+        }
+      while (legacySize > (i < packets ? window : 0))
+        {
+          int minSn = -1;
+          uint8_t minCid = 0;
+          for (uint8_t link = 0; link < links; link++)
+            {
+              if (queues[link].size () != 0
+                  && (minSn < 0 || GmaReorderingBuffer::SnDiff (minSn, queues[link].front ()->m_gmaHeader.GetSequenceNumber ()) > 0))
+                {
+                  minSn = queues[link].front ()->m_gmaHeader.GetSequenceNumber ();
+                  minCid = link;
+                }
+            }
+          legacyOrder.push_back (minSn);
+          queues[minCid].pop ();
+          legacySize--;
+        }
+    }
+  legacyNs = std::chrono::duration<double, std::nano> (std::chrono::steady_clock::now () - start).count () / packets;
+
+  // reordering buffer: starts small to cover the growth of the ring.
+  GmaReorderingBuffer buffer (64);
+  GmaReorderingBuffer::Slot slot;
+  std::vector<uint32_t> bufferOrder;
+  bufferOrder.reserve (packets);
+  start = std::chrono::steady_clock::now ();
+  for (uint32_t i = 0; i <= packets; i++)
+    {
+      if (i < packets)
+        {
+          buffer.Insert (packet, arrivalList[i], false, Seconds (0));
+        }
+      while (buffer.GetSize () > (i < packets ? window : 0))
+        {
+          buffer.PopMin (slot);
+          bufferOrder.push_back (slot.m_gmaHeader.GetSequenceNumber ());
+        }
+    }
+  bufferNs = std::chrono::duration<double, std::nano> (std::chrono::steady_clock::now () - start).count () / packets;
+
+  NS_TEST_ASSERT_MSG_EQ (bufferOrder.size (), legacyOrder.size (), "different number of released packets");
+  NS_TEST_ASSERT_MSG_EQ ((bufferOrder == legacyOrder), true, "reordering buffer and per link queues release packets in different order");
+  NS_TEST_ASSERT_MSG_EQ (buffer.Insert (packet, arrivalList[0], false, Seconds (0)), true, "the released sn can be buffered again");
+  NS_TEST_ASSERT_MSG_EQ (buffer.Insert (packet, arrivalList[0], false, Seconds (0)), false, "duplicated sn is not buffered");
+}
+
+void
+GmaReorderingBufferTestCase::RunSnJump (void)
+{
+  GmaReorderingBuffer buffer (64, 4096);
+  GmaReorderingBuffer::Slot slot;
+  Ptr<Packet> packet = Create<Packet> (1400);
+  GmaHeader header;
+  for (uint32_t sn = 0x00FFFF00; sn < 0x00FFFF00 + 100; sn += 2)
+    {
+      header.SetSequenceNumber (sn & 0x00FFFFFF);
+      buffer.Insert (packet, header, false, Seconds (0));
+    }
+  NS_TEST_ASSERT_MSG_EQ (buffer.GetSize (), 50u, "packets before the jump");
+
+  // a sn far ahead, e.g., a corrupted sn, is not buffered.
+  uint32_t farSn = 0x00400000;
+  NS_TEST_ASSERT_MSG_EQ (buffer.IsInWindow (farSn), false, "the far sn is out of the window");
+  header.SetSequenceNumber (farSn);
+  NS_TEST_ASSERT_MSG_EQ (buffer.Insert (packet, header, false, Seconds (0)), false, "the far sn is not buffered");
+  NS_TEST_ASSERT_MSG_EQ (buffer.GetSize (), 50u, "the buffered packets are kept");
+  NS_TEST_ASSERT_MSG_LT_OR_EQ (buffer.GetCapacity (), 4096u, "the ring does not grow beyond its max capacity");
+
+  // a jump within the max capacity releases the packets in order until it fits, as GmaVirtualInterface does.
+  uint32_t jumpSn = (0x00FFFF00 + 4096 + 10) & 0x00FFFFFF;
+  uint32_t expectedSn = 0x00FFFF00;
+  while (!buffer.IsInWindow (jumpSn))
+    {
+      buffer.PopMin (slot);
+      NS_TEST_ASSERT_MSG_EQ (slot.m_gmaHeader.GetSequenceNumber (), expectedSn, "released in order");
+      expectedSn = (expectedSn + 2) & 0x00FFFFFF;
+    }
+  NS_TEST_ASSERT_MSG_EQ (buffer.GetSize (), 44u, "only the packets out of the window are released");
+  header.SetSequenceNumber (jumpSn);
+  NS_TEST_ASSERT_MSG_EQ (buffer.Insert (packet, header, false, Seconds (0)), true, "the sn is buffered once it fits");
+  NS_TEST_ASSERT_MSG_EQ (buffer.GetCapacity (), 4096u, "the ring grows up to its max capacity");
+  NS_TEST_ASSERT_MSG_EQ (buffer.GetMinSn (), expectedSn, "min sn after the jump");
+  while (!buffer.IsEmpty ())
+    {
+      buffer.PopMin (slot);
+    }
+  NS_TEST_ASSERT_MSG_EQ (slot.m_gmaHeader.GetSequenceNumber (), jumpSn, "the jump sn is released last");
+}
+
+void
+GmaReorderingBufferTestCase::DoRun (void)
+{
+  double legacyNs;
+  double bufferNs;
+  RunLinks (3, 10000, legacyNs, bufferNs);
+  RunLinks (8, 10000, legacyNs, bufferNs);
+  RunSnJump ();
+}
+
+// The time per packet of the per link queues and the reordering buffer, for
+// 100k packets. The order is checked as in GmaReorderingBufferTestCase.
+class GmaReorderingBufferSpeedTestCase : public GmaReorderingBufferTestCase
+{
+public:
+  GmaReorderingBufferSpeedTestCase ();
+  virtual ~GmaReorderingBufferSpeedTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+GmaReorderingBufferSpeedTestCase::GmaReorderingBufferSpeedTestCase ()
+  : GmaReorderingBufferTestCase ("Gma reordering buffer release speed")
+{
+}
+
+GmaReorderingBufferSpeedTestCase::~GmaReorderingBufferSpeedTestCase ()
+{
+}
+
+void
+GmaReorderingBufferSpeedTestCase::DoRun (void)
+{
+  const uint32_t packets = 100000;
+  for (uint8_t links : {3, 8})
+    {
+      double legacyNs;
+      double bufferNs;
+      RunLinks (links, packets, legacyNs, bufferNs);
+      NS_LOG_INFO ("reordering release " << +links << " links, " << packets << " packets: per link queues "
+                   << legacyNs << " ns/pkt, reordering buffer " << bufferNs << " ns/pkt");
+    }
+}
+
+// Build the data packets of Transmit in split mode (one link per packet) and duplicate mode (every link
+// per packet). A new gma header per packet is compared with the per link header that is reused and only
+// has the ts, sn and lsn updated. The reused header must serialize the same bytes.
+class GmaTxHeaderTestCase : public TestCase
+{
+public:
+  GmaTxHeaderTestCase ();
+  virtual ~GmaTxHeaderTestCase ();
+
+protected:
+  GmaTxHeaderTestCase (std::string name);
+  //build the packets, the packets per second is returned.
+  double Run (bool duplicate, bool reuseHeader, uint32_t packets);
+
+private:
+  virtual void DoRun (void);
+};
+
+GmaTxHeaderTestCase::GmaTxHeaderTestCase ()
+  : TestCase ("Gma tx header construction")
+{
+}
+
+GmaTxHeaderTestCase::GmaTxHeaderTestCase (std::string name)
+  : TestCase (name)
+{
+}
+
+GmaTxHeaderTestCase::~GmaTxHeaderTestCase ()
+{
+}
+
+double
+GmaTxHeaderTestCase::Run (bool duplicate, bool reuseHeader, uint32_t packets)
+{
+  const uint8_t links = 3;
+  std::vector<GmaHeader> linkHeaderList (links);
+  std::vector<uint8_t> linkLsnList (links, 0);
+  for (uint8_t cid = 0; cid < links; cid++)
+    {
+      linkHeaderList[cid].SetConnectionId (cid);
+    }
+  Ptr<Packet> packet = Create<Packet> (1400);
+  uint32_t sn = 0;
+  uint32_t sentBytes = 0;
+  auto start = std::chrono::steady_clock::now ();
+  for (uint32_t i = 0; i < packets; i++)
+    {
+      uint8_t firstCid = duplicate ? 0 : i % links;
+      uint8_t endCid = duplicate ? links : firstCid + 1;
+      for (uint8_t cid = firstCid; cid < endCid; cid++)
+        {
+          Ptr<Packet> dummyP = packet->Copy ();
+          if (reuseHeader)
+            {
+              GmaHeader& gmaHeader = linkHeaderList[cid];
+              gmaHeader.SetTimeStamp (i);
+              gmaHeader.SetSequenceNumber (sn);
+              gmaHeader.SetLocalSequenceNumber (linkLsnList[cid]);
+              gmaHeader.SetFlowId (duplicate ? 3 : 1);
+              dummyP->AddHeader (gmaHeader);
+            }
+          else
+            {
+              GmaHeader gmaHeader;
+              gmaHeader.SetTimeStamp (i);
+              gmaHeader.SetSequenceNumber (sn);
+              gmaHeader.SetLocalSequenceNumber (linkLsnList[cid]);
+              gmaHeader.SetConnectionId (cid);
+              gmaHeader.SetFlowId (duplicate ? 3 : 1);
+              dummyP->AddHeader (gmaHeader);
+            }
+          sentBytes += dummyP->GetSize ();
+          linkLsnList[cid]++;
+        }
+      sn = (sn + 1) & 0x00FFFFFF;
+    }
+  double seconds = std::chrono::duration<double> (std::chrono::steady_clock::now () - start).count ();
+  NS_TEST_ASSERT_MSG_EQ (sentBytes, packets * (duplicate ? links : 1) * (1400 + 13), "gma header is not 13 bytes");
+
+  if (reuseHeader)
+    {
+      // the reused header of the link used by the last packet serializes the same bytes as a new one.
+      uint8_t lastCid = duplicate ? links - 1 : (packets - 1) % links;
+      GmaHeader gmaHeader;
+      gmaHeader.SetTimeStamp (packets - 1);
+      gmaHeader.SetSequenceNumber ((sn - 1) & 0x00FFFFFF);
+      gmaHeader.SetLocalSequenceNumber (linkLsnList[lastCid] - 1);
+      gmaHeader.SetConnectionId (lastCid);
+      gmaHeader.SetFlowId (duplicate ? 3 : 1);
+      Ptr<Packet> expected = Create<Packet> ();
+      expected->AddHeader (gmaHeader);
+      Ptr<Packet> reused = Create<Packet> ();
+      reused->AddHeader (linkHeaderList[lastCid]);
+      NS_TEST_ASSERT_MSG_EQ (reused->GetSize (), expected->GetSize (), "the reused header has a different size");
+      std::vector<uint8_t> expectedBytes (expected->GetSize ());
+      std::vector<uint8_t> reusedBytes (reused->GetSize ());
+      expected->CopyData (expectedBytes.data (), expectedBytes.size ());
+      reused->CopyData (reusedBytes.data (), reusedBytes.size ());
+      NS_TEST_ASSERT_MSG_EQ ((reusedBytes == expectedBytes), true, "the reused header serializes different bytes");
+
+      GmaHeader received;
+      reused->RemoveHeader (received);
+      NS_TEST_ASSERT_MSG_EQ (received.GetSequenceNumber (), gmaHeader.GetSequenceNumber (), "sn does not match");
+      NS_TEST_ASSERT_MSG_EQ (received.GetSerializedSize (), gmaHeader.GetSerializedSize (), "received header size does not match");
+    }
+  return packets / seconds;
+}
+
+void
+GmaTxHeaderTestCase::DoRun (void)
+{
+  const uint32_t packets = 1000;
+  Run (false, false, packets);
+  Run (false, true, packets);
+  Run (true, false, packets);
+  Run (true, true, packets);
+}
+
+// Packets per second of a new and a reused gma header, for 100k packets in
+// split and duplicate mode. The bytes are checked as in GmaTxHeaderTestCase.
+class GmaTxHeaderSpeedTestCase : public GmaTxHeaderTestCase
+{
+public:
+  GmaTxHeaderSpeedTestCase ();
+  virtual ~GmaTxHeaderSpeedTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+GmaTxHeaderSpeedTestCase::GmaTxHeaderSpeedTestCase ()
+  : GmaTxHeaderTestCase ("Gma tx header construction speed")
+{
+}
+
+GmaTxHeaderSpeedTestCase::~GmaTxHeaderSpeedTestCase ()
+{
+}
+
+void
+GmaTxHeaderSpeedTestCase::DoRun (void)
+{
+  const uint32_t packets = 100000;
+  double splitNew = Run (false, false, packets);
+  double splitReuse = Run (false, true, packets);
+  double duplicateNew = Run (true, false, packets);
+  double duplicateReuse = Run (true, true, packets);
+  NS_LOG_INFO ("tx header split mode: new header " << splitNew << " pps, reused header " << splitReuse << " pps");
+  NS_LOG_INFO ("tx header duplicate mode (3 links): new header " << duplicateNew << " pps, reused header " << duplicateReuse << " pps");
+}
+
+// The cid table assigns dense slots in the order the links are added, and a
+// link is only up if none of its down reasons is set.
+class GmaCidTableTestCase : public TestCase
+{
+public:
+  GmaCidTableTestCase ();
+  virtual ~GmaCidTableTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+GmaCidTableTestCase::GmaCidTableTestCase ()
+  : TestCase ("Gma cid table and link state flags")
+{
+}
+
+GmaCidTableTestCase::~GmaCidTableTestCase ()
+{
+}
+
+void
+GmaCidTableTestCase::DoRun (void)
+{
+  Ptr<LinkState> linkState = CreateObject<LinkState> ();
+  linkState->AddLinkCid (CELLULAR_LTE_CID);
+  linkState->AddLinkCid (WIFI_CID);
+  linkState->AddLinkCid (CELLULAR_LTE_CID);
+
+  Ptr<CidTable> cidTable = linkState->GetCidTable ();
+  NS_TEST_ASSERT_MSG_EQ (cidTable->GetSize (), 2, "a cid is only added once");
+  NS_TEST_ASSERT_MSG_EQ (cidTable->GetSlot (CELLULAR_LTE_CID), 0, "slots follow the order of AddLinkCid");
+  NS_TEST_ASSERT_MSG_EQ (cidTable->GetSlot (WIFI_CID), 1, "slots follow the order of AddLinkCid");
+  NS_TEST_ASSERT_MSG_EQ (cidTable->GetCid (1), WIFI_CID, "slot to cid");
+  NS_TEST_ASSERT_MSG_EQ (cidTable->Contains (CELLULAR_NR_CID), false, "nr is not added");
+  NS_TEST_ASSERT_MSG_EQ (cidTable->GetSlot (CELLULAR_NR_CID), CidTable::NO_SLOT, "nr is not added");
+  NS_TEST_ASSERT_MSG_EQ (linkState->GetLinkIndex (WIFI_CID), 1, "link index is the slot");
+
+  NS_TEST_ASSERT_MSG_EQ (linkState->IsLinkUp (WIFI_CID), true, "links are up by default");
+  linkState->CtrlMsgDown (WIFI_CID);
+  linkState->LowRssiDown (WIFI_CID);
+  NS_TEST_ASSERT_MSG_EQ (linkState->IsLinkUp (WIFI_CID), false, "ctrl and rssi down");
+  linkState->CtrlMsgUp (WIFI_CID);
+  NS_TEST_ASSERT_MSG_EQ (linkState->IsLinkUp (WIFI_CID), false, "still down due to low rssi");
+  linkState->HighRssiUp (WIFI_CID);
+  NS_TEST_ASSERT_MSG_EQ (linkState->IsLinkUp (WIFI_CID), true, "all down reasons cleared");
+  NS_TEST_ASSERT_MSG_EQ (linkState->IsLinkUp (CELLULAR_LTE_CID), true, "other links are not affected");
+}
+
+// The split schedule compiled from a tsu must send k packets on each link per
+// burst of L, with the packets of each link spread evenly over the burst
+// (at most ceil(L/k) packets apart, also across the end of the burst).
+class GmaSplitScheduleTestCase : public TestCase
+{
+public:
+  GmaSplitScheduleTestCase ();
+  virtual ~GmaSplitScheduleTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+GmaSplitScheduleTestCase::GmaSplitScheduleTestCase ()
+  : TestCase ("Gma split schedule from the tsu k vector")
+{
+}
+
+GmaSplitScheduleTestCase::~GmaSplitScheduleTestCase ()
+{
+}
+
+void
+GmaSplitScheduleTestCase::DoRun (void)
+{
+  std::vector<uint8_t> cidList = {WIFI_CID, CELLULAR_LTE_CID};
+  const uint8_t burstList[] = {4, 8, 16, 32, 128};
+  for (uint8_t paramL : burstList)
+    {
+      for (uint8_t k = 0; k <= paramL; k++)
+        {
+          std::vector<uint8_t> splitIndexList = {k, (uint8_t)(paramL - k)};
+          std::vector<uint8_t> schedule = GmaTxControl::CompileSplitSchedule (splitIndexList, cidList);
+          NS_TEST_ASSERT_MSG_EQ (schedule.size (), paramL, "one cid per packet of the burst");
+          for (uint8_t link = 0; link < cidList.size (); link++)
+            {
+              std::vector<uint32_t> slotList;
+              for (uint32_t slot = 0; slot < schedule.size (); slot++)
+                {
+                  if (schedule[slot] == cidList[link])
+                    {
+                      slotList.push_back (slot);
+                    }
+                }
+              NS_TEST_ASSERT_MSG_EQ (slotList.size (), splitIndexList[link], "k packets on this link");
+              for (uint32_t ind = 0; ind < slotList.size (); ind++)
+                {
+                  uint32_t next = ind + 1 < slotList.size () ? slotList[ind + 1] : slotList[0] + paramL;
+                  uint32_t maxGap = (paramL + splitIndexList[link] - 1) / splitIndexList[link];
+                  NS_TEST_ASSERT_MSG_LT_OR_EQ (next - slotList[ind], maxGap, "packets of a link are spread evenly");
+                }
+            }
+        }
+    }
+
+  std::vector<uint8_t> schedule = GmaTxControl::CompileSplitSchedule ({16, 8, 8}, {WIFI_CID, CELLULAR_NR_CID, CELLULAR_LTE_CID});
+  NS_TEST_ASSERT_MSG_EQ (std::count (schedule.begin (), schedule.end (), WIFI_CID), 16, "3 links: k packets on wifi");
+  NS_TEST_ASSERT_MSG_EQ (std::count (schedule.begin (), schedule.end (), CELLULAR_NR_CID), 8, "3 links: k packets on nr");
+  NS_TEST_ASSERT_MSG_EQ (std::count (schedule.begin (), schedule.end (), CELLULAR_LTE_CID), 8, "3 links: k packets on lte");
+}
+
+// The quantiles of the owd sketch must be within 1/32 of the exact quantiles
+// of the samples, also for a long tail of large delays.
+class GmaQuantileSketchTestCase : public TestCase
+{
+public:
+  GmaQuantileSketchTestCase ();
+  virtual ~GmaQuantileSketchTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+GmaQuantileSketchTestCase::GmaQuantileSketchTestCase ()
+  : TestCase ("Gma owd quantile sketch")
+{
+}
+
+GmaQuantileSketchTestCase::~GmaQuantileSketchTestCase ()
+{
+}
+
+void
+GmaQuantileSketchTestCase::DoRun (void)
+{
+  GmaQuantileSketch sketch;
+  NS_TEST_ASSERT_MSG_EQ (sketch.GetQuantile (0.5), -1.0, "no sample");
+
+  std::vector<uint32_t> sampleList;
+  uint32_t seed = 1;
+  for (uint32_t i = 0; i < 100000; i++)
+    {
+      seed = seed * 1103515245 + 12345;
+      uint32_t owd = 5 + (seed >> 16) % 40;
+      if (i % 50 == 0)
+        {
+          owd += (seed >> 8) % 2000; //tail
+        }
+      sampleList.push_back (owd);
+      sketch.Add (owd);
+    }
+  std::sort (sampleList.begin (), sampleList.end ());
+  NS_TEST_ASSERT_MSG_EQ (sketch.GetCount (), sampleList.size (), "count");
+
+  const double quantileList[] = {0.0, 0.5, 0.9, 0.99, 0.999, 1.0};
+  for (double q : quantileList)
+    {
+      uint32_t rank = std::max (1, (int)std::ceil (q * sampleList.size ()));
+      double exact = sampleList[rank - 1];
+      NS_TEST_ASSERT_MSG_EQ_TOL (sketch.GetQuantile (q), exact, exact / 32 + 0.5, "quantile " << q);
+    }
+
+  sketch.Clear ();
+  sketch.Add (UINT32_MAX);
+  NS_TEST_ASSERT_MSG_EQ (sketch.GetQuantile (0.99), GmaQuantileSketch::MAX_VALUE, "large values are capped");
+}
+
+// Records added to the packet trace must be read back from the file in order,
+// including the records that are still buffered in the ring when it is closed.
+// A trace closed by CloseAll (before a fork) must be opened again, truncated,
+// at its next write.
+class GmaPacketTraceTestCase : public TestCase
+{
+public:
+  GmaPacketTraceTestCase ();
+  virtual ~GmaPacketTraceTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+GmaPacketTraceTestCase::GmaPacketTraceTestCase ()
+  : TestCase ("Gma per packet binary trace")
+{
+}
+
+GmaPacketTraceTestCase::~GmaPacketTraceTestCase ()
+{
+}
+
+void
+GmaPacketTraceTestCase::DoRun (void)
+{
+  std::string fileName = CreateTempDirFilename ("gma-packet-trace.bin");
+  const uint32_t packets = 10000;
+  GmaPacketTrace trace (1000);
+  trace.Open (fileName);
+  GmaHeader gmaHeader;
+  for (uint32_t sn = 0; sn < packets; sn++)
+    {
+      gmaHeader.SetSequenceNumber (sn);
+      gmaHeader.SetLocalSequenceNumber (sn & 0xFF);
+      gmaHeader.SetConnectionId (sn % 2 ? WIFI_CID : CELLULAR_LTE_CID);
+      trace.Add (sn % 2 ? GmaPacketTrace::RX : GmaPacketTrace::TX, gmaHeader, 1000 + sn % 400);
+    }
+  gmaHeader.SetSequenceNumber (packets);
+  trace.Add (GmaPacketTrace::DELIVER, gmaHeader, 1400);
+  trace.Close ();
+
+  std::vector<GmaPacketTrace::Record> recordList = GmaPacketTrace::Read (fileName);
+  NS_TEST_ASSERT_MSG_EQ (recordList.size (), packets + 1, "every record is written");
+  for (uint32_t sn = 0; sn < packets; sn++)
+    {
+      NS_TEST_ASSERT_MSG_EQ (recordList[sn].m_sn, sn, "sn");
+      NS_TEST_ASSERT_MSG_EQ (+recordList[sn].m_lsn, (sn & 0xFF), "lsn");
+      NS_TEST_ASSERT_MSG_EQ (+recordList[sn].m_cid, (sn % 2 ? WIFI_CID : CELLULAR_LTE_CID), "cid");
+      NS_TEST_ASSERT_MSG_EQ (+recordList[sn].m_event, (sn % 2 ? GmaPacketTrace::RX : GmaPacketTrace::TX), "event");
+      NS_TEST_ASSERT_MSG_EQ (recordList[sn].m_size, 1000 + sn % 400, "size");
+    }
+  NS_TEST_ASSERT_MSG_EQ (+recordList[packets].m_event, GmaPacketTrace::DELIVER, "last record");
+
+  trace.Open (fileName);
+  trace.Add (GmaPacketTrace::TX, gmaHeader, 1400);
+  GmaPacketTrace::CloseAll ();
+  NS_TEST_ASSERT_MSG_EQ (GmaPacketTrace::Read (fileName).size (), 1u, "CloseAll writes the buffered records");
+  for (uint32_t sn = 0; sn < 1500; sn++)
+    {
+      gmaHeader.SetSequenceNumber (sn);
+      trace.Add (GmaPacketTrace::RX, gmaHeader, 1400);
+    }
+  trace.Close ();
+  recordList = GmaPacketTrace::Read (fileName);
+  NS_TEST_ASSERT_MSG_EQ (recordList.size (), 1500u, "the trace is opened again after CloseAll");
+  NS_TEST_ASSERT_MSG_EQ (recordList.front ().m_sn, 0u, "the reopened trace starts with the first record after CloseAll");
+  NS_TEST_ASSERT_MSG_EQ (recordList.back ().m_sn, 1499u, "last record after CloseAll");
+}
+
+// The sliding window min and max must match a brute force scan of the samples
+// in the window, i.e., the samples measured in the last NUM_SLOTS slots.
+class GmaWindowedFilterTestCase : public TestCase
+{
+public:
+  GmaWindowedFilterTestCase ();
+  virtual ~GmaWindowedFilterTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+GmaWindowedFilterTestCase::GmaWindowedFilterTestCase ()
+  : TestCase ("Gma sliding window min and max owd")
+{
+}
+
+GmaWindowedFilterTestCase::~GmaWindowedFilterTestCase ()
+{
+}
+
+void
+GmaWindowedFilterTestCase::DoRun (void)
+{
+  GmaWindowedFilter minFilter (GmaWindowedFilter::MIN);
+  GmaWindowedFilter maxFilter (GmaWindowedFilter::MAX);
+  minFilter.SetWindow (1000);
+  maxFilter.SetWindow (1000);
+  NS_TEST_ASSERT_MSG_EQ (minFilter.Get (0), UINT32_MAX, "empty min filter");
+  NS_TEST_ASSERT_MSG_EQ (maxFilter.Get (0), 0u, "empty max filter");
+
+  const int64_t slotMs = minFilter.GetWindow () / GmaWindowedFilter::NUM_SLOTS;
+  std::vector<std::pair<int64_t, uint32_t> > sampleList;
+  int64_t nowMs = 0;
+  uint32_t seed = 1;
+  for (uint32_t i = 0; i < 20000; i++)
+    {
+      seed = seed * 1103515245 + 12345;
+      nowMs += (seed >> 16) % 7; //several samples per slot, with gaps from time to time.
+      if (i % 5000 == 0)
+        {
+          nowMs += 3000; //all samples expire.
+        }
+      uint32_t owd = 20 + (seed >> 8) % 100 + (i / 2000) * 10; //the owd drifts, e.g., after a path change.
+      sampleList.push_back (std::make_pair (nowMs, owd));
+      minFilter.Update (owd, nowMs);
+      maxFilter.Update (owd, nowMs);
+
+      int64_t queryMs = nowMs + (seed >> 4) % 50;
+      uint32_t minOwd = UINT32_MAX;
+      uint32_t maxOwd = 0;
+      for (auto it = sampleList.rbegin (); it != sampleList.rend (); it++)
+        {
+          if (it->first / slotMs + GmaWindowedFilter::NUM_SLOTS < queryMs / slotMs)
+            {
+              break;
+            }
+          minOwd = std::min (minOwd, it->second);
+          maxOwd = std::max (maxOwd, it->second);
+        }
+      NS_TEST_ASSERT_MSG_EQ (minFilter.Get (queryMs), minOwd, "window min at " << queryMs);
+      NS_TEST_ASSERT_MSG_EQ (maxFilter.Get (queryMs), maxOwd, "window max at " << queryMs);
+      nowMs = queryMs; //the time never goes back.
+    }
+}
+
+// Timers stored in every level of the timer wheel must fire at their expire time
+// rounded up to the tick, and canceled timers must never fire.
+class GmaTimerWheelTestCase : public TestCase
+{
+public:
+  GmaTimerWheelTestCase ();
+  virtual ~GmaTimerWheelTestCase ();
+
+private:
+  virtual void DoRun (void);
+  void Expire (uint32_t index);
+
+  Ptr<GmaTimerWheel> m_wheel;
+  std::vector<Time> m_expectedList;
+  std::vector<Time> m_firedList;
+};
+
+GmaTimerWheelTestCase::GmaTimerWheelTestCase ()
+  : TestCase ("Gma hierarchical timer wheel")
+{
+}
+
+GmaTimerWheelTestCase::~GmaTimerWheelTestCase ()
+{
+}
+
+void
+GmaTimerWheelTestCase::Expire (uint32_t index)
+{
+  m_firedList[index] = Simulator::Now ();
+  if (index % 7 == 0 && m_expectedList.size () < 2000)
+    {
+      //schedule a new timer from a firing one.
+      Time delay = MicroSeconds (index * 3571 % 300000000);
+      m_expectedList.push_back (m_wheel->GetTickTime (Simulator::Now () + delay));
+      m_firedList.push_back (Seconds (-1));
+      m_wheel->Schedule (delay, &GmaTimerWheelTestCase::Expire, this, (uint32_t) m_expectedList.size () - 1);
+    }
+}
+
+void
+GmaTimerWheelTestCase::DoRun (void)
+{
+  m_wheel = Create<GmaTimerWheel> (MilliSeconds (1));
+  std::vector<GmaTimerWheel::TimerId> timerList;
+  uint32_t seed = 1;
+  for (uint32_t i = 0; i < 1000; i++)
+    {
+      seed = seed * 1103515245 + 12345;
+      //from sub tick delays to delays beyond the top level (262 s).
+      Time delay = MicroSeconds (1 + (seed >> 1) % (i % 4 == 0 ? 400000000 : 100000));
+      m_expectedList.push_back (m_wheel->GetTickTime (delay));
+      m_firedList.push_back (Seconds (-1));
+      timerList.push_back (m_wheel->Schedule (delay, &GmaTimerWheelTestCase::Expire, this, i));
+      NS_TEST_ASSERT_MSG_EQ (timerList.back ().GetTs (), m_expectedList.back (), "expire time");
+    }
+  for (uint32_t i = 0; i < timerList.size (); i += 10)
+    {
+      timerList[i].Cancel ();
+      NS_TEST_ASSERT_MSG_EQ (timerList[i].IsExpired (), true, "canceled timer");
+    }
+
+  Simulator::Run ();
+  for (uint32_t i = 0; i < m_expectedList.size (); i++)
+    {
+      if (i < timerList.size () && i % 10 == 0)
+        {
+          NS_TEST_ASSERT_MSG_EQ (m_firedList[i], Seconds (-1), "canceled timer " << i << " fired");
+        }
+      else
+        {
+          NS_TEST_ASSERT_MSG_EQ (m_firedList[i], m_expectedList[i], "timer " << i);
+        }
+    }
+  NS_TEST_ASSERT_MSG_EQ (timerList[1].IsRunning (), false, "expired timer");
+  NS_TEST_ASSERT_MSG_EQ (m_wheel->GetSize (), 0u, "all timers are removed");
+  m_wheel = nullptr;
+  Simulator::Destroy ();
+}
+
+// The delay algorithm must move traffic from the high delay link to the low
+// delay link and keep the sum of the split indexes equal to the splitting burst,
+// also for 2, 3 and 8 links with recorded random walk delays.
+class GmaRxControlDecisionTestCase : public TestCase
+{
+public:
+  GmaRxControlDecisionTestCase ();
+  virtual ~GmaRxControlDecisionTestCase ();
+
+protected:
+  GmaRxControlDecisionTestCase (std::string name);
+  //replay the same recorded measurements, the decisions per second is returned.
+  double RunLinks (uint8_t links, uint32_t decisions);
+
+private:
+  virtual void DoRun (void);
+  Ptr<GmaRxControl> CreateRxControl (const std::vector<uint8_t>& cidList);
+  Ptr<RxMeasurement> CreateMeasurement (const std::vector<uint8_t>& cidList, const std::vector<double>& delayList);
+};
+
+GmaRxControlDecisionTestCase::GmaRxControlDecisionTestCase ()
+  : TestCase ("Gma rx control splitting decision")
+{
+}
+
+GmaRxControlDecisionTestCase::GmaRxControlDecisionTestCase (std::string name)
+  : TestCase (name)
+{
+}
+
+GmaRxControlDecisionTestCase::~GmaRxControlDecisionTestCase ()
+{
+}
+
+Ptr<GmaRxControl>
+GmaRxControlDecisionTestCase::CreateRxControl (const std::vector<uint8_t>& cidList)
+{
+  Ptr<LinkState> linkState = CreateObject<LinkState> ();
+  Ptr<GmaRxControl> rxControl = CreateObject<GmaRxControl> ();
+  for (uint32_t i = 0; i < cidList.size (); i++)
+    {
+      linkState->AddLinkCid (cidList[i]);
+    }
+  rxControl->SetLinkState (linkState);
+  rxControl->SetSplittingBurst (32);
+  return rxControl;
+}
+
+Ptr<RxMeasurement>
+GmaRxControlDecisionTestCase::CreateMeasurement (const std::vector<uint8_t>& cidList, const std::vector<double>& delayList)
+{
+  Ptr<RxMeasurement> measurement = Create<RxMeasurement> ();
+  measurement->m_links = cidList.size ();
+  measurement->m_measureIntervalThreshS = 0.1;
+  measurement->m_measureIntervalDurationS = 0.1;
+  measurement->m_cidList = cidList;
+  measurement->m_delayThisInterval.assign (cidList.size (), true);
+  measurement->m_delayList = delayList;
+  measurement->m_minOwdLongTerm.assign (cidList.size (), 5);
+  measurement->m_lossRateList.assign (cidList.size (), 0);
+  measurement->m_highDelayRatioList.assign (cidList.size (), 0);
+  measurement->m_delayViolationPktNumList.assign (cidList.size (), 0);
+  measurement->m_totalPktNumList.assign (cidList.size (), 100);
+  measurement->m_splittingBurstRequirementEst = 32;
+  return measurement;
+}
+
+double
+GmaRxControlDecisionTestCase::RunLinks (uint8_t links, uint32_t decisions)
+{
+  //wifi (the low priority link that starts with all traffic), nr, lte and virtual cids.
+  std::vector<uint8_t> cidList = {WIFI_CID, CELLULAR_NR_CID, CELLULAR_LTE_CID, 3, 4, 5, 6, 7};
+  cidList.resize (links);
+
+  //record the measurements first, the delay of each link is a random walk.
+  std::vector<Ptr<RxMeasurement> > measurementList;
+  std::vector<double> delayList (links, 30);
+  uint32_t seed = links;
+  for (uint32_t i = 0; i < 1000; i++)
+    {
+      for (uint8_t ind = 0; ind < links; ind++)
+        {
+          seed = seed * 1103515245 + 12345;
+          delayList[ind] = std::max (1.0, delayList[ind] + (double)((seed >> 16) % 7) - 3);
+        }
+      measurementList.push_back (CreateMeasurement (cidList, delayList));
+    }
+
+  Ptr<GmaRxControl> rxControl = CreateRxControl (cidList);
+  uint32_t updates = 0;
+  auto start = std::chrono::steady_clock::now ();
+  for (uint32_t i = 0; i < decisions; i++)
+    {
+      Ptr<SplittingDecision> decision = rxControl->GetTrafficSplittingDecision (measurementList[i % measurementList.size ()]);
+      if (decision->m_update)
+        {
+          updates++;
+          uint32_t sum = 0;
+          for (uint8_t ind = 0; ind < decision->m_splitIndexList.size (); ind++)
+            {
+              sum += decision->m_splitIndexList[ind];
+            }
+          NS_TEST_ASSERT_MSG_EQ (sum, 32u, "the split indexes must sum up to the splitting burst");
+        }
+    }
+  double seconds = std::chrono::duration<double> (std::chrono::steady_clock::now () - start).count ();
+  NS_TEST_ASSERT_MSG_GT (updates, 0u, "the random walk delays must trigger updates");
+  return decisions / seconds;
+}
+
+void
+GmaRxControlDecisionTestCase::DoRun (void)
+{
+  //lte has lower delay than wifi, traffic moves to lte until no traffic is left over wifi.
+  std::vector<uint8_t> cidList = {WIFI_CID, CELLULAR_LTE_CID};
+  Ptr<GmaRxControl> rxControl = CreateRxControl (cidList);
+  uint8_t lastLteIndex = 0;
+  for (uint32_t i = 0; i < 40; i++)
+    {
+      Ptr<SplittingDecision> decision = rxControl->GetTrafficSplittingDecision (CreateMeasurement (cidList, {80 + (double) i, 10}));
+      if (lastLteIndex < 32)
+        {
+          NS_TEST_ASSERT_MSG_EQ (decision->m_update, true, "traffic moves to the low delay link");
+          NS_TEST_ASSERT_MSG_GT (decision->m_splitIndexList[1], lastLteIndex, "traffic moves to the low delay link");
+          lastLteIndex = decision->m_splitIndexList[1];
+        }
+      else
+        {
+          NS_TEST_ASSERT_MSG_EQ (decision->m_update, false, "no traffic is left over the high delay link");
+        }
+    }
+  NS_TEST_ASSERT_MSG_EQ (+lastLteIndex, 32, "all traffic over the low delay link");
+
+  for (uint8_t links : {2, 3, 8})
+    {
+      RunLinks (links, 2000);
+    }
+}
+
+// The decision throughput of the delay algorithm for 2, 3 and 8 links, 200k
+// decisions per run. The split is checked as in GmaRxControlDecisionTestCase.
+class GmaRxControlDecisionSpeedTestCase : public GmaRxControlDecisionTestCase
+{
+public:
+  GmaRxControlDecisionSpeedTestCase ();
+  virtual ~GmaRxControlDecisionSpeedTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+GmaRxControlDecisionSpeedTestCase::GmaRxControlDecisionSpeedTestCase ()
+  : GmaRxControlDecisionTestCase ("Gma rx control splitting decision speed")
+{
+}
+
+GmaRxControlDecisionSpeedTestCase::~GmaRxControlDecisionSpeedTestCase ()
+{
+}
+
+void
+GmaRxControlDecisionSpeedTestCase::DoRun (void)
+{
+  for (uint8_t links : {2, 3, 8})
+    {
+      double rate = RunLinks (links, 200000);
+      NS_LOG_INFO ("rx control delay algorithm (" << +links << " links): " << rate << " decisions/s");
+    }
+}
+
+// A policy added to the registry outside of GmaRxControl: all traffic goes to
+// the last link of the measurement.
+class GmaLastLinkRxPolicy : public GmaRxPolicy
+{
+public:
+  Ptr<SplittingDecision> GetDecision (GmaRxControl& rxControl, Ptr<RxMeasurement> measurement) override
+  {
+    Ptr<SplittingDecision> decision = Create<SplittingDecision> ();
+    decision->m_splitIndexList.assign (measurement->m_links, 0);
+    decision->m_splitIndexList.back () = rxControl.GetSplittingBurst ();
+    decision->m_update = decision->m_splitIndexList != rxControl.GetLastSplittingIndexList ();
+    return decision;
+  }
+};
+
+GMA_RX_POLICY_REGISTER ("TestLastLink", GmaLastLinkRxPolicy);
+
+// A registered policy is selected by name, its split is stored by the rx
+// control, and the built-in algorithms are still selected by the attribute.
+class GmaRxPolicyRegistryTestCase : public TestCase
+{
+public:
+  GmaRxPolicyRegistryTestCase ();
+  virtual ~GmaRxPolicyRegistryTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+GmaRxPolicyRegistryTestCase::GmaRxPolicyRegistryTestCase ()
+  : TestCase ("Gma rx splitting policy registry")
+{
+}
+
+GmaRxPolicyRegistryTestCase::~GmaRxPolicyRegistryTestCase ()
+{
+}
+
+void
+GmaRxPolicyRegistryTestCase::DoRun (void)
+{
+  std::vector<std::string> nameList = GmaRxPolicyRegistry::GetNameList ();
+  NS_TEST_ASSERT_MSG_EQ (std::count (nameList.begin (), nameList.end (), "gma"), 1, "built-in policies are registered");
+  NS_TEST_ASSERT_MSG_EQ (GmaRxPolicyRegistry::Contains ("TestLastLink"), true, "test policy is registered");
+
+  std::vector<uint8_t> cidList = {WIFI_CID, CELLULAR_LTE_CID};
+  Ptr<LinkState> linkState = CreateObject<LinkState> ();
+  linkState->AddLinkCid (WIFI_CID);
+  linkState->AddLinkCid (CELLULAR_LTE_CID);
+  Ptr<GmaRxControl> rxControl = CreateObject<GmaRxControl> ();
+  rxControl->SetLinkState (linkState);
+  rxControl->SetSplittingBurst (32);
+  NS_TEST_ASSERT_MSG_EQ (rxControl->GetAlgorithm (), "Delay", "default algorithm");
+
+  Ptr<RxMeasurement> measurement = Create<RxMeasurement> ();
+  measurement->m_links = 2;
+  measurement->m_cidList = cidList;
+  measurement->m_delayThisInterval.assign (2, true);
+  measurement->m_delayList = {10, 10};
+  measurement->m_minOwdLongTerm.assign (2, 5);
+  measurement->m_lossRateList.assign (2, 0);
+
+  rxControl->SetAlgorithm ("TestLastLink");
+  NS_TEST_ASSERT_MSG_EQ (rxControl->GetAlgorithmType (), GmaRxControl::Policy, "registered policy");
+  Ptr<SplittingDecision> decision = rxControl->GetTrafficSplittingDecision (measurement);
+  NS_TEST_ASSERT_MSG_EQ (decision->m_update, true, "first decision of the policy");
+  NS_TEST_ASSERT_MSG_EQ (+rxControl->GetLastSplittingIndexList ().at (1), 32, "the split of the policy is stored");
+  decision = rxControl->GetTrafficSplittingDecision (measurement);
+  NS_TEST_ASSERT_MSG_EQ (decision->m_update, false, "the split does not change");
+
+  rxControl->SetAttribute ("SplittingAlgorithm", EnumValue (GmaRxControl::gma));
+  NS_TEST_ASSERT_MSG_EQ (rxControl->GetAlgorithm (), "gma", "built-in algorithm selected by the attribute");
+  measurement->m_delayList = {10, 30};
+  decision = rxControl->GetTrafficSplittingDecision (measurement);
+  NS_TEST_ASSERT_MSG_EQ (decision->m_update, true, "the delay algorithm continues from the split of the policy");
+  NS_TEST_ASSERT_MSG_EQ (+decision->m_splitIndexList.at (0), 1, "traffic moves to the low delay link");
+}
+
+// The decision trace must read back the recorded measurements, and replaying it
+// against the same rx control configuration must reproduce every decision.
+class GmaDecisionTraceTestCase : public TestCase
+{
+public:
+  GmaDecisionTraceTestCase ();
+  virtual ~GmaDecisionTraceTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+GmaDecisionTraceTestCase::GmaDecisionTraceTestCase ()
+  : TestCase ("Gma decision trace record and replay")
+{
+}
+
+GmaDecisionTraceTestCase::~GmaDecisionTraceTestCase ()
+{
+}
+
+void
+GmaDecisionTraceTestCase::DoRun (void)
+{
+  std::string fileName = CreateTempDirFilename ("gma-decision-trace.bin");
+  const uint32_t intervals = 2000;
+  std::vector<uint8_t> cidList = {WIFI_CID, CELLULAR_NR_CID, CELLULAR_LTE_CID};
+  Ptr<LinkState> linkState = CreateObject<LinkState> ();
+  for (uint32_t ind = 0; ind < cidList.size (); ind++)
+    {
+      linkState->AddLinkCid (cidList[ind]);
+    }
+  Ptr<GmaRxControl> rxControl = CreateObject<GmaRxControl> ();
+  rxControl->SetLinkState (linkState);
+  rxControl->SetSplittingBurst (32);
+
+  //record the decisions of random walk delays and losses, nr is down for some intervals.
+  GmaDecisionTrace trace;
+  trace.Open (fileName);
+  std::vector<Ptr<RxMeasurement> > measurementList;
+  std::vector<double> delayList (cidList.size (), 30);
+  uint32_t seed = 7;
+  uint32_t updates = 0;
+  for (uint32_t i = 0; i < intervals; i++)
+    {
+      Ptr<RxMeasurement> measurement = Create<RxMeasurement> ();
+      measurement->m_links = cidList.size ();
+      measurement->m_measureIntervalThreshS = 0.1;
+      measurement->m_measureIntervalDurationS = 0.1 + i % 10 * 0.01;
+      measurement->m_splittingBurstRequirementEst = i % 64;
+      measurement->m_cidList = cidList;
+      for (uint32_t ind = 0; ind < cidList.size (); ind++)
+        {
+          seed = seed * 1103515245 + 12345;
+          delayList[ind] = std::max (1.0, delayList[ind] + (double)((seed >> 16) % 7) - 3);
+          measurement->m_delayThisInterval.push_back ((seed >> 8) % 5 != 0);
+          measurement->m_delayList.push_back (delayList[ind]);
+          measurement->m_minOwdLongTerm.push_back (5 + ind);
+          measurement->m_lossRateList.push_back ((seed >> 4) % 10 == 0 ? 0.01 * ((seed >> 12) % 10) : 0);
+          measurement->m_delayViolationPktNumList.push_back ((seed >> 20) % 10);
+          measurement->m_totalPktNumList.push_back (100 + (seed >> 20) % 100);
+        }
+      if (i % 200 == 100)
+        {
+          //the link down tsu changes the split between two decisions.
+          linkState->CtrlMsgDown (CELLULAR_NR_CID);
+          rxControl->LinkDownTsu (CELLULAR_NR_CID);
+        }
+      else if (i % 200 == 150)
+        {
+          linkState->CtrlMsgUp (CELLULAR_NR_CID);
+        }
+      trace.Prepare (rxControl);
+      Ptr<SplittingDecision> decision = rxControl->GetTrafficSplittingDecision (measurement);
+      trace.Add (measurement, decision);
+      updates += decision->m_update;
+      measurementList.push_back (measurement);
+    }
+  trace.Close ();
+
+  std::vector<GmaDecisionTrace::Entry> entryList = GmaDecisionTrace::Read (fileName);
+  NS_TEST_ASSERT_MSG_EQ (entryList.size (), intervals, "every record is written");
+  for (uint32_t i = 0; i < intervals; i++)
+    {
+      Ptr<RxMeasurement> measurement = entryList[i].m_measurement;
+      NS_TEST_ASSERT_MSG_EQ (+entryList[i].m_splittingBurst, 32, "splitting burst");
+      NS_TEST_ASSERT_MSG_EQ (measurement->m_splittingBurstRequirementEst, measurementList[i]->m_splittingBurstRequirementEst, "burst requirement");
+      NS_TEST_ASSERT_MSG_EQ (measurement->m_measureIntervalDurationS, measurementList[i]->m_measureIntervalDurationS, "interval duration");
+      NS_TEST_ASSERT_MSG_EQ ((measurement->m_cidList == cidList), true, "cid list");
+      NS_TEST_ASSERT_MSG_EQ ((measurement->m_delayThisInterval == measurementList[i]->m_delayThisInterval), true, "delay this interval");
+      NS_TEST_ASSERT_MSG_EQ ((measurement->m_delayList == measurementList[i]->m_delayList), true, "delay list");
+      NS_TEST_ASSERT_MSG_EQ ((measurement->m_lossRateList == measurementList[i]->m_lossRateList), true, "loss list");
+      NS_TEST_ASSERT_MSG_EQ ((measurement->m_totalPktNumList == measurementList[i]->m_totalPktNumList), true, "packet number list");
+      NS_TEST_ASSERT_MSG_EQ (measurement->m_highDelayRatioList.size (), 0u, "no high delay ratio is recorded");
+      NS_TEST_ASSERT_MSG_EQ ((bool) entryList[i].m_linkUpList[1], (i % 200 < 100 || i % 200 >= 150), "nr link state");
+      NS_TEST_ASSERT_MSG_EQ (entryList[i].m_lastSplitIndexList.size (), i == 0 ? 0u : cidList.size (), "split before the decision");
+      if (i % 200 == 100)
+        {
+          NS_TEST_ASSERT_MSG_EQ (+entryList[i].m_lastSplitIndexList[1], 0, "the link down tsu is recorded");
+        }
+    }
+
+  //the same configuration reproduces the recorded decisions.
+  Ptr<GmaRxControl> replayControl = CreateObject<GmaRxControl> ();
+  replayControl->SetLinkState (GmaDecisionTrace::CreateLinkState (entryList));
+  replayControl->SetSplittingBurst (entryList.front ().m_splittingBurst);
+  GmaDecisionTrace::ReplayResult result = GmaDecisionTrace::Replay (entryList, replayControl);
+  NS_TEST_ASSERT_MSG_EQ (result.m_decisions, intervals, "every record is replayed");
+  NS_TEST_ASSERT_MSG_EQ (result.m_updates, updates, "same number of updates");
+  NS_TEST_ASSERT_MSG_EQ (result.m_mismatches, 0u, "the replay reproduces the recorded decisions");
+
+  //another configuration makes different decisions.
+  replayControl = CreateObject<GmaRxControl> ();
+  replayControl->SetLinkState (GmaDecisionTrace::CreateLinkState (entryList));
+  replayControl->SetSplittingBurst (entryList.front ().m_splittingBurst);
+  replayControl->SetAttribute ("EnableStableAlgorithm", BooleanValue (false));
+  result = GmaDecisionTrace::Replay (entryList, replayControl);
+  NS_TEST_ASSERT_MSG_GT (result.m_mismatches, 0u, "the stable algorithm changes the decisions");
+}
+
+// The window bandwidth estimate must match the mean of the last intervals
+// computed by brute force, and the rx control must report the estimate of
+// each link.
+class GmaBwEstimatorTestCase : public TestCase
+{
+public:
+  GmaBwEstimatorTestCase ();
+  virtual ~GmaBwEstimatorTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+GmaBwEstimatorTestCase::GmaBwEstimatorTestCase ()
+  : TestCase ("Gma bandwidth estimator")
+{
+}
+
+GmaBwEstimatorTestCase::~GmaBwEstimatorTestCase ()
+{
+}
+
+void
+GmaBwEstimatorTestCase::DoRun (void)
+{
+  for (uint32_t histSize : {1u, 3u, 10u, GmaBwEstimator::MAX_HIST_SIZE})
+    {
+      GmaBwEstimator estimator;
+      estimator.SetHistSize (histSize);
+      NS_TEST_ASSERT_MSG_EQ (estimator.GetBw (), -1.0, "no sample");
+      std::vector<double> bwList;
+      std::vector<uint32_t> splitIndexList;
+      uint32_t seed = histSize;
+      for (uint32_t i = 0; i < 5000; i++)
+        {
+          seed = seed * 1103515245 + 12345;
+          double bw = (seed >> 8) % 100000 / 7.0;
+          estimator.Update (bw, seed % 33);
+          bwList.push_back (bw);
+          splitIndexList.push_back (seed % 33);
+
+          uint32_t first = bwList.size () > histSize ? bwList.size () - histSize : 0;
+          double bwSum = 0;
+          double splitIndexSum = 0;
+          for (uint32_t j = first; j < bwList.size (); j++)
+            {
+              bwSum += bwList[j];
+              splitIndexSum += splitIndexList[j];
+            }
+          uint32_t size = bwList.size () - first;
+          NS_TEST_ASSERT_MSG_EQ (estimator.GetSize (), size, "history size");
+          NS_TEST_ASSERT_MSG_EQ_TOL (estimator.GetBw (), bwSum / size, 1e-6, "window mean at interval " << i);
+          NS_TEST_ASSERT_MSG_EQ_TOL (estimator.GetSplitIndexMean (), splitIndexSum / size, 1e-9, "split index mean at interval " << i);
+        }
+    }
+
+  GmaBwEstimator ewma;
+  ewma.SetMode (GmaBwEstimator::EWMA);
+  ewma.SetEwmaAlpha (0.25);
+  ewma.Update (100, 0);
+  ewma.Update (200, 0);
+  NS_TEST_ASSERT_MSG_EQ_TOL (ewma.GetBw (), 125.0, 1e-9, "ewma");
+
+  //the kalman estimate of a noisy constant bandwidth converges to it.
+  GmaBwEstimator kalman;
+  kalman.SetMode (GmaBwEstimator::KALMAN);
+  uint32_t seed = 3;
+  for (uint32_t i = 0; i < 200; i++)
+    {
+      seed = seed * 1103515245 + 12345;
+      kalman.Update (1000 * (0.8 + (seed >> 8) % 1000 / 2500.0), 0);
+    }
+  NS_TEST_ASSERT_MSG_EQ_TOL (kalman.GetBw (), 1000.0, 100.0, "kalman");
+
+  std::vector<uint8_t> cidList = {WIFI_CID, CELLULAR_LTE_CID};
+  Ptr<LinkState> linkState = CreateObject<LinkState> ();
+  linkState->AddLinkCid (WIFI_CID);
+  linkState->AddLinkCid (CELLULAR_LTE_CID);
+  Ptr<GmaRxControl> rxControl = CreateObject<GmaRxControl> ();
+  rxControl->SetLinkState (linkState);
+  rxControl->SetSplittingBurst (32);
+  NS_TEST_ASSERT_MSG_EQ (rxControl->GetBwEstimate (WIFI_CID), -1.0, "no measurement");
+  NS_TEST_ASSERT_MSG_EQ (rxControl->GetBwEstimate (CELLULAR_NR_CID), -1.0, "nr is not added");
+  for (uint32_t i = 0; i < 20; i++)
+    {
+      Ptr<RxMeasurement> measurement = Create<RxMeasurement> ();
+      measurement->m_links = 2;
+      measurement->m_measureIntervalThreshS = 0.1;
+      measurement->m_measureIntervalDurationS = 0.2;
+      measurement->m_cidList = cidList;
+      measurement->m_delayThisInterval.assign (2, true);
+      measurement->m_delayList = {10, 10};
+      measurement->m_minOwdLongTerm.assign (2, 5);
+      measurement->m_lossRateList.assign (2, 0);
+      measurement->m_totalPktNumList = {100 + i, 2 * i};
+      rxControl->GetTrafficSplittingDecision (measurement);
+    }
+  //the mean of the last 10 intervals (i = 10 ... 19), the interval is 0.2 s.
+  NS_TEST_ASSERT_MSG_EQ_TOL (rxControl->GetBwEstimate (WIFI_CID), (100 + 14.5) / 0.2, 1e-9, "wifi bandwidth");
+  NS_TEST_ASSERT_MSG_EQ_TOL (rxControl->GetBwEstimate (CELLULAR_LTE_CID), 2 * 14.5 / 0.2, 1e-9, "lte bandwidth");
+}
+
+// Every warm-started episode is forked from the same snapshot, the poisson
+// arrivals of an episode must follow the seed of the episode after reseeding.
+class GmaPoissonReseedTestCase : public TestCase
+{
+public:
+  GmaPoissonReseedTestCase ();
+  virtual ~GmaPoissonReseedTestCase ();
+
+private:
+  //fork an episode from the simulation, return the time (ns) of the last packet of the episode.
+  int64_t RunEpisode (bool reseed, uint32_t run);
+  virtual void DoRun (void);
+  NodeContainer m_nodes;
+};
+
+GmaPoissonReseedTestCase::GmaPoissonReseedTestCase ()
+  : TestCase ("Gma poisson arrivals of episodes forked from a snapshot")
+{
+}
+
+GmaPoissonReseedTestCase::~GmaPoissonReseedTestCase ()
+{
+}
+
+int64_t
+GmaPoissonReseedTestCase::RunEpisode (bool reseed, uint32_t run)
+{
+  int resultPipe[2];
+  NS_ABORT_MSG_IF (pipe (resultPipe) != 0, "cannot create the result pipe");
+  std::cout.flush ();
+  pid_t pid = fork ();
+  NS_ABORT_MSG_IF (pid < 0, "cannot fork the episode");
+  if (pid == 0)
+    {
+      close (resultPipe[0]);
+      if (reseed)
+        {
+          RngSeedManager::SetRun (run);
+          PoissonUdpClientHelper ().AssignStreams (m_nodes, 1);
+        }
+      //the client stops after MaxPackets, the last event is the last packet.
+      Simulator::Run ();
+      int64_t lastPacketNs = Simulator::Now ().GetNanoSeconds ();
+      bool written = write (resultPipe[1], &lastPacketNs, sizeof lastPacketNs) == sizeof lastPacketNs;
+      _exit (written ? 0 : 1);
+    }
+  close (resultPipe[1]);
+  int64_t lastPacketNs = -1;
+  if (read (resultPipe[0], &lastPacketNs, sizeof lastPacketNs) != sizeof lastPacketNs)
+    {
+      lastPacketNs = -1;
+    }
+  close (resultPipe[0]);
+  int status = 0;
+  waitpid (pid, &status, 0);
+  return lastPacketNs;
+}
+
+void
+GmaPoissonReseedTestCase::DoRun (void)
+{
+  m_nodes.Create (1);
+  InternetStackHelper internet;
+  internet.SetIpv6StackInstall (false);
+  internet.Install (m_nodes);
+  PoissonUdpClientHelper client (Ipv4Address::GetLoopback (), 9);
+  client.SetAttribute ("MaxPackets", UintegerValue (200));
+  client.SetAttribute ("Interval", TimeValue (MilliSeconds (1)));
+  client.SetAttribute ("PacketSize", UintegerValue (100));
+  client.Install (m_nodes).Start (Seconds (0));
+  //the snapshot, warmed up with about 50 packets.
+  Simulator::Stop (MilliSeconds (50));
+  Simulator::Run ();
+
+  int64_t snapshotEpisode = RunEpisode (false, 0);
+  NS_TEST_ASSERT_MSG_GT (snapshotEpisode, MilliSeconds (50).GetNanoSeconds (), "the episode continues the snapshot");
+  NS_TEST_ASSERT_MSG_EQ (RunEpisode (false, 0), snapshotEpisode, "without reseeding, every episode replays the randomness of the snapshot");
+  int64_t seed2Episode = RunEpisode (true, 2);
+  NS_TEST_ASSERT_MSG_GT (seed2Episode, MilliSeconds (50).GetNanoSeconds (), "the reseeded episode continues the snapshot");
+  NS_TEST_ASSERT_MSG_EQ (RunEpisode (true, 2), seed2Episode, "the episodes with the same seed are the same");
+  NS_TEST_ASSERT_MSG_NE (RunEpisode (true, 3), seed2Episode, "the episodes with different seeds diverge");
+  NS_TEST_ASSERT_MSG_NE (seed2Episode, snapshotEpisode, "the reseeded episode diverges from the snapshot randomness");
+  Simulator::Destroy ();
+}
+
 // The TestSuite class names the TestSuite, identifies what type of TestSuite,
 // and enables the TestCases to be run.  Typically, only the constructor for
 // this class must be defined
@@ -59,6 +1405,22 @@ GmaTestSuite::GmaTestSuite ()
 {
   // TestDuration for TestCase can be QUICK, EXTENSIVE or TAKES_FOREVER
   AddTestCase (new GmaTestCase1, TestCase::QUICK);
+  AddTestCase (new GmaReorderingBufferTestCase, TestCase::QUICK);
+  AddTestCase (new GmaReorderingBufferSpeedTestCase, TestCase::EXTENSIVE);
+  AddTestCase (new GmaTxHeaderTestCase, TestCase::QUICK);
+  AddTestCase (new GmaTxHeaderSpeedTestCase, TestCase::EXTENSIVE);
+  AddTestCase (new GmaCidTableTestCase, TestCase::QUICK);
+  AddTestCase (new GmaSplitScheduleTestCase, TestCase::QUICK);
+  AddTestCase (new GmaQuantileSketchTestCase, TestCase::QUICK);
+  AddTestCase (new GmaPacketTraceTestCase, TestCase::QUICK);
+  AddTestCase (new GmaWindowedFilterTestCase, TestCase::QUICK);
+  AddTestCase (new GmaTimerWheelTestCase, TestCase::QUICK);
+  AddTestCase (new GmaRxControlDecisionTestCase, TestCase::QUICK);
+  AddTestCase (new GmaRxControlDecisionSpeedTestCase, TestCase::EXTENSIVE);
+  AddTestCase (new GmaRxPolicyRegistryTestCase, TestCase::QUICK);
+  AddTestCase (new GmaDecisionTraceTestCase, TestCase::QUICK);
+  AddTestCase (new GmaBwEstimatorTestCase, TestCase::QUICK);
+  AddTestCase (new GmaPoissonReseedTestCase, TestCase::QUICK);
 }
 
 // Do not forget to allocate an instance of this TestSuite
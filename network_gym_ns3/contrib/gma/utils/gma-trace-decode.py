@@ -0,0 +1,42 @@
+#Copyright(C) 2024 Intel Corporation
+#SPDX-License-Identifier: GPL-2.0
+#https://spdx.org/licenses/GPL-2.0.html
+#File : gma-trace-decode.py
+
+#decode the per packet trace of a gma interface (GmaVirtualInterface::PacketTraceFile) to csv.
+#usage: python3 gma-trace-decode.py <trace.bin> [output.csv]
+
+import struct
+import sys
+
+MAGIC = b"GMATRACE"
+VERSION = 1
+RECORD = struct.Struct("<qIIHBBBBH") #time_ns, sn, owd_ms, size, cid, lsn, event, flow_id, reserved
+EVENT_NAME = {0: "tx", 1: "rx", 2: "deliver"}
+
+def decode(input_file, output):
+    magic = input_file.read(len(MAGIC))
+    if magic != MAGIC:
+        raise ValueError("not a gma packet trace file")
+    version, record_size = struct.unpack("<II", input_file.read(8))
+    if version != VERSION or record_size != RECORD.size:
+        raise ValueError("unsupported gma packet trace version " + str(version))
+
+    output.write("time_s,event,cid,flow_id,sn,lsn,owd_ms,size\n")
+    while True:
+        data = input_file.read(RECORD.size * 4096)
+        if not data:
+            break
+        for time_ns, sn, owd_ms, size, cid, lsn, event, flow_id, _ in RECORD.iter_unpack(data[:len(data) - len(data) % RECORD.size]):
+            output.write("%.9f,%s,%d,%d,%d,%d,%d,%d\n" % (time_ns/1e9, EVENT_NAME.get(event, event), cid, flow_id, sn, lsn, owd_ms, size))
+
+if __name__ == "__main__":
+    if len(sys.argv) < 2:
+        print("usage: python3 gma-trace-decode.py <trace.bin> [output.csv]")
+        sys.exit(1)
+    with open(sys.argv[1], "rb") as input_file:
+        if len(sys.argv) > 2:
+            with open(sys.argv[2], "w") as output:
+                decode(input_file, output)
+        else:
+            decode(input_file, sys.stdout)
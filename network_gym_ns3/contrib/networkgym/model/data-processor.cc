@@ -9,50 +9,190 @@
 #include <sys/time.h>
 #include <unistd.h>
 #include <chrono>
+#include <algorithm>
 using json = nlohmann::json;
 
 namespace ns3 {
 
 
+void
+MeasurementSubscription::Add (const std::string& sourceAndName)
+{
+  auto pos = sourceAndName.find("::");
+  if (pos == std::string::npos)
+  {
+    NS_FATAL_ERROR("subscribed measurement should use the \"source::name\" format, but received: " << sourceAndName);
+  }
+  m_sourceToNameSet[sourceAndName.substr(0, pos)].insert(sourceAndName.substr(pos + 2));
+}
+
+bool
+MeasurementSubscription::IsSubscribed (const std::string& source, const std::string& name) const
+{
+  auto nameSet = GetNameSet(source);
+  return nameSet != nullptr && nameSet->find(name) != nameSet->end();
+}
+
+const std::unordered_set<std::string>*
+MeasurementSubscription::GetNameSet (const std::string& source) const
+{
+  auto iter = m_sourceToNameSet.find(source);
+  if (iter == m_sourceToNameSet.end())
+  {
+    return nullptr;
+  }
+  return &iter->second;
+}
+
 NetworkStats::NetworkStats (std::string source, uint64_t id, uint64_t ts)
 {
   m_source = source;
   m_id = id;
   m_ts = ts;
 }
+
+NetworkStats::NetworkStats (std::string source, uint64_t id, uint64_t ts, Ptr<MeasurementSubscription> subscription)
+  : NetworkStats (source, id, ts)
+{
+  m_subscription = subscription;
+  if (m_subscription)
+  {
+    m_subscribedNames = m_subscription->GetNameSet(m_source);
+  }
+}
 NetworkStats::~NetworkStats ()
 {
 
 }
 
-json
-NetworkStats::GetJson()
+uint32_t
+NetworkStats::InternName (const std::string& name)
 {
-  return m_data;
+  static std::unordered_map<std::string, uint32_t> nameToIdMap;
+  auto iter = nameToIdMap.find(name);
+  if (iter == nameToIdMap.end())
+  {
+    iter = nameToIdMap.emplace(name, nameToIdMap.size()).first;
+    GetInternedNameList().push_back(name);
+  }
+  return iter->second;
 }
 
-void
-NetworkStats::Append(std::string name, double value)
+std::deque<std::string>&
+NetworkStats::GetInternedNameList ()
+{
+  static std::deque<std::string> nameList; //deque keeps the references returned by GetInternedName valid.
+  return nameList;
+}
+
+const std::string&
+NetworkStats::GetInternedName (uint32_t nameId)
 {
+  return GetInternedNameList().at(nameId);
+}
+
+json
+NetworkStats::GetJson()
+{
+  json data;
+  for (uint32_t index = 0; index < m_recordList.size(); index++)
+  {
     json measurement;
     measurement["source"] = m_source;
     measurement["id"].push_back(m_id);
     measurement["ts"] = m_ts;
-    measurement["name"] = name;
-    measurement["value"].push_back(value);
-    m_data.push_back(measurement);
+    measurement["name"] = GetInternedName(m_recordList[index].m_nameId);
+    measurement["value"].push_back(GetValue(index));
+    data.push_back(measurement);
+  }
+  return data;
+}
+
+const std::string&
+NetworkStats::GetSource ()
+{
+  return m_source;
+}
+
+uint64_t
+NetworkStats::GetId ()
+{
+  return m_id;
+}
+
+uint64_t
+NetworkStats::GetTs ()
+{
+  return m_ts;
+}
+
+uint32_t
+NetworkStats::GetSize ()
+{
+  return m_recordList.size();
+}
+
+uint32_t
+NetworkStats::GetNameId (uint32_t index)
+{
+  return m_recordList.at(index).m_nameId;
+}
+
+json
+NetworkStats::GetValue (uint32_t index)
+{
+  const Record& record = m_recordList.at(index);
+  if (record.m_jsonIndex < 0)
+  {
+    return record.m_value;
+  }
+  return m_jsonValueList.at(record.m_jsonIndex);
+}
+
+bool
+NetworkStats::IsSubscribed(const std::string& name)
+{
+  if (!m_subscription)
+  {
+    return true;
+  }
+  return m_subscribedNames != nullptr && m_subscribedNames->find(name) != m_subscribedNames->end();
+}
+
+void
+NetworkStats::AppendRecord (const std::string& name, double value, int32_t jsonIndex)
+{
+  Record record;
+  record.m_nameId = InternName(name);
+  record.m_jsonIndex = jsonIndex;
+  record.m_value = value;
+  m_recordList.push_back(record);
+}
+
+void
+NetworkStats::Append(std::string name, double value)
+{
+    if (!IsSubscribed(name))
+    {
+      return;
+    }
+    AppendRecord(name, value, -1);
 }
 
 void
 NetworkStats::Append(std::string name, json& value)
 {
-    json measurement;
-    measurement["source"] = m_source;
-    measurement["id"].push_back(m_id);
-    measurement["ts"] = m_ts;
-    measurement["name"] = name;
-    measurement["value"].push_back(value);
-    m_data.push_back(measurement);
+    if (!IsSubscribed(name))
+    {
+      return;
+    }
+    if (value.is_number_float())
+    {
+      AppendRecord(name, value.get<double>(), -1);
+      return;
+    }
+    m_jsonValueList.push_back(value);
+    AppendRecord(name, 0, m_jsonValueList.size() - 1);
 }
 
 void
@@ -62,18 +202,127 @@ NetworkStats::Append(std::string name, std::string indexName, std::vector<int> i
     {
       NS_FATAL_ERROR("The size of the indexName and list is not the same!!!");
     }
-    json measurement;
-    measurement["source"] = m_source;
-    measurement["id"].push_back(m_id);
-    measurement["ts"] = m_ts;
-    measurement["name"] = name;
+    if (!IsSubscribed(name))
+    {
+      return;
+    }
     json item;
     item[indexName] = indexList;
     item["value"] = list;
+    m_jsonValueList.push_back(item);
+    AppendRecord(name, 0, m_jsonValueList.size() - 1);
+}
 
-    measurement["value"].push_back(item);
+MeasurementAggregator::Entry&
+MeasurementAggregator::GetEntry (const std::string& source, const std::string& name, const json& ts)
+{
+  //reuse the key buffer to avoid an allocation per measurement.
+  m_keyBuffer.assign(source);
+  m_keyBuffer.append("::");
+  m_keyBuffer.append(name);
 
-    m_data.push_back(measurement);
+  auto iter = m_keyToIndexMap.find(m_keyBuffer);
+  if (iter == m_keyToIndexMap.end())
+  {
+    //first measurement with this source and name.
+    iter = m_keyToIndexMap.emplace(m_keyBuffer, m_entryList.size()).first;
+    m_entryList.emplace_back();
+    m_entryList.back().m_source = source;
+    m_entryList.back().m_name = name;
+    m_entryList.back().m_ts = ts;
+  }
+  Entry& entry = m_entryList.at(iter->second);
+  if (entry.m_ts != ts)
+  {
+    NS_FATAL_ERROR("the timestamp of two measurements are different!");
+  }
+  entry.m_mergeCounter++;
+  return entry;
+}
+
+void
+MeasurementAggregator::Add (const json& measurementList)
+{
+  for(auto it = measurementList.begin(); it != measurementList.end(); ++it)
+  {
+    Entry& entry = GetEntry((*it)["source"].get_ref<const std::string&>(), (*it)["name"].get_ref<const std::string&>(), (*it)["ts"]);
+    const json& idList = (*it)["id"];
+    const json& valueList = (*it)["value"];
+    if (idList.size() != valueList.size())
+    {
+      NS_FATAL_ERROR("The size of the id and value list is not the same!!!");
+    }
+    for (uint32_t ind = 0; ind < idList.size(); ind++)
+    {
+      entry.m_idList.push_back(idList[ind].get<uint64_t>());
+      entry.m_valueList.push_back(valueList[ind]);
+    }
+  }
+}
+
+void
+MeasurementAggregator::Add (Ptr<NetworkStats> measurement, Ptr<MeasurementSubscription> subscription)
+{
+  const std::string& source = measurement->GetSource();
+  json ts = measurement->GetTs();
+  for (uint32_t index = 0; index < measurement->GetSize(); index++)
+  {
+    const std::string& name = NetworkStats::GetInternedName(measurement->GetNameId(index));
+    if (subscription && !subscription->IsSubscribed(source, name))
+    {
+      continue;
+    }
+    Entry& entry = GetEntry(source, name, ts);
+    entry.m_idList.push_back(measurement->GetId());
+    entry.m_valueList.push_back(measurement->GetValue(index));
+  }
+}
+
+bool
+MeasurementAggregator::IsEmpty ()
+{
+  return m_entryList.empty();
+}
+
+json
+MeasurementAggregator::Flush ()
+{
+  json networkStats;
+  std::vector<uint32_t> order;
+  for (auto& entry : m_entryList)
+  {
+    json measurement;
+    measurement["source"] = entry.m_source;
+    measurement["ts"] = entry.m_ts;
+    measurement["name"] = entry.m_name;
+    json idList = json::array();
+    json valueList = json::array();
+
+    order.resize(entry.m_idList.size());
+    for (uint32_t ind = 0; ind < order.size(); ind++)
+    {
+      order[ind] = ind;
+    }
+    if (entry.m_mergeCounter > 1)
+    {
+      //sort once at flush time. stable sort keeps the arrival order for the same id.
+      //a single measurement keeps its own order, e.g., the per cell measurement.
+      std::stable_sort(order.begin(), order.end(), [&entry](uint32_t a, uint32_t b) {
+        return entry.m_idList[a] < entry.m_idList[b];
+      });
+    }
+    for (uint32_t ind : order)
+    {
+      idList.push_back(entry.m_idList[ind]);
+      valueList.push_back(std::move(entry.m_valueList[ind]));
+    }
+    measurement["id"] = std::move(idList);
+    measurement["value"] = std::move(valueList);
+    networkStats.push_back(std::move(measurement));
+  }
+  m_entryList.clear();
+  m_keyToIndexMap.clear();
+  return networkStats;
 }
 
 NS_LOG_COMPONENT_DEFINE ("DataProcessor");
@@ -95,8 +344,16 @@ DataProcessor::DataProcessor ()
 {
   NS_LOG_FUNCTION (this);
   m_southbound = CreateObject<SouthboundInterface>();
+  LoadEnvConfig();
+}
+
+void
+DataProcessor::LoadEnvConfig ()
+{
   m_waitCounter = 0;
   m_waitSysTimeMs = 0;
+  m_measurementCounter = 0;
+  m_pendingActionTsMs.clear();
   m_startSysTimeMs = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
   //std::cout << "ns3 starts at :"<< m_startSysTimeMs << " milliseconds since the Epoch\n";
 
@@ -104,11 +361,30 @@ DataProcessor::DataProcessor ()
   json jsonConfigEnv;
   jsonStreamEnv >> jsonConfigEnv;
   m_totalSteps = jsonConfigEnv["steps_per_episode"].get<uint64_t>() * jsonConfigEnv["episodes_per_session"].get<uint64_t>();
+  if (jsonConfigEnv.contains("action_lag_steps"))
+  {
+    //pipelined mode, the simulator keeps running while the agent computes the action.
+    m_actionLagSteps = jsonConfigEnv["action_lag_steps"].get<uint32_t>();
+  }
+  m_subscription = Create<MeasurementSubscription>();
   uint32_t mSize = jsonConfigEnv["subscribed_network_stats"].size();
   for (uint32_t i = 0; i < mSize; i++)
   {
     //std::cout << jsonConfigEnv["subscribed_network_stats"].at(i) << std::endl;
-    m_subscribedMeasurement.push_back(jsonConfigEnv["subscribed_network_stats"].at(i));
+    m_subscription->Add(jsonConfigEnv["subscribed_network_stats"].at(i).get<std::string>());
+  }
+
+  m_stepEndUs = SouthboundInterface::NowUs();
+  m_stepEndEventCount = Simulator::GetEventCount();
+  m_lastStepLatency = StepLatency();
+  if (m_stepLatencyTrace.is_open())
+  {
+    m_stepLatencyTrace.close();
+  }
+  if (jsonConfigEnv.contains("step_latency_trace"))
+  {
+    //binary trace of the per step latency, one record of 10 uint64_t (the StepLatency fields in order) per step.
+    m_stepLatencyTrace.open(jsonConfigEnv["step_latency_trace"].get<std::string>(), std::ios::out | std::ios::binary | std::ios::trunc);
   }
 }
 
@@ -129,6 +405,10 @@ DataProcessor::DoDispose()
     uint64_t simTime = timeLapse - m_waitSysTimeMs;
     std::cout<<"ns3 Sim time :"<<  simTime << " milliseconds. (" << simTime*100/timeLapse <<"%)\n";
   }
+  if (m_stepLatencyTrace.is_open())
+  {
+    m_stepLatencyTrace.close();
+  }
   m_southbound->Dispose();
 }
 
@@ -141,21 +421,8 @@ DataProcessor::AppendMeasurement(Ptr<NetworkStats> measurement)
   }
   
   Time maxWaitTime = NanoSeconds(1);
-  //std::cout << measurement->GetJson() << std::endl;
-  //only keep the measurement in the subscribed list
-  json measurementJson = measurement->GetJson();
-  json subJson;
-  for(auto it = measurementJson.begin(); it != measurementJson.end(); ++it)
-  {
-      auto sourceAndName = (*it)["source"].get<std::string>() + "::"+ (*it)["name"].get<std::string>();
-      //std::cout<< sourceAndName << std::endl;
-      if (std::find(m_subscribedMeasurement.begin(), m_subscribedMeasurement.end(),sourceAndName)!=m_subscribedMeasurement.end())
-      {
-        //std::cout << " FIND IT !" << std::endl;
-        subJson.push_back(*it);
-      }
-  }
-  m_measurementBatch.push_back(subJson);
+  //the measurement is converted to json at send time. the unsubscribed measurements are skipped by the aggregator.
+  m_networkStatsBatch.push_back(measurement);
 
   //TODO: for multi-agent case, we should not use the delayed schedule event. we send the measurement right away.
   if (m_exchangeMeasurementAndActionEvent.IsExpired())
@@ -172,108 +439,31 @@ DataProcessor::ExchangeMeasurementAndAction()
     return;
   }
 
-  if (m_measurementBatch.size() == 0)
+  if (m_networkStatsBatch.size() == 0 && m_measurementBatch.size() == 0)
   {
     return;
   }
 
+  StepLatency latency;
+  uint64_t mergeStartUs = SouthboundInterface::NowUs();
+  uint64_t eventCount = Simulator::GetEventCount();
+  latency.m_step = m_measurementCounter;
+  latency.m_simTimeUs = Now().GetMicroSeconds();
+  latency.m_eventLoopUs = mergeStartUs - m_stepEndUs;
+  latency.m_eventCount = eventCount - m_stepEndEventCount;
+
   AddMoreMeasurement();
-  json networkStats = m_measurementBatch.at(0); //networkStats is the json based measurement
-  std::vector<std::string> nameList; //namelist stores the source::name list of the measurement
-  for(auto it = networkStats.begin(); it != networkStats.end(); ++it)
+  //merge the measurements with the same source and name, the id and value lists are sorted by id.
+  for (uint32_t ind = 0; ind < m_networkStatsBatch.size(); ind++)
   {
-    auto sourceAndName = (*it)["source"].get<std::string>() + "::"+ (*it)["name"].get<std::string>();
-    if (nameList.empty())
-    {
-      nameList.push_back(sourceAndName);
-    }
-    else
-    {
-      if (find(nameList.begin(), nameList.end(), sourceAndName) == nameList.end())
-      {
-        nameList.push_back(sourceAndName);
-      }
-    }
+    m_aggregator.Add(m_networkStatsBatch.at(ind), m_subscription);
   }
-
-  //build nested json
-  for (uint32_t ind = 1; ind < m_measurementBatch.size(); ind++)
+  for (uint32_t ind = 0; ind < m_measurementBatch.size(); ind++)
   {
-    //loop over all measurement in this batch.
-    //std::cout << networkStats << std::endl;
-    //std::cout << nameList.size() << std::endl;
-
-    for(auto j = m_measurementBatch.at(ind).begin(); j != m_measurementBatch.at(ind).end(); ++j)
-    {
-      //for each measurement entry, it may contain multiple metrics, loop them all.
-      auto it = networkStats.begin();
-      while(it != networkStats.end())
-      {
-        //for each network stats, loop all metrics
-        //for measurement from different group...
-        //we need to append measurement at the outer loop...
-        //std::cout << "out : "<< (*j) << std::endl;
-        //auto sourceAndName = (*it)["source"].get<std::string>() + "::"+ (*it)["name"].get<std::string>();
-        //std::cout << "in : "<< (*it) << std::endl;
-
-        if ( (*it)["source"] == (*j)["source"] && (*it)["name"] == (*j)["name"])
-        {
-          //same source and name --> same measurement... append to the id and value list
-          if ((*it)["ts"] != (*j)["ts"])
-          {
-            NS_FATAL_ERROR("the timestamp of two measurements are different!");
-          }
-
-          //save the the list in a sorted order.
-          uint32_t index = 0;
-          while (index <= (*it)["id"].size())
-          {
-            //the new element is greater than all existing element, push it into the back.
-            if (index == (*it)["id"].size())
-            {
-              (*it)["id"].push_back((*j)["id"].at(0));
-              (*it)["value"].push_back((*j)["value"].at(0));
-              break;
-            }
-
-            //put value in a sorted way...
-            if ((*it)["id"].at(index) > (*j)["id"].at(0))
-            {
-              (*it)["id"].insert((*it)["id"].begin()+index, (*j)["id"].at(0));
-              (*it)["value"].insert((*it)["value"].begin()+index, (*j)["value"].at(0));
-              break;
-            }
-            index++;
-          }
-
-          break;
-        }
-        else
-        {
-          //check if we need to append to network stats.
-          auto sourceAndNameTemp = (*j)["source"].get<std::string>() + "::"+ (*j)["name"].get<std::string>();
-          if (nameList.empty())
-          {
-            nameList.push_back(sourceAndNameTemp);
-            networkStats.push_back((*j));
-            break;
-          }
-          else
-          {
-            if (find(nameList.begin(), nameList.end(), sourceAndNameTemp) == nameList.end())
-            {
-              nameList.push_back(sourceAndNameTemp);
-              networkStats.push_back(*j);
-              break;
-
-            }
-          }
-        }
-        it++;
-      }
-    }
-
+    m_aggregator.Add(m_measurementBatch.at(ind));
   }
+  json networkStats = m_aggregator.Flush(); //networkStats is the json based measurement
+  latency.m_mergeUs = SouthboundInterface::NowUs() - mergeStartUs;
   m_measurementSentTsMs = Now().GetMilliSeconds();
   std::cout << Now().GetSeconds() << " NetworkGym Southbound Send Measurement"<< std::endl;
   //std::cout << networkStats << std::endl;
@@ -299,107 +489,177 @@ DataProcessor::ExchangeMeasurementAndAction()
   json workloadStats;
   workloadStats["time_lapse"].push_back(element);
 
+  if (m_measurementCounter > 0)
+  {
+    //the latency of the previous step, the serialize and send time of this report is not known yet.
+    json stepLatency;
+    stepLatency["step"] = m_lastStepLatency.m_step;
+    stepLatency["event_loop_us"] = m_lastStepLatency.m_eventLoopUs;
+    stepLatency["merge_us"] = m_lastStepLatency.m_mergeUs;
+    stepLatency["serialize_us"] = m_lastStepLatency.m_serializeUs;
+    stepLatency["send_us"] = m_lastStepLatency.m_sendUs;
+    stepLatency["wait_us"] = m_lastStepLatency.m_waitUs;
+    stepLatency["parse_us"] = m_lastStepLatency.m_parseUs;
+    stepLatency["dispatch_us"] = m_lastStepLatency.m_dispatchUs;
+    stepLatency["events"] = m_lastStepLatency.m_eventCount;
+    workloadStats["step_latency"].push_back(stepLatency);
+  }
+
   m_southbound->SendMeasurementJson(networkStats, workloadStats);
+  latency.m_serializeUs = m_southbound->GetSerializeUs();
+  latency.m_sendUs = m_southbound->GetSendUs();
+  m_networkStatsBatch.clear();
   m_measurementBatch.clear();
+  m_measurementCounter += 1;
 
-  if (m_waitCounter+1 >= m_totalSteps)
+  if (m_measurementCounter >= m_totalSteps)
   {
-    //the first step is the reset function which does not need an action. therefore we +1.
+    //the first step is the reset function which does not need an action, therefore we stop after m_totalSteps measurements.
+    //in pipelined mode, the actions of the last m_actionLagSteps measurements are not applied.
     m_measurementStarted = false; //simulated the max number of steps. stop sending measurement and receive actions.
+    FinishStepLatency(latency);
     return;
   }
 
+  if (m_actionLagSteps > 0)
+  {
+    //pipelined mode, the action of this measurement is applied m_actionLagSteps measurements later.
+    m_pendingActionTsMs.push_back(m_measurementSentTsMs);
+    if (m_pendingActionTsMs.size() <= m_actionLagSteps)
+    {
+      //continue the simulation to the next measurement while the agent computes the action.
+      FinishStepLatency(latency);
+      return;
+    }
+  }
+
   //std::cout << m_waitCounter << " total: " << m_totalSteps << std::endl;
   uint64_t beforePollMs = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
 
   json action;
-  m_southbound->GetAction(action, true);
+  //in pipelined mode, the agent may have answered several measurements already. Read one action per step in the order
+  //of the measurements, such that each action is checked against its own measurement ts.
+  m_southbound->GetAction(action, true, m_actionLagSteps == 0);
   GetNoneAiAction(action);
   uint64_t afterPollMs = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
   //compute the time ns3 waits for action.
   m_waitSysTimeMs += afterPollMs - beforePollMs;
   m_waitCounter += 1;
+  latency.m_waitUs = m_southbound->GetWaitUs();
+  latency.m_parseUs = m_southbound->GetParseUs();
+
+  uint64_t dispatchStartUs = SouthboundInterface::NowUs();
+  ApplyAction(action);
+  latency.m_dispatchUs = SouthboundInterface::NowUs() - dispatchStartUs;
+  FinishStepLatency(latency);
+}
+
+void
+DataProcessor::FinishStepLatency (StepLatency& latency)
+{
+  m_stepEndUs = SouthboundInterface::NowUs();
+  m_stepEndEventCount = Simulator::GetEventCount();
+  m_lastStepLatency = latency;
+  if (m_stepLatencyTrace.is_open())
+  {
+    m_stepLatencyTrace.write(reinterpret_cast<const char*>(&latency), sizeof(StepLatency));
+  }
+}
+
+void
+DataProcessor::ApplyAction(json& action)
+{
+  double expectedTsMs = m_measurementSentTsMs;
+  if (m_actionLagSteps > 0)
+  {
+    //pipelined mode, the action is computed from the measurement sent m_actionLagSteps steps ago.
+    expectedTsMs = m_pendingActionTsMs.front();
+    m_pendingActionTsMs.pop_front();
+  }
 
   //send the action to subscribed module.
   std::cout << action["action_list"] << " is_array:" << action["action_list"].is_array()<< std::endl;
   //send action to the connected callback. The key is the measurement <source::name, id>.
-  if(action["action_list"].is_array())
+  const json& actionList = action["action_list"];
+  if(actionList.is_array())
   {
-    for (uint32_t i = 0; i < action["action_list"].size(); i++)
+    for (auto it = actionList.begin(); it != actionList.end(); ++it)
     {
-      auto action_name = action["action_list"][i]["source"].get<std::string>() +"::"+ action["action_list"][i]["name"].get<std::string>();
-      
-      if (action["action_list"][i]["value"].is_array())
-      {
-        for (uint32_t it = 0; it < action["action_list"][i]["id"].size(); it++)
-        {
-          auto key = std::make_pair(action_name, action["action_list"][i]["id"][it]);
-          //std::cout << action["action_list"][i]["value"] << std::endl;
-          if(m_networkgymActionCallbackMap.find(key) == m_networkgymActionCallbackMap.end())
-          {
-            NS_FATAL_ERROR("callback does not exits for the action_name: "<< key.first << " and id:" << key.second);
-          }
-          if (m_measurementSentTsMs != action["action_list"][i]["ts"])
-          {
-            NS_FATAL_ERROR("the action ts:"<< action["action_list"][i]["ts"] <<" does not equal the measurement ts:" << m_measurementSentTsMs);
-          }
-          m_networkgymActionCallbackMap[key](action["action_list"][i]["value"][it]);
-        }
-      }
-      else
-      {
-        if (m_measurementSentTsMs != action["action_list"][i]["ts"])
-        {
-          NS_FATAL_ERROR("the action ts:"<< action["action_list"][i]["ts"] <<" does not equal the measurement ts:" << m_measurementSentTsMs);
-        }
-        auto key = std::make_pair(action_name, action["action_list"][i]["id"]);
-        m_networkgymActionCallbackMap[key](action["action_list"][i]["value"]);
-      }
-
+      ApplyActionElement(*it, expectedTsMs);
     }
   }
   else
   {
     //not an array. This is one action list.
-    auto action_name = action["action_list"]["source"].get<std::string>() +"::"+action["action_list"]["name"].get<std::string>();
-    if (action["action_list"]["value"].is_array())
-    {
-      for (uint32_t it = 0; it < action["action_list"]["id"].size(); it++)
-      {
-        if (m_measurementSentTsMs != action["action_list"]["ts"])
-        {
-          NS_FATAL_ERROR("the action ts:"<< action["action_list"]["ts"] <<" does not equal the measurement ts:" << m_measurementSentTsMs);
-        }
-        auto key = std::make_pair(action_name, action["action_list"]["id"][it]);
-        if(m_networkgymActionCallbackMap.find(key) == m_networkgymActionCallbackMap.end())
-        {
-          NS_FATAL_ERROR("callback does not exits for the action_name: "<< key.first << " and id:" << key.second);
-        }
-        m_networkgymActionCallbackMap[key](action["action_list"]["value"][it]);
-      }
-    }
-    else
+    ApplyActionElement(actionList, expectedTsMs);
+  }
+}
+
+void
+DataProcessor::ApplyActionElement(const json& element, double expectedTsMs)
+{
+  if (expectedTsMs != element["ts"])
+  {
+    NS_FATAL_ERROR("the action ts:"<< element["ts"] <<" does not equal the measurement ts:" << expectedTsMs << " (action lag: " << m_actionLagSteps << " steps)");
+  }
+
+  m_actionKeyBuffer.assign(element["source"].get_ref<const std::string&>());
+  m_actionKeyBuffer.append("::");
+  m_actionKeyBuffer.append(element["name"].get_ref<const std::string&>());
+  auto iter = m_actionNameToIndexMap.find(m_actionKeyBuffer);
+  if (iter == m_actionNameToIndexMap.end())
+  {
+    NS_FATAL_ERROR("callback does not exits for the action_name: "<< m_actionKeyBuffer);
+  }
+  std::vector<NetworkGymActionCallback>& callbackList = m_actionCallbackTable[iter->second];
+
+  //the value is either a list with one value per id, or a single value for a single id.
+  const json& idList = element["id"];
+  const json& valueList = element["value"];
+  bool isList = valueList.is_array();
+  uint32_t size = isList ? idList.size() : 1;
+  for (uint32_t ind = 0; ind < size; ind++)
+  {
+    uint64_t id = isList ? idList[ind].get<uint64_t>() : idList.get<uint64_t>();
+    if (id >= callbackList.size() || callbackList[id].IsNull())
     {
-      if (m_measurementSentTsMs != action["action_list"]["ts"])
-      {
-        NS_FATAL_ERROR("the action ts:"<< action["action_list"]["ts"] <<" does not equal the measurement ts:" << m_measurementSentTsMs);
-      }
-      auto key = std::make_pair(action_name, action["action_list"]["id"]);
-      m_networkgymActionCallbackMap[key](action["action_list"]["value"]);
+      NS_FATAL_ERROR("callback does not exits for the action_name: "<< m_actionKeyBuffer << " and id:" << id);
     }
-
+    callbackList[id](isList ? valueList[ind] : valueList);
   }
 }
 
+Ptr<NetworkStats>
+DataProcessor::CreateNetworkStats (std::string source, uint64_t id, uint64_t ts)
+{
+  return CreateObject<NetworkStats>(source, id, ts, m_subscription);
+}
+
+bool
+DataProcessor::IsSubscribed (const std::string& source, const std::string& name)
+{
+  return m_subscription->IsSubscribed(source, name);
+}
+
 void
 DataProcessor::SetNetworkGymActionCallback(std::string name, uint64_t id, NetworkGymActionCallback cb)
 {
-  auto key = std::make_pair(name, id);
-  if(m_networkgymActionCallbackMap.find(key) != m_networkgymActionCallbackMap.end())
+  auto iter = m_actionNameToIndexMap.find(name);
+  if (iter == m_actionNameToIndexMap.end())
+  {
+    iter = m_actionNameToIndexMap.emplace(name, m_actionCallbackTable.size()).first;
+    m_actionCallbackTable.emplace_back();
+  }
+  std::vector<NetworkGymActionCallback>& callbackList = m_actionCallbackTable[iter->second];
+  if (id >= callbackList.size())
+  {
+    callbackList.resize(id + 1);
+  }
+  if (!callbackList[id].IsNull())
   {
     NS_FATAL_ERROR("The callback with the same name and id already exists!");
   }
-  m_networkgymActionCallbackMap[key] = cb;
+  callbackList[id] = cb;
 }
 
 void
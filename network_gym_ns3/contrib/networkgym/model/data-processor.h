@@ -10,24 +10,106 @@
 #include "ns3/core-module.h"
 #include "json.hpp"
 #include "ns3/southbound-interface.h"
+#include <unordered_map>
+#include <unordered_set>
+#include <deque>
+#include <fstream>
 using json = nlohmann::json;
 namespace ns3 {
+
+//the subscribed "source::name" list compiled into hash sets. It is built once and shared by the
+//DataProcessor and the NetworkStats it creates, so unsubscribed metrics are dropped before any json is built.
+class MeasurementSubscription : public SimpleRefCount<MeasurementSubscription>
+{
+public:
+  void Add (const std::string& sourceAndName); //add a subscribed measurement in the "source::name" format.
+  bool IsSubscribed (const std::string& source, const std::string& name) const;
+  const std::unordered_set<std::string>* GetNameSet (const std::string& source) const; //return nullptr if no measurement is subscribed for this source.
+private:
+  std::unordered_map<std::string, std::unordered_set<std::string> > m_sourceToNameSet; //the key is the source, the value is the subscribed names.
+};
+
+//the measurements of one source, id and ts. The measurements are stored in a flat list of interned
+//metric names and values, the json is only built when the measurement is sent.
 class NetworkStats : public Object
 {
 public:
   NetworkStats (std::string source, uint64_t id, uint64_t ts);
+  NetworkStats (std::string source, uint64_t id, uint64_t ts, Ptr<MeasurementSubscription> subscription);//only subscribed measurements are appended.
   virtual ~NetworkStats ();
 
+  static uint32_t InternName (const std::string& name); //return the metric id of the name, the same name always maps to the same id.
+  static const std::string& GetInternedName (uint32_t nameId);
+
+  bool IsSubscribed(const std::string& name);//return true if no subscription is configured.
   void Append(std::string name, double value);//append a double measurement.
   void Append(std::string name, json& value);//append a json measurement.
   void Append(std::string name, std::string indexName, std::vector<int> indexList, std::vector<double> list);//append a list of double measurement
 
-  json GetJson();
+  json GetJson(); //build the json based measurement.
+  const std::string& GetSource ();
+  uint64_t GetId ();
+  uint64_t GetTs ();
+  uint32_t GetSize (); //number of appended measurements.
+  uint32_t GetNameId (uint32_t index);
+  json GetValue (uint32_t index);
 private:
+  struct Record
+  {
+    uint32_t m_nameId;
+    int32_t m_jsonIndex; //index in m_jsonValueList, -1 for a double measurement.
+    double m_value;
+  };
+  void AppendRecord (const std::string& name, double value, int32_t jsonIndex);
+  static std::deque<std::string>& GetInternedNameList ();
+
   std::string m_source;
   uint64_t m_id;
   uint64_t m_ts;
-  json m_data;
+  std::vector<Record> m_recordList;
+  std::vector<json> m_jsonValueList; //values that are not a double, e.g., a per slice list.
+  Ptr<MeasurementSubscription> m_subscription;
+  const std::unordered_set<std::string>* m_subscribedNames = nullptr; //subscribed names of m_source, resolved once at construction.
+};
+
+//merge the measurements reported in the same step. Measurements with the same source and name are
+//merged into one entry, the (id, value) pairs are collected in flat lists and sorted by id once at flush time.
+class MeasurementAggregator
+{
+public:
+  void Add (const json& measurementList); //add a list of json based measurements.
+  void Add (Ptr<NetworkStats> measurement, Ptr<MeasurementSubscription> subscription); //add the measurements of a NetworkStats, skip unsubscribed ones if subscription is set.
+  json Flush (); //return the merged measurements and clear the aggregator.
+  bool IsEmpty ();
+private:
+  struct Entry
+  {
+    std::string m_source;
+    std::string m_name;
+    json m_ts;
+    std::vector<uint64_t> m_idList;
+    std::vector<json> m_valueList;
+    uint32_t m_mergeCounter = 0; //number of measurements merged into this entry.
+  };
+  std::unordered_map<std::string, uint32_t> m_keyToIndexMap; //the key is "source::name", the value is the index in m_entryList.
+  Entry& GetEntry (const std::string& source, const std::string& name, const json& ts);
+  std::vector<Entry> m_entryList; //stored in the order of first arrival.
+  std::string m_keyBuffer;
+};
+
+//per step latency breakdown in microseconds, measured with a monotonic clock.
+struct StepLatency
+{
+  uint64_t m_step = 0; //index of the measurement.
+  uint64_t m_simTimeUs = 0; //simulation time of the measurement.
+  uint64_t m_eventLoopUs = 0; //time spent in the ns-3 event loop since the previous step.
+  uint64_t m_mergeUs = 0; //time spent merging the measurements.
+  uint64_t m_serializeUs = 0; //time spent serializing the measurement report.
+  uint64_t m_sendUs = 0; //time spent in zmq send.
+  uint64_t m_waitUs = 0; //time spent waiting for the action, 0 if no action is received in this step.
+  uint64_t m_parseUs = 0; //time spent receiving and parsing the action.
+  uint64_t m_dispatchUs = 0; //time spent applying the action to the callbacks.
+  uint64_t m_eventCount = 0; //number of ns-3 events executed since the previous step.
 };
 
 class DataProcessor : public Object
@@ -40,31 +122,50 @@ public:
   virtual ~DataProcessor ();
   virtual void DoDispose ();
   static TypeId GetTypeId (void);
+  void LoadEnvConfig (); //(re)load the env-configure.json in the current folder, e.g., when an episode is forked from a warm start snapshot.
   void StartMeasurement ();
   bool IsMeasurementStarted ();
   void AppendMeasurement(Ptr<NetworkStats> measurement);//the measurements appended from multiple sources at the same time will be aggregated and sent after 1 nanosecond.
   typedef Callback<void, const json& > NetworkGymActionCallback;
+  Ptr<NetworkStats> CreateNetworkStats (std::string source, uint64_t id, uint64_t ts); //create a NetworkStats that skips unsubscribed measurements.
+  bool IsSubscribed (const std::string& source, const std::string& name);
   void SetNetworkGymActionCallback(std::string name, uint64_t id, NetworkGymActionCallback cb);
   void SetMaxPollTime (int timeMs);
 protected:
   Ptr<SouthboundInterface> m_southbound;
   bool m_measurementStarted = false;
-  std::vector<json> m_measurementBatch;
-  std::vector<std::string> m_subscribedMeasurement; //store the measurement list.
+  std::vector<json> m_measurementBatch; //json based measurements, e.g., added by AddMoreMeasurement.
+  std::vector<Ptr<NetworkStats> > m_networkStatsBatch; //measurements appended in this step, converted to json at send time.
+  Ptr<MeasurementSubscription> m_subscription; //store the subscribed measurement list.
 
 private:
   void ExchangeMeasurementAndAction(); //send measurement and get action.
+  void ApplyAction(json& action); //check the action ts and send the action to the connected callbacks.
+  void ApplyActionElement(const json& element, double expectedTsMs); //apply one {source, name, ts, id, value} element of the action list.
   virtual void AddMoreMeasurement();
   virtual void GetNoneAiAction(json& action);
   EventId m_exchangeMeasurementAndActionEvent;
-  std::map< std::pair< std::string, uint64_t>, NetworkGymActionCallback> m_networkgymActionCallbackMap; //callback that send action to the connected modules. Multiple modules may connects to it. key is the action name
+  MeasurementAggregator m_aggregator;
+  //callback that send action to the connected modules. Multiple modules may connects to it.
+  std::unordered_map<std::string, uint32_t> m_actionNameToIndexMap; //the key is the action name "source::name", the value is the index in m_actionCallbackTable.
+  std::vector<std::vector<NetworkGymActionCallback> > m_actionCallbackTable; //the callbacks of an action, indexed by id.
+  std::string m_actionKeyBuffer;
 
   uint64_t m_waitCounter;
   uint64_t m_startSysTimeMs;
   uint64_t m_waitSysTimeMs;
 
   uint64_t m_totalSteps;
+  uint64_t m_measurementCounter = 0; //number of measurements sent.
   double m_measurementSentTsMs;
+  uint32_t m_actionLagSteps = 0; //0 waits for the action after each measurement. n > 0 enables pipelined mode, the action is applied n steps later.
+  std::deque<double> m_pendingActionTsMs; //in pipelined mode, the ts of measurements waiting for actions.
+
+  void FinishStepLatency (StepLatency& latency); //store the latency of a finished step and write it to the trace file.
+  uint64_t m_stepEndUs = 0; //end of the previous step, the event loop of the next step starts here.
+  uint64_t m_stepEndEventCount = 0;
+  StepLatency m_lastStepLatency; //reported in the workload_stats of the next measurement.
+  std::ofstream m_stepLatencyTrace; //optional binary trace, one StepLatency (10 x uint64_t) per step.
 };
 
 }
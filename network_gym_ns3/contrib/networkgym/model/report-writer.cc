@@ -0,0 +1,130 @@
+/* Copyright(C) 2024 Intel Corporation
+*  SPDX-License-Identifier: GPL-2.0
+*  https://spdx.org/licenses/GPL-2.0.html
+*/
+
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+
+#include "report-writer.h"
+#include "ns3/simulator.h"
+#include "ns3/fatal-impl.h"
+#include "ns3/fatal-error.h"
+#include <fcntl.h>
+#include <unistd.h>
+#include <cerrno>
+
+namespace ns3 {
+
+bool ReportWriter::m_closeScheduled = false;
+
+ReportWriter::FileBuffer::FileBuffer (const std::string& fileName)
+  : m_buffer (BUFFER_SIZE)
+{
+  m_fd = open(fileName.c_str(), O_WRONLY | O_CREAT | O_APPEND, 0644);
+  if (m_fd < 0)
+  {
+    NS_FATAL_ERROR("cannot open the report file " << fileName);
+  }
+  setp(m_buffer.data(), m_buffer.data() + m_buffer.size());
+}
+
+ReportWriter::FileBuffer::~FileBuffer ()
+{
+  WriteOut();
+  close(m_fd);
+}
+
+ReportWriter::FileBuffer::int_type
+ReportWriter::FileBuffer::overflow (int_type c)
+{
+  WriteOut();
+  if (!traits_type::eq_int_type(c, traits_type::eof()))
+  {
+    *pptr() = traits_type::to_char_type(c);
+    pbump(1);
+  }
+  return traits_type::not_eof(c);
+}
+
+int
+ReportWriter::FileBuffer::sync ()
+{
+  WriteOut();
+  return 0;
+}
+
+void
+ReportWriter::FileBuffer::WriteOut ()
+{
+  const char* data = pbase();
+  size_t size = pptr() - pbase();
+  while (size > 0)
+  {
+    ssize_t written = write(m_fd, data, size);
+    if (written < 0)
+    {
+      if (errno == EINTR)
+      {
+        continue;
+      }
+      break; //report files are best effort, drop the rows if the disk is full.
+    }
+    data += written;
+    size -= written;
+  }
+  setp(m_buffer.data(), m_buffer.data() + m_buffer.size());
+}
+
+ReportWriter::ReportFile::ReportFile (const std::string& fileName)
+  : m_buffer (fileName),
+    m_stream (&m_buffer)
+{
+}
+
+std::unordered_map<std::string, std::unique_ptr<ReportWriter::ReportFile> >&
+ReportWriter::GetFileMap ()
+{
+  static std::unordered_map<std::string, std::unique_ptr<ReportFile> > fileMap;
+  return fileMap;
+}
+
+std::ostream&
+ReportWriter::GetStream (const std::string& fileName)
+{
+  auto& fileMap = GetFileMap();
+  auto iter = fileMap.find(fileName);
+  if (iter == fileMap.end())
+  {
+    iter = fileMap.emplace(fileName, std::unique_ptr<ReportFile>(new ReportFile(fileName))).first;
+    //the buffered rows are also written if the simulation ends with a fatal error.
+    FatalImpl::RegisterStream(&iter->second->m_stream);
+    if (!m_closeScheduled)
+    {
+      Simulator::ScheduleDestroy(&ReportWriter::CloseAll);
+      m_closeScheduled = true;
+    }
+  }
+  return iter->second->m_stream;
+}
+
+void
+ReportWriter::Flush ()
+{
+  for (auto& file : GetFileMap())
+  {
+    file.second->m_stream.flush();
+  }
+}
+
+void
+ReportWriter::CloseAll ()
+{
+  for (auto& file : GetFileMap())
+  {
+    FatalImpl::UnregisterStream(&file.second->m_stream);
+  }
+  GetFileMap().clear();
+  m_closeScheduled = false;
+}
+
+}
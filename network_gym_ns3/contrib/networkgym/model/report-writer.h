@@ -0,0 +1,58 @@
+/* Copyright(C) 2024 Intel Corporation
+*  SPDX-License-Identifier: GPL-2.0
+*  https://spdx.org/licenses/GPL-2.0.html
+*/
+
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+#ifndef REPORT_WRITER_H
+#define REPORT_WRITER_H
+
+#include <ostream>
+#include <streambuf>
+#include <string>
+#include <vector>
+#include <memory>
+#include <unordered_map>
+
+namespace ns3 {
+
+//shared sink for the text reports (csv and log files) written during the simulation. A file is opened
+//in append mode on first use and kept open, the rows are buffered in memory and written with one large
+//write when the buffer is full, when the stream is flushed (e.g., std::endl) or when the simulation ends.
+class ReportWriter
+{
+public:
+  static std::ostream& GetStream (const std::string& fileName); //do not keep the reference, it is invalid after CloseAll().
+  static void Flush (); //write the buffered rows of all files.
+  static void CloseAll (); //flush and close all files. Call it before fork(), so the child does not inherit the buffers and opens its own files.
+
+  static const uint32_t BUFFER_SIZE = 1 << 16; //bytes buffered per file.
+private:
+  class FileBuffer : public std::streambuf
+  {
+  public:
+    FileBuffer (const std::string& fileName);
+    virtual ~FileBuffer ();
+  protected:
+    virtual int_type overflow (int_type c);
+    virtual int sync ();
+  private:
+    void WriteOut ();
+    int m_fd;
+    std::vector<char> m_buffer;
+  };
+
+  struct ReportFile
+  {
+    ReportFile (const std::string& fileName);
+    FileBuffer m_buffer;
+    std::ostream m_stream;
+  };
+
+  static std::unordered_map<std::string, std::unique_ptr<ReportFile> >& GetFileMap ();
+  static bool m_closeScheduled; //CloseAll is scheduled at Simulator::Destroy.
+};
+
+}
+
+#endif /* REPORT_WRITER_H */
@@ -36,7 +36,7 @@ SouthboundInterface::GetTypeId (void)
 SouthboundInterface::SouthboundInterface ()
 {
   NS_LOG_FUNCTION (this);
-  Connect();
+  //connect at the first measurement, such that a warmed-up process can be forked before the zmq context is created.
 }
 
 SouthboundInterface::~SouthboundInterface ()
@@ -47,6 +47,10 @@ SouthboundInterface::~SouthboundInterface ()
 void
 SouthboundInterface::DoDispose (void)
 {
+  if (!m_connected)
+  {
+    return;
+  }
   zmq_close (m_zmq_socket);
   zmq_ctx_destroy (m_zmq_context);
   std::cout  << m_workerName << ": ns3 disconnected from NetworkGym." << std::endl;
@@ -56,6 +60,7 @@ SouthboundInterface::DoDispose (void)
 void
 SouthboundInterface::Connect()
 {
+  m_connected = true;
   std::ifstream jsonStream("gym-configure.json");
   json jsonConfig;
   jsonStream >> jsonConfig;
@@ -67,19 +72,110 @@ SouthboundInterface::Connect()
   std::string plain_username = jsonConfig["session_name"].get<std::string>();
   std::string plain_password = jsonConfig["session_key"].get<std::string>();
   int portN = jsonConfig["env_port"].get<int>();
-  std::cout << m_workerName << ": ns3 connecting to NetworkGym." << std::endl;
+  if (jsonConfig.contains("measurement_encoding"))
+  {
+    //binary encoding is opt-in, old configure files fall back to json.
+    m_measurementEncoding = ParseMeasurementEncoding(jsonConfig["measurement_encoding"].get<std::string>());
+  }
+  std::cout << m_workerName << ": ns3 connecting to NetworkGym. measurement_encoding = " << MeasurementEncodingToString(m_measurementEncoding) << std::endl;
   m_zmq_context = zmq_ctx_new ();
   m_zmq_socket = zmq_socket (m_zmq_context, ZMQ_DEALER);
-  zmq_setsockopt (m_zmq_socket, ZMQ_PLAIN_USERNAME, plain_username.c_str(), plain_username.size());
-  zmq_setsockopt (m_zmq_socket, ZMQ_PLAIN_PASSWORD, plain_password.c_str(), plain_password.size());
   zmq_setsockopt (m_zmq_socket, ZMQ_IDENTITY, m_workerName.c_str(), m_workerName.size());
   int64_t linger = 10000;
   zmq_setsockopt (m_zmq_socket, ZMQ_LINGER, &linger, sizeof linger);
+  if (jsonConfig.contains("env_endpoint"))
+  {
+    //connect to the local southbound multiplexer, many envs share its connection to the server.
+    //the multiplexer routes the msgs by the env identity, no authentication for the local endpoint.
+    std::string endpoint = jsonConfig["env_endpoint"].get<std::string>();
+    std::cout << m_workerName << ": ns3 connecting via multiplexer " << endpoint << std::endl;
+    zmq_connect (m_zmq_socket, endpoint.c_str());
+    return;
+  }
+  zmq_setsockopt (m_zmq_socket, ZMQ_PLAIN_USERNAME, plain_username.c_str(), plain_username.size());
+  zmq_setsockopt (m_zmq_socket, ZMQ_PLAIN_PASSWORD, plain_password.c_str(), plain_password.size());
   std::string addrAndPort = "tcp://localhost:"+std::to_string(portN);
   zmq_connect (m_zmq_socket, addrAndPort.c_str());
 
 }
 
+SouthboundInterface::MeasurementEncoding
+SouthboundInterface::ParseMeasurementEncoding (std::string encoding)
+{
+  if (encoding.compare("json") == 0)
+  {
+    return JSON_ENCODING;
+  }
+  else if (encoding.compare("msgpack") == 0)
+  {
+    return MSGPACK_ENCODING;
+  }
+  else if (encoding.compare("cbor") == 0)
+  {
+    return CBOR_ENCODING;
+  }
+  NS_FATAL_ERROR("unknown measurement_encoding: " << encoding << ", only support json, msgpack and cbor.");
+}
+
+std::string
+SouthboundInterface::MeasurementEncodingToString (MeasurementEncoding encoding)
+{
+  switch (encoding)
+  {
+    case MSGPACK_ENCODING:
+      return "msgpack";
+    case CBOR_ENCODING:
+      return "cbor";
+    default:
+      return "json";
+  }
+}
+
+void
+SouthboundInterface::EncodeMeasurementReport (const json& measurementReport, MeasurementEncoding encoding, std::string& output)
+{
+  output.clear();
+  switch (encoding)
+  {
+    case MSGPACK_ENCODING:
+      json::to_msgpack(measurementReport, output);
+      break;
+    case CBOR_ENCODING:
+      json::to_cbor(measurementReport, output);
+      break;
+    default:
+      output = measurementReport.dump();
+      break;
+  }
+}
+
+void
+SouthboundInterface::SendMeasurementReport (const json& measurementReport)
+{
+  if (!m_connected)
+  {
+    Connect();
+  }
+  uint64_t startUs = NowUs();
+  std::string j_str;
+  EncodeMeasurementReport(measurementReport, m_measurementEncoding, j_str);
+  uint64_t serializedUs = NowUs();
+  m_serializeUs = serializedUs - startUs;
+  zmq_send (m_zmq_socket, m_clientIdentity.c_str(), m_clientIdentity.size(), ZMQ_SNDMORE);
+  if (m_measurementEncoding != JSON_ENCODING)
+  {
+    //the server only reads json. The binary report is sent as an extra frame after a small json header,
+    //the header tells the server the msg type and tells the client how to decode the report.
+    json header;
+    header["type"] = "env-measurement";
+    header["encoding"] = MeasurementEncodingToString(m_measurementEncoding);
+    std::string header_str = header.dump();
+    zmq_send (m_zmq_socket, header_str.c_str(), header_str.size(), ZMQ_SNDMORE);
+  }
+  zmq_send (m_zmq_socket, j_str.c_str(), j_str.size(), 0);
+  m_sendUs = NowUs() - serializedUs;
+}
+
 void
 SouthboundInterface::SendMeasurementJson(json& networkStats, json& workloadStats)
 {
@@ -88,9 +184,7 @@ SouthboundInterface::SendMeasurementJson(json& networkStats, json& workloadStats
 
   measurementReport["network_stats"] = networkStats;
   measurementReport["workload_stats"] = workloadStats;
-  std::string j_str =measurementReport.dump();
-  zmq_send (m_zmq_socket, m_clientIdentity.c_str(), m_clientIdentity.size(), ZMQ_SNDMORE);
-  zmq_send (m_zmq_socket, j_str.c_str(), j_str.size(), 0);
+  SendMeasurementReport(measurementReport);
 }
 
 void
@@ -100,21 +194,26 @@ SouthboundInterface::SendMeasurementJson(json& networkStats)
   measurementReport["type"] = "env-measurement";
 
   measurementReport["network_stats"] = networkStats;
-  std::string j_str =measurementReport.dump();
-  zmq_send (m_zmq_socket, m_clientIdentity.c_str(), m_clientIdentity.size(), ZMQ_SNDMORE);
-  zmq_send (m_zmq_socket, j_str.c_str(), j_str.size(), 0);
+  SendMeasurementReport(measurementReport);
 }
 
 void
-SouthboundInterface::GetAction(json& action, bool raiseError)
+SouthboundInterface::GetAction(json& action, bool raiseError, bool latestOnly)
 {
+  if (!m_connected)
+  {
+    Connect();
+  }
 
   /* Poll for events for m_maxActionWaitTime */
+  uint64_t startUs = NowUs();
   zmq_pollitem_t items [] = {
       { m_zmq_socket,   0, ZMQ_POLLIN, 0 },
   };
   //pull timeout = m_maxActionWaitTime, 0 measn return rightway, -1 means wait forever...
   int rc = zmq_poll (items, 1, m_maxActionWaitTime);
+  uint64_t polledUs = NowUs();
+  m_waitUs = polledUs - startUs;
 
   if (rc == 0 && raiseError)
   {
@@ -123,43 +222,48 @@ SouthboundInterface::GetAction(json& action, bool raiseError)
   }
 
   assert (rc >= 0); /* Returned events will be stored in items[].revents */
-  json j_msg;
-  while(rc > 0)//while there is a msg in the socket, we get the last one!
+  zmq_msg_t actionMsg;
+  bool actionReceived = false;
+  while(rc > 0)//while there is a msg in the socket, we get the last one! In pipelined mode (latestOnly = false), we get the first one.
   {
     //the server sends two msgs: (1) algorithm client indentiy and followed by the (2) msg.
 
     //(1) RX identity
-    char identity [1024];
-    int size = zmq_recv (m_zmq_socket, identity, 1023, 0);
-    if (size == -1 || size > 1023)
+    zmq_msg_t identityMsg;
+    zmq_msg_init (&identityMsg);
+    int size = zmq_msg_recv (&identityMsg, m_zmq_socket, 0);
+    if (size == -1)
     {
       NS_FATAL_ERROR("Receive ERROR");
     }
-    identity [size] = '\0';
-    if (m_clientIdentity != identity)
+    const char* identity = static_cast<const char*> (zmq_msg_data (&identityMsg));
+    if (m_clientIdentity.size() != (size_t)size || m_clientIdentity.compare(0, size, identity, size) != 0)
     {
-      NS_FATAL_ERROR("client identity changed! from " << m_clientIdentity << " to " << identity);
+      NS_FATAL_ERROR("client identity changed! from " << m_clientIdentity << " to " << std::string(identity, size));
     }
+    zmq_msg_close (&identityMsg);
     //std::cout << "Received Identity: "<< m_clientIdentity << std::endl;
 
-    //(2) RX action msg
-    char buffer [10001];
-    size = zmq_recv (m_zmq_socket, buffer, 10000, 0);
-    if (size == -1 || size > 10000)
+    //(2) RX action msg. The msg is not parsed here, only the last one in the socket is parsed after the loop,
+    //the older (stale) msgs are dropped without parsing.
+    if (actionReceived)
     {
-      NS_FATAL_ERROR("Receive ERROR");
+      zmq_msg_close (&actionMsg);
     }
-    buffer [size] = '\0';
-    //std::cout << "Received: "<< buffer << std::endl;
-
-    action = json::parse(buffer);
-    if(action["type"].get<std::string>().compare("env-action") != 0 )
+    zmq_msg_init (&actionMsg);
+    size = zmq_msg_recv (&actionMsg, m_zmq_socket, 0);
+    if (size == -1)
     {
-      NS_FATAL_ERROR("Unkown MSG, the client should only receive env-action, but received :" << action["type"].get<std::string>());
+      NS_FATAL_ERROR("Receive ERROR");
     }
+    actionReceived = true;
 
-    //this is the action we are expecting...
     std::cout << Now().GetSeconds() << " NetworkGym Southbound RX [env-action]" << std::endl;
+    if (!latestOnly)
+    {
+      //each queued action belongs to its own measurement, keep the rest for the next steps.
+      break;
+    }
     zmq_pollitem_t items [] = {
           { m_zmq_socket,   0, ZMQ_POLLIN, 0 },
       };
@@ -167,7 +271,52 @@ SouthboundInterface::GetAction(json& action, bool raiseError)
     assert (rc >= 0); /* Returned events will be stored in items[].revents */
   }
 
+  if (actionReceived)
+  {
+    //parse the action straight from the zmq msg buffer, no size limit and no copy.
+    const char* buffer = static_cast<const char*> (zmq_msg_data (&actionMsg));
+    action = json::parse(buffer, buffer + zmq_msg_size (&actionMsg));
+    zmq_msg_close (&actionMsg);
+    //std::cout << "Received: "<< action << std::endl;
+
+    if(action["type"].get<std::string>().compare("env-action") != 0 )
+    {
+      NS_FATAL_ERROR("Unkown MSG, the client should only receive env-action, but received :" << action["type"].get<std::string>());
+    }
+  }
+  m_parseUs = NowUs() - polledUs;
+
+}
+
+
+uint64_t
+SouthboundInterface::NowUs ()
+{
+  return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
 }
 
+uint64_t
+SouthboundInterface::GetSerializeUs ()
+{
+  return m_serializeUs;
+}
+
+uint64_t
+SouthboundInterface::GetSendUs ()
+{
+  return m_sendUs;
+}
+
+uint64_t
+SouthboundInterface::GetWaitUs ()
+{
+  return m_waitUs;
+}
+
+uint64_t
+SouthboundInterface::GetParseUs ()
+{
+  return m_parseUs;
+}
 
 }
@@ -25,14 +25,44 @@ public:
   virtual void DoDispose (void);
 
   static TypeId GetTypeId (void);
+
+  enum MeasurementEncoding
+  {
+    JSON_ENCODING = 0,    // text json, the default format.
+    MSGPACK_ENCODING = 1, // binary MessagePack.
+    CBOR_ENCODING = 2,    // binary CBOR.
+  };
+
+  //convert the "measurement_encoding" string in gym-configure.json to MeasurementEncoding.
+  static MeasurementEncoding ParseMeasurementEncoding (std::string encoding);
+  static std::string MeasurementEncodingToString (MeasurementEncoding encoding);
+  //serialize a measurement report in the given encoding. The binary encodings are stored as raw bytes in the string.
+  static void EncodeMeasurementReport (const json& measurementReport, MeasurementEncoding encoding, std::string& output);
+
   void SendMeasurementJson (json& networkStats, json& workloadStats); //network stats and workload stats measurement
   void SendMeasurementJson (json& networkStats); //network stats measurement
-  void GetAction (json& action, bool raiseError); //if raiseError = true, the program exits with error when the action is not received after poll timeout.
+  //if raiseError = true, the program exits with error when the action is not received after poll timeout.
+  //if latestOnly = true, the queued actions are drained and only the last one is returned. Otherwise only the
+  //oldest queued action is read, the others stay in the socket for the next calls (pipelined mode).
+  void GetAction (json& action, bool raiseError, bool latestOnly = true);
+
+  static uint64_t NowUs (); //monotonic clock in microseconds, used for the step latency measurement.
+  uint64_t GetSerializeUs (); //time spent serializing the last measurement report.
+  uint64_t GetSendUs (); //time spent in zmq send for the last measurement report.
+  uint64_t GetWaitUs (); //time spent waiting for the last action.
+  uint64_t GetParseUs (); //time spent receiving and parsing the last action.
 
 private:
   void Connect();
+  void SendMeasurementReport (const json& measurementReport);
   int m_maxActionWaitTime; //unit ms
+  MeasurementEncoding m_measurementEncoding = JSON_ENCODING;
+  uint64_t m_serializeUs = 0;
+  uint64_t m_sendUs = 0;
+  uint64_t m_waitUs = 0;
+  uint64_t m_parseUs = 0;
 
+  bool m_connected = false;
   void *m_zmq_context;
   void *m_zmq_socket;
   std::string m_workerName;
@@ -8,6 +8,15 @@
 // Include a header file from your module to test.
 // An essential include is test.h
 #include "ns3/test.h"
+#include "ns3/southbound-interface.h"
+#include "ns3/data-processor.h"
+#include "ns3/report-writer.h"
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <random>
+#include <unistd.h>
 
 // Do not put your test classes in namespace ns3.  You may find it useful
 // to use the using directive to access the ns3 namespace directly
@@ -61,6 +70,472 @@ NetworkgymTestCase1::DoRun()
     NS_TEST_ASSERT_MSG_EQ_TOL(0.01, 0.01, 0.001, "Numbers are not equal within tolerance");
 }
 
+/**
+ * \ingroup networkgym-tests
+ * A/B benchmark of the measurement report encodings. For 10, 100 and 1000 users it
+ * prints the bytes on the wire and the serialize time of json, msgpack and cbor,
+ * and checks the binary reports decode back to the same json.
+ */
+class NetworkgymMeasurementEncodingTestCase : public TestCase
+{
+  public:
+    NetworkgymMeasurementEncodingTestCase();
+    virtual ~NetworkgymMeasurementEncodingTestCase();
+
+  private:
+    void DoRun() override;
+    json CreateMeasurementReport(uint32_t numUsers);
+};
+
+NetworkgymMeasurementEncodingTestCase::NetworkgymMeasurementEncodingTestCase()
+    : TestCase("Networkgym measurement encoding size and serialize time")
+{
+}
+
+NetworkgymMeasurementEncodingTestCase::~NetworkgymMeasurementEncodingTestCase()
+{
+}
+
+json
+NetworkgymMeasurementEncodingTestCase::CreateMeasurementReport(uint32_t numUsers)
+{
+    // same layout as the report built by DataProcessor: one entry per source::name with per-user id and value lists.
+    std::vector<std::pair<std::string, std::string>> metrics = {{"gma", "dl::rate"},
+                                                                {"gma", "lte::dl::owd"},
+                                                                {"gma", "wifi::dl::owd"},
+                                                                {"gma", "lte::dl::traffic_ratio"},
+                                                                {"gma", "wifi::dl::traffic_ratio"},
+                                                                {"lte", "dl::max_rate"},
+                                                                {"lte", "cell_id"},
+                                                                {"wifi", "dl::max_rate"}};
+    json networkStats;
+    for (auto& metric : metrics)
+    {
+        json measurement;
+        measurement["source"] = metric.first;
+        measurement["name"] = metric.second;
+        measurement["ts"] = 1000;
+        for (uint32_t id = 1; id <= numUsers; id++)
+        {
+            measurement["id"].push_back(id);
+            measurement["value"].push_back(id * 0.37 + metric.second.size());
+        }
+        networkStats.push_back(measurement);
+    }
+
+    json element;
+    element["total_ms"] = 1000;
+    element["sim_ms"] = 800;
+    element["pause_ms"] = 200;
+    json workloadStats;
+    workloadStats["time_lapse"].push_back(element);
+
+    json measurementReport;
+    measurementReport["type"] = "env-measurement";
+    measurementReport["network_stats"] = networkStats;
+    measurementReport["workload_stats"] = workloadStats;
+    return measurementReport;
+}
+
+void
+NetworkgymMeasurementEncodingTestCase::DoRun()
+{
+    const uint32_t iterations = 20;
+    std::vector<SouthboundInterface::MeasurementEncoding> encodingList = {SouthboundInterface::JSON_ENCODING,
+                                                                          SouthboundInterface::MSGPACK_ENCODING,
+                                                                          SouthboundInterface::CBOR_ENCODING};
+    for (uint32_t numUsers : {10, 100, 1000})
+    {
+        json measurementReport = CreateMeasurementReport(numUsers);
+        size_t jsonBytes = 0;
+        for (auto encoding : encodingList)
+        {
+            std::string output;
+            auto start = std::chrono::steady_clock::now();
+            for (uint32_t i = 0; i < iterations; i++)
+            {
+                SouthboundInterface::EncodeMeasurementReport(measurementReport, encoding, output);
+            }
+            auto end = std::chrono::steady_clock::now();
+            double usPerReport = std::chrono::duration<double, std::micro>(end - start).count() / iterations;
+            std::cout << "users: " << numUsers << " encoding: " << SouthboundInterface::MeasurementEncodingToString(encoding)
+                      << " bytes: " << output.size() << " serialize_us: " << usPerReport << std::endl;
+
+            if (encoding == SouthboundInterface::JSON_ENCODING)
+            {
+                jsonBytes = output.size();
+                NS_TEST_ASSERT_MSG_EQ(json::parse(output), measurementReport, "json report does not decode to the same measurement");
+            }
+            else if (encoding == SouthboundInterface::MSGPACK_ENCODING)
+            {
+                NS_TEST_ASSERT_MSG_EQ(json::from_msgpack(output), measurementReport, "msgpack report does not decode to the same measurement");
+                NS_TEST_ASSERT_MSG_LT(output.size(), jsonBytes, "msgpack report should be smaller than the json report");
+            }
+            else
+            {
+                NS_TEST_ASSERT_MSG_EQ(json::from_cbor(output), measurementReport, "cbor report does not decode to the same measurement");
+                NS_TEST_ASSERT_MSG_LT(output.size(), jsonBytes, "cbor report should be smaller than the json report");
+            }
+        }
+    }
+}
+
+/**
+ * \ingroup networkgym-tests
+ * Regression test of the MeasurementAggregator. The merged measurements are compared with
+ * the output of the nested loop merge previously used by DataProcessor::ExchangeMeasurementAndAction.
+ */
+class NetworkgymMeasurementAggregatorTestCase : public TestCase
+{
+  public:
+    NetworkgymMeasurementAggregatorTestCase();
+    virtual ~NetworkgymMeasurementAggregatorTestCase();
+
+  private:
+    void DoRun() override;
+    json LegacyMerge(const std::vector<json>& measurementBatch);
+    json CreateMeasurement(std::string source, std::string name, uint64_t id, json value);
+};
+
+NetworkgymMeasurementAggregatorTestCase::NetworkgymMeasurementAggregatorTestCase()
+    : TestCase("Networkgym measurement aggregator matches the legacy merge")
+{
+}
+
+NetworkgymMeasurementAggregatorTestCase::~NetworkgymMeasurementAggregatorTestCase()
+{
+}
+
+json
+NetworkgymMeasurementAggregatorTestCase::LegacyMerge(const std::vector<json>& measurementBatch)
+{
+    // copy of the nested loop merge, each measurement in the batch carries a single id.
+    json networkStats = measurementBatch.at(0);
+    std::vector<std::string> nameList;
+    for (auto it = networkStats.begin(); it != networkStats.end(); ++it)
+    {
+        auto sourceAndName = (*it)["source"].get<std::string>() + "::" + (*it)["name"].get<std::string>();
+        if (find(nameList.begin(), nameList.end(), sourceAndName) == nameList.end())
+        {
+            nameList.push_back(sourceAndName);
+        }
+    }
+
+    for (uint32_t ind = 1; ind < measurementBatch.size(); ind++)
+    {
+        for (auto j = measurementBatch.at(ind).begin(); j != measurementBatch.at(ind).end(); ++j)
+        {
+            auto it = networkStats.begin();
+            while (it != networkStats.end())
+            {
+                if ((*it)["source"] == (*j)["source"] && (*it)["name"] == (*j)["name"])
+                {
+                    uint32_t index = 0;
+                    while (index <= (*it)["id"].size())
+                    {
+                        if (index == (*it)["id"].size())
+                        {
+                            (*it)["id"].push_back((*j)["id"].at(0));
+                            (*it)["value"].push_back((*j)["value"].at(0));
+                            break;
+                        }
+                        if ((*it)["id"].at(index) > (*j)["id"].at(0))
+                        {
+                            (*it)["id"].insert((*it)["id"].begin() + index, (*j)["id"].at(0));
+                            (*it)["value"].insert((*it)["value"].begin() + index, (*j)["value"].at(0));
+                            break;
+                        }
+                        index++;
+                    }
+                    break;
+                }
+                else
+                {
+                    auto sourceAndNameTemp = (*j)["source"].get<std::string>() + "::" + (*j)["name"].get<std::string>();
+                    if (find(nameList.begin(), nameList.end(), sourceAndNameTemp) == nameList.end())
+                    {
+                        nameList.push_back(sourceAndNameTemp);
+                        networkStats.push_back(*j);
+                        break;
+                    }
+                }
+                it++;
+            }
+        }
+    }
+    return networkStats;
+}
+
+json
+NetworkgymMeasurementAggregatorTestCase::CreateMeasurement(std::string source, std::string name, uint64_t id, json value)
+{
+    json measurement;
+    measurement["source"] = source;
+    measurement["name"] = name;
+    measurement["ts"] = 1000;
+    measurement["id"].push_back(id);
+    measurement["value"].push_back(value);
+    return measurement;
+}
+
+void
+NetworkgymMeasurementAggregatorTestCase::DoRun()
+{
+    std::mt19937 rng(1);
+    for (uint32_t numUsers : {1, 4, 50, 500})
+    {
+        // one batch entry per user and source, users report in a random order.
+        std::vector<uint64_t> userList;
+        for (uint64_t id = 0; id < numUsers; id++)
+        {
+            userList.push_back(id);
+        }
+        std::shuffle(userList.begin(), userList.end(), rng);
+
+        std::vector<json> measurementBatch;
+        for (auto id : userList)
+        {
+            json gmaStats;
+            gmaStats.push_back(CreateMeasurement("gma", "dl::rate", id, id * 1.5));
+            gmaStats.push_back(CreateMeasurement("gma", "lte::dl::owd", id, id + 3));
+            json wifiStats;
+            wifiStats.push_back(CreateMeasurement("wifi", "dl::max_rate", id, 80.0));
+            measurementBatch.push_back(gmaStats);
+            measurementBatch.push_back(wifiStats);
+        }
+        // per cell measurement with multiple ids in a single entry, e.g., the slice measurement.
+        json cellStats;
+        json cellMeasurement = CreateMeasurement("lte", "dl::rb_usage", 2, json{{"slice", {0, 1}}, {"value", {0.4, 0.6}}});
+        cellMeasurement["id"].push_back(1);
+        cellMeasurement["value"].push_back(json{{"slice", {0, 1}}, {"value", {0.2, 0.1}}});
+        cellStats.push_back(cellMeasurement);
+        measurementBatch.push_back(cellStats);
+
+        json expected = LegacyMerge(measurementBatch);
+        MeasurementAggregator aggregator;
+        for (auto& measurement : measurementBatch)
+        {
+            aggregator.Add(measurement);
+        }
+        json networkStats = aggregator.Flush();
+        NS_TEST_ASSERT_MSG_EQ(networkStats, expected, "aggregated measurements do not match the legacy merge");
+        NS_TEST_ASSERT_MSG_EQ(aggregator.IsEmpty(), true, "aggregator should be empty after flush");
+    }
+}
+
+/**
+ * \ingroup networkgym-tests
+ * The ReportWriter must write the rows of each file in order, across buffer flushes and when
+ * the files are closed, and append to the existing content of a file.
+ */
+class NetworkgymReportWriterTestCase : public TestCase
+{
+  public:
+    NetworkgymReportWriterTestCase();
+    virtual ~NetworkgymReportWriterTestCase();
+
+  private:
+    void DoRun() override;
+};
+
+NetworkgymReportWriterTestCase::NetworkgymReportWriterTestCase()
+    : TestCase("Networkgym buffered report writer")
+{
+}
+
+NetworkgymReportWriterTestCase::~NetworkgymReportWriterTestCase()
+{
+}
+
+void
+NetworkgymReportWriterTestCase::DoRun()
+{
+    std::string csvFile = CreateTempDirFilename("report.csv");
+    std::string logFile = CreateTempDirFilename("report.txt");
+    std::ofstream(csvFile) << "time,\tvalue\n";
+    const uint32_t rows = 20000; // more than one buffer.
+    for (uint32_t row = 0; row < rows; row++)
+    {
+        ReportWriter::GetStream(csvFile) << row << ",\t" << row * 2 << "\n";
+        if (row % 1000 == 0)
+        {
+            ReportWriter::GetStream(logFile) << row << std::endl;
+        }
+    }
+    ReportWriter::CloseAll();
+
+    std::ifstream csv(csvFile);
+    std::string line;
+    std::getline(csv, line);
+    NS_TEST_ASSERT_MSG_EQ(line, "time,\tvalue", "the existing content is kept");
+    uint32_t row = 0;
+    while (std::getline(csv, line))
+    {
+        NS_TEST_ASSERT_MSG_EQ(line, std::to_string(row) + ",\t" + std::to_string(row * 2), "rows are written in order");
+        row++;
+    }
+    NS_TEST_ASSERT_MSG_EQ(row, rows, "every row is written");
+
+    std::ifstream log(logFile);
+    uint32_t logRows = 0;
+    while (std::getline(log, line))
+    {
+        logRows++;
+    }
+    NS_TEST_ASSERT_MSG_EQ(logRows, rows / 1000, "every log row is written");
+}
+
+/**
+ * \ingroup networkgym-tests
+ * In pipelined mode (action_lag_steps > 0), the action of a measurement must be applied action_lag_steps
+ * measurements later, even if the agent sent the actions of several measurements ahead of time. A zmq
+ * router plays the agent and queues the actions of 4 measurements after it receives the first one.
+ */
+class NetworkgymPipelinedActionTestCase : public TestCase
+{
+  public:
+    NetworkgymPipelinedActionTestCase();
+    virtual ~NetworkgymPipelinedActionTestCase();
+
+  private:
+    void DoRun() override;
+    void SendMeasurement(uint64_t value);
+    void SendActions();
+    void ActionReceived(const json& value);
+
+    Ptr<DataProcessor> m_dataProcessor;
+    void* m_agentSocket = nullptr;
+    std::vector<std::pair<int64_t, uint64_t>> m_actionList; // (time ms, action value) of the applied actions.
+};
+
+NetworkgymPipelinedActionTestCase::NetworkgymPipelinedActionTestCase()
+    : TestCase("Networkgym pipelined actions are applied in order")
+{
+}
+
+NetworkgymPipelinedActionTestCase::~NetworkgymPipelinedActionTestCase()
+{
+}
+
+void
+NetworkgymPipelinedActionTestCase::SendMeasurement(uint64_t value)
+{
+    Ptr<NetworkStats> measurement = m_dataProcessor->CreateNetworkStats("test", 0, Now().GetMilliSeconds());
+    measurement->Append("value", (double)value);
+    m_dataProcessor->AppendMeasurement(measurement);
+}
+
+void
+NetworkgymPipelinedActionTestCase::SendActions()
+{
+    // wait for the first measurement, the router only routes to a connected env.
+    std::string identity;
+    int more = 1;
+    while (more)
+    {
+        zmq_msg_t msg;
+        zmq_msg_init(&msg);
+        zmq_msg_recv(&msg, m_agentSocket, 0);
+        if (identity.empty())
+        {
+            identity.assign(static_cast<const char*>(zmq_msg_data(&msg)), zmq_msg_size(&msg));
+        }
+        more = zmq_msg_more(&msg);
+        zmq_msg_close(&msg);
+    }
+    NS_TEST_ASSERT_MSG_EQ(identity, "test-env", "measurement from the env");
+
+    // the action value is the ts of its measurement.
+    for (uint64_t tsMs = 100; tsMs <= 400; tsMs += 100)
+    {
+        json element;
+        element["source"] = "test";
+        element["name"] = "value";
+        element["ts"] = tsMs;
+        element["id"] = 0;
+        element["value"] = tsMs;
+        json action;
+        action["type"] = "env-action";
+        action["action_list"] = json::array();
+        action["action_list"].push_back(element);
+        std::string actionStr = action.dump();
+        zmq_send(m_agentSocket, identity.c_str(), identity.size(), ZMQ_SNDMORE);
+        zmq_send(m_agentSocket, "test-client", 11, ZMQ_SNDMORE);
+        zmq_send(m_agentSocket, actionStr.c_str(), actionStr.size(), 0);
+    }
+}
+
+void
+NetworkgymPipelinedActionTestCase::ActionReceived(const json& value)
+{
+    m_actionList.emplace_back(Now().GetMilliSeconds(), value.get<uint64_t>());
+}
+
+void
+NetworkgymPipelinedActionTestCase::DoRun()
+{
+    std::string envConfigFile = CreateTempDirFilename("env-configure.json");
+    std::string folder = envConfigFile.substr(0, envConfigFile.rfind('/'));
+    json envConfig;
+    envConfig["steps_per_episode"] = 6;
+    envConfig["episodes_per_session"] = 1;
+    envConfig["action_lag_steps"] = 2;
+    envConfig["subscribed_network_stats"] = json::array();
+    envConfig["subscribed_network_stats"].push_back("test::value");
+    std::ofstream(envConfigFile) << envConfig.dump();
+    json gymConfig;
+    gymConfig["env_identity"] = "test-env";
+    gymConfig["client_identity"] = "test-client";
+    gymConfig["session_name"] = "test";
+    gymConfig["session_key"] = "test";
+    gymConfig["env_port"] = 0;
+
+    void* context = zmq_ctx_new();
+    m_agentSocket = zmq_socket(context, ZMQ_ROUTER);
+    int linger = 0;
+    zmq_setsockopt(m_agentSocket, ZMQ_LINGER, &linger, sizeof(linger));
+    NS_TEST_ASSERT_MSG_EQ(zmq_bind(m_agentSocket, "tcp://127.0.0.1:*"), 0, "bind the agent socket");
+    char endpoint[256];
+    size_t endpointSize = sizeof(endpoint);
+    zmq_getsockopt(m_agentSocket, ZMQ_LAST_ENDPOINT, endpoint, &endpointSize);
+    gymConfig["env_endpoint"] = std::string(endpoint);
+    std::ofstream(folder + "/gym-configure.json") << gymConfig.dump();
+
+    // the data processor reads the configure files in the current folder.
+    char cwd[4096];
+    NS_TEST_ASSERT_MSG_EQ(getcwd(cwd, sizeof(cwd)) != nullptr, true, "current folder");
+    NS_TEST_ASSERT_MSG_EQ(chdir(folder.c_str()), 0, "enter the env folder");
+    m_dataProcessor = CreateObject<DataProcessor>();
+    m_dataProcessor->SetMaxPollTime(10000);
+    m_dataProcessor->SetNetworkGymActionCallback(
+        "test::value",
+        0,
+        MakeCallback(&NetworkgymPipelinedActionTestCase::ActionReceived, this));
+    m_dataProcessor->StartMeasurement();
+    for (uint64_t step = 1; step <= 6; step++)
+    {
+        Simulator::Schedule(MilliSeconds(100 * step), &NetworkgymPipelinedActionTestCase::SendMeasurement, this, step);
+    }
+    // the agent answers the first 4 measurements right after the first one, ahead of the env.
+    Simulator::Schedule(MilliSeconds(150), &NetworkgymPipelinedActionTestCase::SendActions, this);
+    Simulator::Run();
+    Simulator::Destroy();
+    m_dataProcessor->Dispose();
+    m_dataProcessor = nullptr;
+    NS_TEST_ASSERT_MSG_EQ(chdir(cwd), 0, "leave the env folder");
+    zmq_close(m_agentSocket);
+    zmq_ctx_destroy(context);
+
+    // the action of the measurement at ts is applied 2 measurements later. The 6th measurement ends the
+    // episode, the queued action of the 4th one is not applied.
+    NS_TEST_ASSERT_MSG_EQ(m_actionList.size(), 3u, "one action per step after the lag");
+    for (uint32_t ind = 0; ind < m_actionList.size(); ind++)
+    {
+        NS_TEST_ASSERT_MSG_EQ(m_actionList[ind].second, 100 * (ind + 1), "the actions are applied in order");
+        NS_TEST_ASSERT_MSG_EQ(m_actionList[ind].first, (int64_t)(100 * (ind + 3)), "the action is applied 2 steps later");
+    }
+}
+
 // The TestSuite class names the TestSuite, identifies what type of TestSuite,
 // and enables the TestCases to be run.  Typically, only the constructor for
 // this class must be defined
@@ -80,6 +555,10 @@ NetworkgymTestSuite::NetworkgymTestSuite()
 {
     // TestDuration for TestCase can be QUICK, EXTENSIVE or TAKES_FOREVER
     AddTestCase(new NetworkgymTestCase1, TestCase::QUICK);
+    AddTestCase(new NetworkgymMeasurementEncodingTestCase, TestCase::QUICK);
+    AddTestCase(new NetworkgymMeasurementAggregatorTestCase, TestCase::QUICK);
+    AddTestCase(new NetworkgymReportWriterTestCase, TestCase::QUICK);
+    AddTestCase(new NetworkgymPipelinedActionTestCase, TestCase::QUICK);
 }
 
 // Do not forget to allocate an instance of this TestSuite
@@ -8,6 +8,7 @@ import time
 import pathlib
 from subprocess import Popen, PIPE, CalledProcessError
 import json
+import threading
 
 FILE_PATH = pathlib.Path(__file__).parent
 
@@ -18,8 +19,8 @@ def build_ns3(config = True, build= True):
     if build:
         os.system('./ns3 build')
 
-def NetworkGymSim(env_identity, config_json, client_identity, msg_json):
-
+def prepare_env_folder(env_identity, config_json, client_identity, msg_json):
+    """Create the env folder with the gym-configure.json and env-configure.json, return the folder name."""
     output_folder = env_identity
     os.chdir(str(FILE_PATH))
     os.system('rm -r '+output_folder)
@@ -36,6 +37,11 @@ def NetworkGymSim(env_identity, config_json, client_identity, msg_json):
  
     with open(output_folder+"/env-configure.json", "w") as outfile:
         outfile.write(msg_json_object)
+    return output_folder
+
+def NetworkGymSim(env_identity, config_json, client_identity, msg_json):
+
+    output_folder = prepare_env_folder(env_identity, config_json, client_identity, msg_json)
 
     ns3_command = './ns3 run scratch/unified-network-slicing.cc --cwd='+output_folder
     print(ns3_command)
@@ -48,3 +54,80 @@ def NetworkGymSim(env_identity, config_json, client_identity, msg_json):
             print("[ns3 stopped] %d %s %s" % (p.returncode, output, error))
             if error:
                 raise Exception("[ns3 crashed] %d %s %s" % (p.returncode, output, error))
+
+class NetworkGymSimBatch:
+    """Run many ns-3 envs in one ns-3 batch worker process.
+
+    The batch worker ('--batchWorker=1') is started once, and forks an isolated child process per env,
+    such that the ns-3 startup is not paid per session. Use it in place of NetworkGymSim, e.g.,
+    Configure(worker, sim_batch, env_list, env_endpoint) for every worker, where all workers share one NetworkGymSimBatch.
+    """
+    END_PREFIX = "[batch-worker] env-end "
+    # env configs that are reloaded per session, sessions that only differ in these configs are forked from the same warm start snapshot.
+    # the random_seed reseeds the random variables of the forked session, the user start locations are from the snapshot.
+    SESSION_CONFIGS = ["steps_per_episode", "episodes_per_session", "subscribed_network_stats", "action_lag_steps", "max_wait_time_for_action_ms", "random_seed"]
+
+    def __init__(self, warm_start=False):
+        """
+        Args:
+            warm_start (bool): if True, the scenario is built and warmed up once per env config, and every session is forked from this snapshot.
+        """
+        self.lock = threading.Lock()
+        self.warm_start = warm_start
+        self.snapshot_folders = {} # scenario config -> snapshot folder
+        self.env_end_events = {} # env folder -> event set when the env ends
+        self.env_exit_codes = {} # env folder -> exit code of the env
+        ns3_command = './ns3 run "scratch/unified-network-slicing.cc --batchWorker=1"'
+        print(ns3_command)
+        self.process = Popen(ns3_command, shell=True, stdin=PIPE, stdout=PIPE, cwd=str(FILE_PATH), bufsize=1, universal_newlines=True)
+        self.reader = threading.Thread(target=self.read_output, daemon=True)
+        self.reader.start()
+
+    def read_output(self):
+        for line in self.process.stdout:
+            if line.startswith(self.END_PREFIX):
+                folder, exit_code = line[len(self.END_PREFIX):].rsplit(' ', 1)
+                with self.lock:
+                    self.env_exit_codes[folder] = int(exit_code)
+                    event = self.env_end_events.pop(folder, None)
+                if event:
+                    event.set()
+            else:
+                print(line, end='')
+        # the batch worker stopped, release all running envs.
+        with self.lock:
+            for folder, event in self.env_end_events.items():
+                self.env_exit_codes[folder] = -1
+                event.set()
+            self.env_end_events.clear()
+
+    def get_snapshot_folder(self, config_json, msg_json):
+        """Return the snapshot folder for the scenario of msg_json, the folder is created for a new scenario."""
+        scenario = {key: value for key, value in msg_json.items() if key not in self.SESSION_CONFIGS}
+        scenario_key = json.dumps(scenario, sort_keys=True)
+        with self.lock:
+            if scenario_key not in self.snapshot_folders:
+                snapshot_identity = "snapshot-%d" % len(self.snapshot_folders)
+                prepare_env_folder(snapshot_identity, dict(config_json), "", msg_json)
+                self.snapshot_folders[scenario_key] = str(FILE_PATH / snapshot_identity)
+            return self.snapshot_folders[scenario_key]
+
+    def __call__(self, env_identity, config_json, client_identity, msg_json):
+        output_folder = prepare_env_folder(env_identity, config_json, client_identity, msg_json)
+        folder = str(FILE_PATH / output_folder)
+        request = folder
+        if self.warm_start:
+            # "<folder>\t<snapshot folder>" forks the env from the warmed-up snapshot.
+            request = folder + "\t" + self.get_snapshot_folder(config_json, msg_json)
+        event = threading.Event()
+        with self.lock:
+            if self.process.poll() is not None:
+                raise Exception("[ns3 crashed] batch worker stopped with %d" % self.process.returncode)
+            self.env_end_events[folder] = event
+            self.process.stdin.write(request + "\n")
+            self.process.stdin.flush()
+        event.wait()
+        with self.lock:
+            exit_code = self.env_exit_codes.pop(folder)
+        if exit_code != 0:
+            raise Exception("[ns3 crashed] env %s stopped with %d" % (env_identity, exit_code))
@@ -0,0 +1,72 @@
+/* Copyright(C) 2024 Intel Corporation
+*  SPDX-License-Identifier: GPL-2.0
+*  https://spdx.org/licenses/GPL-2.0.html
+*  File : gma-decision-replay.cc
+*/
+
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+
+//replay a gma decision trace (GmaVirtualInterface::DecisionTraceFile) against a GmaRxControl configuration, without
+//running the simulation. The GmaRxControl attributes can be changed from the command line, e.g.,
+//./ns3 run "gma-decision-replay --trace=decision-node-0-interface-0.bin --algorithm=gma --ns3::GmaRxControl::EnableAdaptiveStep=false"
+//The number of decisions that differ from the recorded ones is 0 if the configuration is the same as the recorded one.
+
+#include <iostream>
+#include "ns3/core-module.h"
+#include "ns3/gma-decision-trace.h"
+
+using namespace ns3;
+
+int
+main (int argc, char *argv[])
+{
+  std::string traceFile;
+  std::string algorithm = "gma";
+  uint32_t splittingBurst = 0;
+  uint32_t repeat = 1;
+
+  CommandLine cmd;
+  cmd.AddValue ("trace", "decision trace file", traceFile);
+  cmd.AddValue ("algorithm", "rx splitting algorithm, the name of a registered policy", algorithm);
+  cmd.AddValue ("splittingBurst", "splitting burst, 0 uses the recorded splitting burst. With another splitting burst, the recorded split is not restored before each decision", splittingBurst);
+  cmd.AddValue ("repeat", "number of replays, each replay starts from a new rx control", repeat);
+  cmd.Parse (argc, argv);
+
+  if (traceFile.empty ())
+  {
+    NS_FATAL_ERROR ("no decision trace file, use --trace=<file>");
+  }
+  std::vector<GmaDecisionTrace::Entry> entryList = GmaDecisionTrace::Read (traceFile);
+  if (entryList.empty ())
+  {
+    NS_FATAL_ERROR ("no record in " << traceFile);
+  }
+  if (splittingBurst == 0)
+  {
+    splittingBurst = entryList.front ().m_splittingBurst;
+  }
+  bool restoreSplit = splittingBurst == entryList.front ().m_splittingBurst;
+
+  GmaDecisionTrace::ReplayResult total;
+  for (uint32_t i = 0; i < repeat; i++)
+  {
+    Ptr<GmaRxControl> rxControl = CreateObject<GmaRxControl> ();
+    rxControl->SetLinkState (GmaDecisionTrace::CreateLinkState (entryList));
+    rxControl->SetSplittingBurst (splittingBurst);
+    rxControl->SetAlgorithm (algorithm);
+    GmaDecisionTrace::ReplayResult result = GmaDecisionTrace::Replay (entryList, rxControl, restoreSplit);
+    total.m_decisions += result.m_decisions;
+    total.m_updates += result.m_updates;
+    total.m_mismatches += result.m_mismatches;
+    total.m_seconds += result.m_seconds;
+  }
+
+  std::cout << "records: " << entryList.size ()
+            << " simulated time: " << (entryList.back ().m_time - entryList.front ().m_time).GetSeconds () << " s"
+            << " links: " << +entryList.front ().m_measurement->m_links << std::endl;
+  std::cout << "decisions: " << total.m_decisions
+            << " updates: " << total.m_updates
+            << " mismatches: " << total.m_mismatches
+            << " decisions/s: " << total.m_decisions / total.m_seconds << std::endl;
+  return 0;
+}
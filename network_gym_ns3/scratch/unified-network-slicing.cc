@@ -25,6 +25,13 @@
 #include <fstream>
 #include <string>
 #include <cassert>
+#include <map>
+#include <set>
+#include <functional>
+#include <csignal>
+#include <poll.h>
+#include <sys/wait.h>
+#include <unistd.h>
 
 #include "ns3/core-module.h"
 #include "ns3/network-module.h"
@@ -153,6 +160,10 @@ public:
   void ConnectTraceCallbacks ();
   void StoreMacAddress ();
   void Run ();
+  void Build (); //build the scenario from the env-configure.json.
+  void WarmUp (); //run the simulation until the measurement starts.
+  void StartEpisode (); //continue a warmed-up scenario with the env-configure.json in the current folder.
+  int64_t AssignStreams (int64_t stream); //reassign the streams of the random variables with the current run, e.g., after RngSeedManager::SetRun.
   void TrafficSplittingDeployment ();
   void QoSTrafficSteeringDeployment ();
 private:
@@ -345,16 +356,13 @@ GmaSimWorker::UpdateStatus(){
     //stop the simulatio right now!!
     std::ostringstream fileName;
     fileName <<"status.txt";
-    std::ofstream myfile;
-    myfile.open (fileName.str ().c_str (), std::ios::out | std::ios::app);
+    std::ostream& myfile = ReportWriter::GetStream (fileName.str ());
     //time_t seconds;
 
     //seconds = time (NULL);
     //myfile << (int)seconds << "/"<< m_stopTime.GetSeconds() << "/" <<m_stopTime.GetSeconds() <<std::endl;
     myfile << m_stopTime.GetSeconds() << "/" <<m_stopTime.GetSeconds() <<std::endl;
 
-    myfile.close();
-
     NS_FATAL_ERROR("find the stop file");
 
   }
@@ -362,15 +370,13 @@ GmaSimWorker::UpdateStatus(){
   {
     std::ostringstream fileName;
     fileName <<"status.txt";
-    std::ofstream myfile;
-    myfile.open (fileName.str ().c_str (), std::ios::out | std::ios::app);
+    std::ostream& myfile = ReportWriter::GetStream (fileName.str ());
     //time_t seconds;
 
     //seconds = time (NULL);
 
     //myfile << (int)seconds << "/"<< Simulator::Now ().GetSeconds () << "/" <<m_stopTime.GetSeconds() <<std::endl;
-    myfile << Simulator::Now ().GetSeconds () << "/" <<m_stopTime.GetSeconds() <<std::endl;
-    myfile.close();
+    myfile << Simulator::Now ().GetSeconds () << "/" <<m_stopTime.GetSeconds() <<std::endl;//flushed, the status file shows the progress.
   }
 
     
@@ -383,10 +389,9 @@ GmaSimWorker::LogLocations ()
       //log file
     std::ostringstream fileName;
     fileName <<"config.txt";
-    std::ofstream myfile;
-    myfile.open (fileName.str ().c_str (), std::ios::out | std::ios::app);
     if(Simulator::Now ().GetSeconds () < 0.1)
     {
+        std::ostream& myfile = ReportWriter::GetStream (fileName.str ());
         myfile << "4G LTE EnB locations: ";
         for (uint32_t apInd = 0; apInd < m_eNodeBs.GetN(); apInd++)
         {
@@ -439,7 +444,6 @@ GmaSimWorker::LogLocations ()
 
     }*/
 
-    myfile.close();
     UpdateStatus();
     Simulator::Schedule (Seconds(1.0), &GmaSimWorker::LogLocations, this);
 
@@ -484,7 +488,7 @@ GmaSimWorker::WifiRateCallback(std::string path, DataRate rate, Mac48Address des
       if (AssignedCellId == cellId)//for handover, only update the measurement from the asigned AP (by GMA algorithm).
       {
         Time nowTime = Now();
-        ns3::Ptr<ns3::NetworkStats> element = ns3::CreateObject<ns3::NetworkStats>("wifi", userId, nowTime.GetMilliSeconds());
+        ns3::Ptr<ns3::NetworkStats> element = m_gmaDataProcessor->CreateNetworkStats("wifi", userId, nowTime.GetMilliSeconds());
         element->Append("dl::max_rate", (double)rate.GetBitRate()/1e6);
         m_gmaDataProcessor->AppendMeasurement(element);
       }
@@ -530,7 +534,7 @@ GmaSimWorker::WifiRateCallback(std::string path, DataRate rate, Mac48Address des
       if (AssignedCellId == cellId)//for handover, only update the measurement from the asigned AP (by GMA algorithm).
       {
         Time nowTime = Now();
-        ns3::Ptr<ns3::NetworkStats> element = ns3::CreateObject<ns3::NetworkStats>("wifi", imsi, nowTime.GetMilliSeconds());
+        ns3::Ptr<ns3::NetworkStats> element = m_gmaDataProcessor->CreateNetworkStats("wifi", imsi, nowTime.GetMilliSeconds());
         //element->Append("max_rate::ul", "slice", std::vector<double>{(double)rate.GetBitRate()/1e6, 123});
         element->Append("ul::max_rate", (double)rate.GetBitRate()/1e6);
         m_gmaDataProcessor->AppendMeasurement(element);
@@ -583,7 +587,7 @@ GmaSimWorker::LteEnbMeasurementCallback(std::string path, std::vector<int> slice
     NS_FATAL_ERROR("Cannot find the nodeId or deviceId or cellId");
   }
   Time nowTime = Now();
-  ns3::Ptr<ns3::NetworkStats> element = ns3::CreateObject<ns3::NetworkStats>("lte", cellId, nowTime.GetMilliSeconds());
+  ns3::Ptr<ns3::NetworkStats> element = m_gmaDataProcessor->CreateNetworkStats("lte", cellId, nowTime.GetMilliSeconds());
 
   if (dl)
   {
@@ -602,7 +606,7 @@ GmaSimWorker::LteUeMeasurementCallback(std::string path, int sliceId, double rat
 {
   //std::cout << Simulator::Now().GetSeconds() << " "<< path << " rate:" << rate << " sliceId:" << sliceId << " rbUsage:" << rbUsage << " imsi:" << imsi << " dl:" << dl<< std::endl;
   Time nowTime = Now();
-  ns3::Ptr<ns3::NetworkStats> element = ns3::CreateObject<ns3::NetworkStats>("lte", imsi, nowTime.GetMilliSeconds());
+  ns3::Ptr<ns3::NetworkStats> element = m_gmaDataProcessor->CreateNetworkStats("lte", imsi, nowTime.GetMilliSeconds());
 
   int nodeId = -1;
 
@@ -650,7 +654,7 @@ GmaSimWorker::LteUeMeasurementCallback(std::string path, int sliceId, double rat
   {
     //create a measurement for NR ue here. move the NR measurement in the future.
     //NR not support handover yet.
-    ns3::Ptr<ns3::NetworkStats> elementNr = ns3::CreateObject<ns3::NetworkStats>("nr", imsi, nowTime.GetMilliSeconds());
+    ns3::Ptr<ns3::NetworkStats> elementNr = m_gmaDataProcessor->CreateNetworkStats("nr", imsi, nowTime.GetMilliSeconds());
     elementNr->Append("cell_id", m_gmaDataProcessor->GetCellId(imsi, CELLULAR_NR_CID)/m_nr_bwp_num); //divide the number of bandwith part...
     m_gmaDataProcessor->AppendMeasurement(elementNr);
   }
@@ -962,6 +966,11 @@ GmaSimWorker::ParseJsonConfig ()
 
   Config::SetDefault ("ns3::GmaVirtualInterface::MeasurementInterval", TimeValue (gma_interval));
   Config::SetDefault ("ns3::GmaVirtualInterface::MeasurementGuardInterval", TimeValue (gma_guard));
+  if (jsonConfig["gma"].contains("packet_trace_file"))
+  {
+    //optional per packet binary trace, decoded by contrib/gma/utils/gma-trace-decode.py
+    Config::SetDefault ("ns3::GmaVirtualInterface::PacketTraceFile", StringValue (jsonConfig["gma"]["packet_trace_file"].get<std::string>()));
+  }
 
   Config::SetDefault (m_apManager+"::MeasurementInterval", TimeValue (m_wifiMeasurementInterval));
   Config::SetDefault (m_apManager+"::MeasurementGuardInterval", TimeValue (wifi_guard));
@@ -975,8 +984,7 @@ GmaSimWorker::SaveConfigFile()
 {
   std::ostringstream fileName;
   fileName <<"config.txt";
-  std::ofstream myfile;
-  myfile.open (fileName.str ().c_str (), std::ios::out | std::ios::app);
+  std::ostream& myfile = ReportWriter::GetStream (fileName.str ());
 
   if(m_radioType == WIFI_CID)
   {
@@ -1179,7 +1187,6 @@ GmaSimWorker::SaveConfigFile()
   myfile << "Wi-Fi Queue MaxDelay:" << wifiDelay << " ms" << ", Queue MaxSize:" << wifiQueueSize << " packets" << std::endl;
   myfile << "LTE UM mode, buffer size: 1MB, t-reordering: 10 ms" << std::endl;
 
-  myfile.close();
 
 }
 
@@ -1362,8 +1369,7 @@ GmaSimWorker::InstallNetworks()
 
   std::ostringstream fileName;
   fileName <<"config.txt";
-  std::ofstream myfile;
-  myfile.open (fileName.str ().c_str (), std::ios::out | std::ios::app);
+  std::ostream& myfile = ReportWriter::GetStream (fileName.str ());
   myfile << "AP Band Num: ";
 
   for (int apInd = 0; apInd < m_numOfAps; apInd++)
@@ -1429,7 +1435,6 @@ GmaSimWorker::InstallNetworks()
     }
   }
   myfile<<std::endl;
-  myfile.close();
 
 
   //5. LTE network
@@ -1945,8 +1950,7 @@ GmaSimWorker::InstallApplications()
 
   std::ostringstream fileName;
   fileName <<"config.txt";
-  std::ofstream myfile;
-  myfile.open (fileName.str ().c_str (), std::ios::out | std::ios::app);
+  std::ostream& myfile = ReportWriter::GetStream (fileName.str ());
 
   ApplicationContainer sendApps;
   ApplicationContainer sinkApps;
@@ -2116,7 +2120,6 @@ GmaSimWorker::InstallApplications()
   sendApps.Stop (m_stopTime);
   sinkApps.Start (Seconds (0.0));
   sinkApps.Stop (m_stopTime);
-  myfile.close();
 }
 
 void
@@ -2168,16 +2171,15 @@ GmaSimWorker::Run()
   //phy.EnableAsciiAll (ascii.CreateFileStream ("gma-wifi.tr"));
   //phy.EnablePcapAll ("gma-wifi");
 
-  Simulator::Stop (m_stopTime+MicroSeconds(2)); //for sending the last measurement.
+  Simulator::Stop (m_stopTime+MicroSeconds(2)-Simulator::Now ()); //for sending the last measurement.
   Simulator::Run ();
   Simulator::Destroy ();
   std::cout << "Simulation end at " << m_stopTime.GetSeconds() << "s" << std::endl;
 }
 
 void
-GmaSimWorker::TrafficSplittingDeployment ()
+GmaSimWorker::Build ()
 {
-
   ParseJsonConfig();
 
   SaveConfigFile();
@@ -2193,9 +2195,79 @@ GmaSimWorker::TrafficSplittingDeployment ()
   ConnectTraceCallbacks();
 
   StoreMacAddress();
-  
+}
+
+void
+GmaSimWorker::WarmUp ()
+{
+  //the measurement starts at m_measurement_start_time_ms+1, stop right before it. No msg is exchanged with the server yet.
+  Simulator::Stop (MilliSeconds(m_measurement_start_time_ms));
+  Simulator::Run ();
+  std::cout << "Warm up end at " << Simulator::Now ().GetSeconds() << "s" << std::endl;
+}
+
+void
+GmaSimWorker::StartEpisode ()
+{
+  //only the per session configs and the random_seed are reloaded, the scenario (including the user start locations) is the same as the snapshot.
+  std::ifstream jsonStream("env-configure.json");
+  json jsonConfig;
+  jsonStream >> jsonConfig;
+  //the random variables keep their state from the snapshot, reseed them or every episode forked from the snapshot replays the same randomness.
+  int random_seed = jsonConfig["random_seed"].get<int>();
+  RngSeedManager::SetRun(random_seed);
+  AssignStreams(1);
+  m_action_wait_ms = jsonConfig["max_wait_time_for_action_ms"].get<int>();
+  if(m_action_wait_ms < 0 || m_action_wait_ms > 600000)
+  {
+    m_action_wait_ms = 600000;
+  }
+  m_gmaDataProcessor->LoadEnvConfig();
+  m_gmaDataProcessor->SetMaxPollTime(m_action_wait_ms);
+
   Run();
+}
+
+int64_t
+GmaSimWorker::AssignStreams (int64_t stream)
+{
+  int64_t currentStream = stream;
+  m_uniformRv->SetStream(currentStream++);
+
+  NodeContainer allNodes = NodeContainer::GetGlobal();
+  NetDeviceContainer allDevices;
+  for (auto it = allNodes.Begin(); it != allNodes.End(); ++it)
+  {
+    for (uint32_t i = 0; i < (*it)->GetNDevices(); i++)
+    {
+      allDevices.Add((*it)->GetDevice(i));
+    }
+  }
+
+  MobilityHelper mobility;
+  currentStream += mobility.AssignStreams(allNodes, currentStream);
+  InternetStackHelper internet;
+  currentStream += internet.AssignStreams(allNodes, currentStream);
+  //the device helpers skip the devices of other types.
+  WifiHelper wifi;
+  currentStream += wifi.AssignStreams(allDevices, currentStream);
+  Ptr<LteHelper> lteHelper = CreateObject<LteHelper> ();
+  currentStream += lteHelper->AssignStreams(allDevices, currentStream);
+  if (m_nrHelper)
+  {
+    currentStream += m_nrHelper->AssignStreams(allDevices, currentStream);
+  }
+  PoissonUdpClientHelper poissonClient;
+  currentStream += poissonClient.AssignStreams(allNodes, currentStream);
+  return currentStream - stream;
+}
 
+void
+GmaSimWorker::TrafficSplittingDeployment ()
+{
+  Build();
+
+  Run();
 }
 
 void
@@ -2221,39 +2293,289 @@ GmaSimWorker::QoSTrafficSteeringDeployment()
   Run();
 }
 
-int 
-main (int argc, char *argv[])
+//read the env name from the env-configure.json in the current folder.
+static std::string
+GetEnvName ()
 {
+  std::ifstream jsonStream("env-configure.json");
+  json jsonConfig;
+  jsonStream >> jsonConfig;
+  std::string env_name = jsonConfig["env"].get<std::string>();
+  std::cout << "env = " << env_name <<  std::endl;
+  if(env_name.compare("nqos_split") != 0)
+  {
+    NS_FATAL_ERROR("["+env_name+"] use case not implemented in ns3 workers");
+  }
+  return env_name;
+}
 
-  // Allow the user to override any of the defaults and the above
-  // DefaultValue::Bind ()s at run-time, via command-line arguments
-  CommandLine cmd;
-  cmd.Parse (argc, argv);
-
+//run the env configured by the env-configure.json in the current folder.
+static void
+RunEnv ()
+{
   Ptr<GmaSimWorker> worker = CreateObject<GmaSimWorker>();
   try
   {
-    std::ifstream jsonStream("env-configure.json");
-    json jsonConfig;
-    jsonStream >> jsonConfig;
-    std::string env_name = jsonConfig["env"].get<std::string>();
-    std::cout << "env = " << env_name <<  std::endl;
+    GetEnvName();
+    worker->TrafficSplittingDeployment();
+  }
+  catch (const json::type_error& e)
+  {
+      // output exception information
+      std::cout << "message: " << e.what() << '\n'
+                << "exception id: " << e.id << std::endl;
+  }
+}
 
-    if(env_name.compare("nqos_split") == 0)
+//report the envs (child processes) that finished. The processes without a folder name are not reported, e.g., the snapshots.
+static void
+ReapEnvs (std::map<pid_t, std::string>& pidToFolderMap, bool wait)
+{
+  int status;
+  pid_t pid;
+  while (!pidToFolderMap.empty() && (pid = waitpid(-1, &status, wait ? 0 : WNOHANG)) > 0)
+  {
+    auto iter = pidToFolderMap.find(pid);
+    if (iter == pidToFolderMap.end())
     {
-      worker->TrafficSplittingDeployment();
+      continue;
     }
-    else
+    int exitCode = WIFEXITED(status) ? WEXITSTATUS(status) : 128 + WTERMSIG(status);
+    if (!iter->second.empty())
     {
-      NS_FATAL_ERROR("["+env_name+"] use case not implemented in ns3 workers");
+      std::cout << "[batch-worker] env-end " << iter->second << " " << exitCode << std::endl;
     }
+    pidToFolderMap.erase(iter);
   }
-  catch (const json::type_error& e)
+}
+
+//the request pipes of the snapshots, the forked children close them such that a snapshot ends when the batch worker closes its pipe.
+static std::set<int> g_snapshotRequestFdSet;
+
+static void
+CloseSnapshotRequestFds ()
+{
+  for (int fd : g_snapshotRequestFdSet)
   {
-      // output exception information
-      std::cout << "message: " << e.what() << '\n'
-                << "exception id: " << e.id << std::endl;
+    close(fd);
+  }
+  g_snapshotRequestFdSet.clear();
+}
+
+//fork a child process that runs the env in its own folder.
+static pid_t
+ForkEnv (const std::string& folder, std::function<void ()> runEnv)
+{
+  std::cout.flush();
+  ReportWriter::CloseAll(); //the child opens the report files in its own folder.
+  GmaPacketTrace::CloseAll(); //same for the gma traces.
+  GmaDecisionTrace::CloseAll();
+  pid_t pid = fork();
+  if (pid < 0)
+  {
+    NS_FATAL_ERROR("batch worker cannot fork the env: " << folder);
+  }
+  if (pid == 0)
+  {
+    CloseSnapshotRequestFds();
+    if (chdir(folder.c_str()) != 0)
+    {
+      std::cout << "batch worker cannot find the env folder: " << folder << std::endl;
+      _exit(1);
+    }
+    runEnv();
+    std::cout.flush();
+    _exit(0);
+  }
+  return pid;
+}
+
+//read lines from the input until it is closed, the finished envs are reported while waiting.
+static void
+ServeEnvs (int inputFd, std::map<pid_t, std::string>& pidToFolderMap, std::function<void (const std::string&)> handleLine)
+{
+  std::string lineBuffer;
+  char buffer[4096];
+  bool inputClosed = false;
+  while (!inputClosed)
+  {
+    struct pollfd inputPollFd = {inputFd, POLLIN, 0};
+    int rc = poll(&inputPollFd, 1, 100);
+    ReapEnvs(pidToFolderMap, false);
+    if (rc <= 0)
+    {
+      continue;
+    }
+    ssize_t size = read(inputFd, buffer, sizeof buffer);
+    if (size <= 0)
+    {
+      inputClosed = true;
+      continue;
+    }
+    lineBuffer.append(buffer, size);
+
+    size_t pos;
+    while ((pos = lineBuffer.find('\n')) != std::string::npos)
+    {
+      std::string line = lineBuffer.substr(0, pos);
+      lineBuffer.erase(0, pos + 1);
+      if (!line.empty())
+      {
+        handleLine(line);
+      }
+    }
+  }
+}
+
+//warm start snapshot: a process that built and warmed up the scenario of a template folder.
+//every episode is forked from the snapshot, so it starts right at the measurement start time.
+struct EnvSnapshot
+{
+  pid_t m_pid;
+  int m_requestFd; //the env folders to fork from the snapshot are written to this pipe, one per line.
+};
+
+//start a snapshot process for the template folder. Returns false if the scenario cannot be built.
+static bool
+StartSnapshot (const std::string& templateFolder, std::map<pid_t, std::string>& pidToFolderMap, EnvSnapshot& snapshot)
+{
+  int requestPipe[2];
+  int readyPipe[2];
+  if (pipe(requestPipe) != 0 || pipe(readyPipe) != 0)
+  {
+    NS_FATAL_ERROR("batch worker cannot create the pipes for snapshot: " << templateFolder);
+  }
+  std::cout.flush();
+  ReportWriter::CloseAll(); //the child opens the report files in its own folder.
+  GmaPacketTrace::CloseAll(); //same for the gma traces.
+  GmaDecisionTrace::CloseAll();
+  pid_t pid = fork();
+  if (pid < 0)
+  {
+    NS_FATAL_ERROR("batch worker cannot fork the snapshot: " << templateFolder);
+  }
+  if (pid == 0)
+  {
+    CloseSnapshotRequestFds();
+    close(requestPipe[1]);
+    close(readyPipe[0]);
+    if (chdir(templateFolder.c_str()) != 0)
+    {
+      std::cout << "batch worker cannot find the template folder: " << templateFolder << std::endl;
+      _exit(1);
+    }
+    Ptr<GmaSimWorker> worker = CreateObject<GmaSimWorker>();
+    GetEnvName();
+    worker->Build();
+    worker->WarmUp();
+    char ready = 1;
+    if (write(readyPipe[1], &ready, 1) != 1)
+    {
+      _exit(1);
+    }
+    close(readyPipe[1]);
+
+    std::map<pid_t, std::string> episodePidToFolderMap;
+    ServeEnvs(requestPipe[0], episodePidToFolderMap, [&episodePidToFolderMap, worker] (const std::string& folder) {
+      episodePidToFolderMap[ForkEnv(folder, [worker] () { worker->StartEpisode(); })] = folder;
+    });
+    //no more episodes, wait for the running ones.
+    ReapEnvs(episodePidToFolderMap, true);
+    std::cout.flush();
+    _exit(0);
+  }
+
+  close(requestPipe[0]);
+  close(readyPipe[1]);
+  pidToFolderMap[pid] = ""; //reaped by the batch worker, but not reported.
+  //wait until the snapshot is ready, the read returns 0 if the snapshot process ended.
+  char ready = 0;
+  ssize_t size = read(readyPipe[0], &ready, 1);
+  close(readyPipe[0]);
+  if (size != 1)
+  {
+    close(requestPipe[1]);
+    return false;
+  }
+  snapshot.m_pid = pid;
+  snapshot.m_requestFd = requestPipe[1];
+  g_snapshotRequestFdSet.insert(snapshot.m_requestFd);
+  return true;
+}
+
+//batch worker mode, one process hosts many envs. The env folders are read from stdin, one per line.
+//Each env runs in a child process forked from this worker, such that the ns-3 startup is paid once and
+//every env has its own simulator. The worker prints "[batch-worker] env-end <folder> <exit code>" when an env ends.
+//A "<folder>\t<template folder>" line starts a warm start env: the scenario of the template folder is built and warmed up
+//once in a snapshot process, and the env is forked from the snapshot with the per session configs of its own folder.
+static void
+RunBatchWorker ()
+{
+  signal(SIGPIPE, SIG_IGN); //an ended snapshot process should not stop the batch worker.
+  std::map<pid_t, std::string> pidToFolderMap;
+  std::map<std::string, EnvSnapshot> templateToSnapshotMap;
+  std::cout << "[batch-worker] ready" << std::endl;
+  ServeEnvs(STDIN_FILENO, pidToFolderMap, [&pidToFolderMap, &templateToSnapshotMap] (const std::string& line) {
+    size_t pos = line.find('\t');
+    if (pos == std::string::npos)
+    {
+      //cold start.
+      pidToFolderMap[ForkEnv(line, [] () { RunEnv(); })] = line;
+      return;
+    }
+
+    std::string folder = line.substr(0, pos);
+    std::string templateFolder = line.substr(pos + 1);
+    auto iter = templateToSnapshotMap.find(templateFolder);
+    if (iter != templateToSnapshotMap.end() && pidToFolderMap.find(iter->second.m_pid) == pidToFolderMap.end())
+    {
+      //the snapshot process ended, start a new one.
+      g_snapshotRequestFdSet.erase(iter->second.m_requestFd);
+      close(iter->second.m_requestFd);
+      templateToSnapshotMap.erase(iter);
+      iter = templateToSnapshotMap.end();
+    }
+    if (iter == templateToSnapshotMap.end())
+    {
+      EnvSnapshot snapshot;
+      if (!StartSnapshot(templateFolder, pidToFolderMap, snapshot))
+      {
+        std::cout << "[batch-worker] env-end " << folder << " 1" << std::endl;
+        return;
+      }
+      iter = templateToSnapshotMap.emplace(templateFolder, snapshot).first;
+    }
+    std::string request = folder + "\n";
+    if (write(iter->second.m_requestFd, request.c_str(), request.size()) != (ssize_t)request.size())
+    {
+      std::cout << "[batch-worker] env-end " << folder << " 1" << std::endl;
+    }
+  });
+  //closing the request pipes stops the snapshots after their episodes end.
+  CloseSnapshotRequestFds();
+  //no more envs, wait for the running ones.
+  ReapEnvs(pidToFolderMap, true);
+}
+
+int 
+main (int argc, char *argv[])
+{
+
+  // Allow the user to override any of the defaults and the above
+  // DefaultValue::Bind ()s at run-time, via command-line arguments
+  bool batchWorker = false;
+  CommandLine cmd;
+  cmd.AddValue ("batchWorker", "Host many envs in one process, the env folders are read from stdin", batchWorker);
+  cmd.Parse (argc, argv);
+
+  if (batchWorker)
+  {
+    RunBatchWorker();
+  }
+  else
+  {
+    RunEnv();
   }
 
   return 0;
-}
\ No newline at end of file
+}
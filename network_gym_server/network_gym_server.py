@@ -17,6 +17,9 @@ from rich.live import Live
 from rich.table import Table
 
 WORKER_TIMEOUT_S = 60
+# frame that marks a msg relayed by a southbound multiplexer, i.e., many env workers sharing one connection.
+# the multiplexer sends [MUX_FRAME, env identity, client identity, msg...].
+MUX_FRAME = b'env-mux'
 
 '''
 class influxdb_thread(threading.Thread):
@@ -73,6 +76,14 @@ class ServerTask(threading.Thread):
         self.client_to_worker_dict = {} # store the active client -> worker mapping.
         self.client_to_env_dict = {} # store the client -> env dict.
         self.busy_workers_last_ts_dict = {} # store the worker -> last env measurement ts
+        self.worker_to_mux_dict = {} # store the worker -> multiplexer address, for workers connected via a multiplexer.
+
+    def send_to_worker(self, backend, worker_addr, msg):
+        """Send a msg to an env worker. Workers behind a multiplexer are reached via the multiplexer connection."""
+        if worker_addr in self.worker_to_mux_dict:
+            backend.send_multipart([self.worker_to_mux_dict[worker_addr], MUX_FRAME, worker_addr] + msg)
+        else:
+            backend.send_multipart([worker_addr] + msg)
 
     def generate_table(self):
         table = Table()
@@ -157,11 +168,19 @@ class ServerTask(threading.Thread):
                 print("delete timeout worker:"+addr.decode())
                 del self.available_workers_env_list[addr]
                 del self.available_workers_last_ts_dict[addr]
+                self.worker_to_mux_dict.pop(addr, None)
 
             # Handle worker activity on backend
             if socks.get(backend) == zmq.POLLIN:
                 msg = backend.recv_multipart()
                 print("[backend] Rx:")
+                if len(msg) > 2 and msg[1] == MUX_FRAME:
+                    # relayed by a multiplexer, remove the multiplexer address, the rest is the same as a msg from a direct connection.
+                    self.worker_to_mux_dict[msg[2]] = msg[0]
+                    msg = msg[2:]
+                elif len(msg) > 0 and msg[0] in self.worker_to_mux_dict:
+                    # the worker connected directly again.
+                    del self.worker_to_mux_dict[msg[0]]
                 if len(msg) < 3:
                     print ("[Error] Ignore msg with wrong size:" + str(len(msg)))
                     print(msg)
@@ -252,7 +271,8 @@ class ServerTask(threading.Thread):
                 elif relay_json["type"] == "env-measurement":
                     #measurement from network gym simlulation
                     print("Relay Measurement from: " + str(address)+ " to Algorithm Client: " + str(identity))
-                    frontend.send_multipart([identity, reply])#relay measurement to the algorithm
+                    #binary encoded measurement (e.g., msgpack) is carried in an extra frame after the json header, relay all frames.
+                    frontend.send_multipart([identity] + msg[2:])#relay measurement to the algorithm
                     #influxdb = influxdb_thread(address.decode(), identity.decode(), relay_json, self.config_json["influxdb"])#save to influxdb in a new thread
                     #influxdb.start()
                     self.busy_workers_last_ts_dict[address] = current_time
@@ -302,8 +322,7 @@ class ServerTask(threading.Thread):
                         worker_addr = self.client_to_worker_dict[identity]
                         print("[Error] find mapping of client:" + identity.decode()+ " to worker: " + worker_addr.decode())
                         # relay to network gym simlulation worker anyway. the network gym simlulation worker will treat the env-start as unexpected msg and stop simulation...
-                        request = [worker_addr] + msg # add the worker's address for routing
-                        backend.send_multipart(request) #relay the request to assigned worker.
+                        self.send_to_worker(backend, worker_addr, msg) #relay the request to assigned worker.
 
                         frontend.send_multipart([identity, b'{"type":"env-error", "error_msg": "NetworkGym Client - Worker Mapping Exits (Client was force quited, e.g., ctrl+c!). Restart the client."}'])
                         del self.client_to_worker_dict[identity] 
@@ -329,8 +348,7 @@ class ServerTask(threading.Thread):
                                     self.client_to_worker_dict[identity]=worker_addr # add this client -> worker mapping to dict
                                     self.client_to_env_dict[identity] = env_name
                                     print("Assinged client:" + identity.decode()+ " to worker: " + worker_addr.decode())
-                                    request = [worker_addr] + msg # add the worker's address for routing
-                                    backend.send_multipart(request) #relay the request to assigned worker.
+                                    self.send_to_worker(backend, worker_addr, msg) #relay the request to assigned worker.
                                     found_worker = True
                                     break
                             
@@ -352,8 +370,7 @@ class ServerTask(threading.Thread):
                         # find a client->worker routing rule based on existing mapping dict, i.e., a simulation for that algorithm client is running
                         worker_addr = self.client_to_worker_dict[identity]
                         print("Relay msg, find mapping of client:" + identity.decode()+ " to worker: " + worker_addr.decode())
-                        request = [worker_addr] + msg # add the worker's address for routing
-                        backend.send_multipart(request) #relay the request to assigned worker.
+                        self.send_to_worker(backend, worker_addr, msg) #relay the request to assigned worker.
                     else:
                         print("[ERROR] Algorithm client to network gym simlulation worker mapping removed!")
                         #unkown message type
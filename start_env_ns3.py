@@ -3,16 +3,26 @@
 #File : start_ns_env.py
 
 from network_gym_env import Configure
+from network_gym_env import Multiplexer
 import time
 from network_gym_sim.network_gym_sim import build_ns3
 from network_gym_sim.network_gym_sim import NetworkGymSim
+from network_gym_sim.network_gym_sim import NetworkGymSimBatch
 def main():
     """main function"""
     build_ns3(config=True, build=True)
 
     num_workers= 1
+    batch_worker = False # if True, all workers share one ns-3 process and one server connection.
+    warm_start = False # if True (batch worker only), the sessions are forked from a built and warmed-up scenario.
+    sim = NetworkGymSim
+    env_endpoint = None
+    if batch_worker:
+        env_endpoint = "ipc:///tmp/networkgym-mux"
+        Multiplexer(env_endpoint).start()
+        sim = NetworkGymSimBatch(warm_start)
     for worker in range(num_workers):
-        customEnv = Configure(worker, NetworkGymSim, ['nqos_split'])
+        customEnv = Configure(worker, sim, ['nqos_split'], env_endpoint)
         customEnv.start()
         time.sleep(0.1)
 